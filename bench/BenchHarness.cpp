@@ -0,0 +1,176 @@
+// bench/BenchHarness.cpp
+// Registry, runner and main() of the host benchmarks
+
+#include "BenchHarness.h"
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+namespace {
+
+struct Benchmark {
+    const char* name;
+    BenchFunction function;
+};
+
+struct Result {
+    const char* name;
+    uint64_t iterations;  // Per sample
+    double minNs;         // Per operation
+    double medianNs;
+    double meanNs;
+};
+
+// Function-local so registration from other files' static initialisers is safe
+std::vector<Benchmark>& registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+double secondsFor(BenchFunction function, uint64_t iterations) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    function(iterations);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+Result measure(const Benchmark& benchmark, int repetitions, double minSampleSeconds) {
+    // Grow the iteration count until a sample is long enough; the
+    // calibration runs double as warm-up
+    uint64_t iterations = 1;
+    double seconds = secondsFor(benchmark.function, iterations);
+    while (seconds < minSampleSeconds) {
+        double scale = (seconds > 0) ? minSampleSeconds * 1.2 / seconds : 100;
+        scale = std::min(std::max(scale, 2.0), 100.0);
+        iterations = (uint64_t)(iterations * scale);
+        seconds = secondsFor(benchmark.function, iterations);
+    }
+
+    std::vector<double> samples;
+    for (int r = 0; r < repetitions; r++) {
+        samples.push_back(secondsFor(benchmark.function, iterations) * 1e9 / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    Result result;
+    result.name = benchmark.name;
+    result.iterations = iterations;
+    result.minNs = samples.front();
+    result.medianNs = samples[samples.size() / 2];
+    double sum = 0;
+    for (size_t i = 0; i < samples.size(); i++) {
+        sum += samples[i];
+    }
+    result.meanNs = sum / samples.size();
+    return result;
+}
+
+bool writeJson(const char* path, const std::vector<Result>& results, int repetitions, double minSampleSeconds) {
+    FILE* out = (strcmp(path, "-") == 0) ? stdout : fopen(path, "w");
+    if (!out) {
+        return false;
+    }
+
+    char date[32];
+    time_t now = time(nullptr);
+    struct tm utc;
+    gmtime_r(&now, &utc);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", &utc);
+#ifdef __OPTIMIZE__
+    const bool optimized = true;
+#else
+    const bool optimized = false;
+#endif
+
+    fprintf(out, "{\n  \"context\": {\n");
+    fprintf(out, "    \"date\": \"%s\",\n", date);
+    fprintf(out, "    \"compiler\": \"%s\",\n", __VERSION__);
+    fprintf(out, "    \"optimized\": %s,\n", optimized ? "true" : "false");
+    fprintf(out, "    \"repetitions\": %d,\n", repetitions);
+    fprintf(out, "    \"min_sample_ms\": %.0f\n", minSampleSeconds * 1000);
+    fprintf(out, "  },\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        fprintf(out, "    {\"name\": \"%s\", \"iterations\": %llu, \"time_unit\": \"ns\", "
+                     "\"min\": %.3f, \"median\": %.3f, \"mean\": %.3f}%s\n",
+                r.name, (unsigned long long)r.iterations, r.minNs, r.medianNs, r.meanNs,
+                (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    return out == stdout || fclose(out) == 0;
+}
+
+void usage() {
+    printf("usage: program [--filter TEXT] [--json FILE|-] [--repetitions N] [--min-time-ms N] [--list]\n");
+}
+
+}  // namespace
+
+BenchRegistration::BenchRegistration(const char* name, BenchFunction function) {
+    Benchmark benchmark;
+    benchmark.name = name;
+    benchmark.function = function;
+    registry().push_back(benchmark);
+}
+
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    const char* jsonPath = nullptr;
+    int repetitions = 5;
+    double minSampleSeconds = 0.02;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(argv[i], "--list") == 0) {
+            listOnly = true;
+        } else if (strcmp(argv[i], "--filter") == 0 && value) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && value) {
+            jsonPath = argv[++i];
+        } else if (strcmp(argv[i], "--repetitions") == 0 && value) {
+            repetitions = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--min-time-ms") == 0 && value) {
+            minSampleSeconds = std::max(1, atoi(argv[++i])) / 1000.0;
+        } else {
+            usage();
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    // Stable order whatever the link order of the files
+    std::vector<Benchmark> benchmarks = registry();
+    std::sort(benchmarks.begin(), benchmarks.end(), [](const Benchmark& a, const Benchmark& b) {
+        return strcmp(a.name, b.name) < 0;
+    });
+
+    // The table goes to stderr when the JSON goes to stdout
+    FILE* table = (jsonPath && strcmp(jsonPath, "-") == 0) ? stderr : stdout;
+    if (!listOnly) {
+        fprintf(table, "%-40s %12s %12s %12s\n", "benchmark", "median ns", "min ns", "iterations");
+    }
+    std::vector<Result> results;
+    for (size_t i = 0; i < benchmarks.size(); i++) {
+        if (filter && !strstr(benchmarks[i].name, filter)) {
+            continue;
+        }
+        if (listOnly) {
+            printf("%s\n", benchmarks[i].name);
+            continue;
+        }
+        Result result = measure(benchmarks[i], repetitions, minSampleSeconds);
+        fprintf(table, "%-40s %12.2f %12.2f %12llu\n", result.name, result.medianNs, result.minNs,
+                (unsigned long long)result.iterations);
+        fflush(table);
+        results.push_back(result);
+    }
+
+    if (jsonPath && !writeJson(jsonPath, results, repetitions, minSampleSeconds)) {
+        fprintf(stderr, "ERROR: cannot write %s\n", jsonPath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,44 @@
+// bench/BenchHarness.h
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <stdint.h>
+
+/**
+ * Minimal microbenchmark harness for the host bench build (make bench).
+ *
+ * A benchmark is a function that performs its operation `iterations`
+ * times. The harness grows the iteration count until one sample takes at
+ * least the minimum sample time, takes several samples and reports
+ * nanoseconds per operation (min, median, mean), as a table and
+ * optionally as JSON (--json FILE) for comparing runs with
+ * tools/compare_bench.py.
+ *
+ * Setup inside the function is timed too; keep it small next to the loop
+ * (constructing a scheduler and its mocks is well under a microsecond).
+ *
+ *   BENCH(scheduler, update_idle) {
+ *       ...setup...
+ *       for (uint64_t i = 0; i < iterations; i++) {
+ *           scheduler.update();
+ *       }
+ *   }
+ */
+typedef void (*BenchFunction)(uint64_t iterations);
+
+struct BenchRegistration {
+    BenchRegistration(const char* name, BenchFunction function);
+};
+
+#define BENCH(group, name)                                                                   \
+    static void bench_##group##_##name(uint64_t iterations);                                 \
+    static BenchRegistration registration_##group##_##name(#group "/" #name, bench_##group##_##name); \
+    static void bench_##group##_##name(uint64_t iterations)
+
+// Keep a value alive so the optimiser cannot drop the work producing it
+template <typename T>
+inline void benchKeep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif
@@ -0,0 +1,85 @@
+// bench/bench_command_registry.cpp
+// Command parser: table lookup + argument parsing per line, against the
+// strcmp chain it replaced
+
+#include <string.h>
+#include "BenchHarness.h"
+#include "CommandRegistry.h"
+
+class NullOutput : public ICommandOutput {
+public:
+    void println(const char* line) override { lines++; }
+    unsigned long lines = 0;
+};
+
+static unsigned long handled;
+
+static void cmdAny(const CommandArgs& args, ICommandOutput* out, void* context) {
+    handled += args.count + 1;
+}
+
+// Same shape as the firmware table, padded out to a realistic size
+static constexpr CommandSpec COMMANDS[] = {
+    { "BENCH",        "",   0, 0,      "",          "", cmdAny },
+    { "DISABLE",      "",   0, 0,      "",          "", cmdAny },
+    { "ENABLE",       "",   0, 0,      "",          "", cmdAny },
+    { "FORCE_MIST",   "U",  1, 120,    "[seconds]", "", cmdAny },
+    { "HELP",         "W",  0, 0,      "[command]", "", cmdAny },
+    { "HISTORY",      "",   0, 0,      "",          "", cmdAny },
+    { "SET_DURATION", "u",  1, 120,    "seconds",   "", cmdAny },
+    { "SET_INTERVAL", "u",  60, 86400, "seconds",   "", cmdAny },
+    { "SET_SCHEDULE", "t",  0, 0,      "cron",      "", cmdAny },
+    { "SET_WINDOW",   "uu", 0, 24,     "start end", "", cmdAny },
+    { "STATS",        "",   0, 0,      "",          "", cmdAny },
+    { "STATUS",       "",   0, 0,      "",          "", cmdAny },
+};
+static const size_t COMMAND_COUNT = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+static_assert(commandTableSorted(COMMANDS, COMMAND_COUNT), "sorted");
+
+static const char* LINES[] = {
+    "status", "FORCE_MIST 10", "set_interval 3600", "ENABLE", "set_window 9 18",
+    "HELP STATUS", "disable", "HISTORY", "UNKNOWN", "force_mist",
+    "SET_SCHEDULE */5 9-17 * * MON-FRI",
+};
+static const size_t LINE_COUNT = sizeof(LINES) / sizeof(LINES[0]);
+
+// The dispatch it replaced: trim, upper-case, strcmp chain, no arguments
+static void legacyDispatch(char* cmd) {
+    for (char* p = cmd; *p; p++) {
+        if (*p >= 'a' && *p <= 'z') {
+            *p = *p - 32;
+        }
+    }
+    if (strcmp(cmd, "ENABLE") == 0) {
+        handled++;
+    } else if (strcmp(cmd, "DISABLE") == 0) {
+        handled++;
+    } else if (strcmp(cmd, "FORCE_MIST") == 0) {
+        handled++;
+    } else if (strcmp(cmd, "STATUS") == 0) {
+        handled++;
+    } else if (strcmp(cmd, "HISTORY") == 0) {
+        handled++;
+    }
+}
+
+// One line per operation, cycling through LINES
+BENCH(commands, registry_execute) {
+    CommandRegistry registry(COMMANDS, COMMAND_COUNT);
+    NullOutput out;
+    char line[64];
+    for (uint64_t i = 0; i < iterations; i++) {
+        strcpy(line, LINES[i % LINE_COUNT]);
+        benchKeep(registry.execute(line, &out));
+    }
+    benchKeep(handled);
+}
+
+BENCH(commands, strcmp_chain) {
+    char line[64];
+    for (uint64_t i = 0; i < iterations; i++) {
+        strcpy(line, LINES[i % LINE_COUNT]);
+        legacyDispatch(line);
+    }
+    benchKeep(handled);
+}
@@ -0,0 +1,121 @@
+// bench/bench_schedule_expression.cpp
+// Window checks: compiled cron bitsets against the hour comparison and
+// seconds-of-day arithmetic they replaced
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "BenchHarness.h"
+#include "ScheduleExpression.h"
+
+static const int START_HOUR = 9;
+static const int END_HOUR = 18;
+
+// The replaced isInActiveWindow()
+static bool legacyInWindow(const struct tm& local) {
+    return local.tm_hour >= START_HOUR && local.tm_hour < END_HOUR;
+}
+
+// The replaced window part of secondsUntilNextEvent()
+static long legacySecondsUntilEdge(const struct tm& local) {
+    long secondOfDay = local.tm_hour * 3600L + local.tm_min * 60L + local.tm_sec;
+    long windowStart = START_HOUR * 3600L;
+    long windowEnd = END_HOUR * 3600L;
+    if (secondOfDay < windowStart) {
+        return windowStart - secondOfDay;
+    }
+    if (secondOfDay >= windowEnd) {
+        return 86400L - secondOfDay + windowStart;
+    }
+    return windowEnd - secondOfDay;
+}
+
+// One week of local times, a minute apart
+static const int SAMPLES = 7 * 1440;
+static struct tm samples[SAMPLES];
+static bool samplesReady;
+
+static void fillSamples() {
+    if (samplesReady) {
+        return;
+    }
+    samplesReady = true;
+    for (int i = 0; i < SAMPLES; i++) {
+        memset(&samples[i], 0, sizeof(samples[i]));
+        samples[i].tm_year = 126;
+        samples[i].tm_mon = 0;
+        samples[i].tm_mday = 19 + i / 1440;
+        samples[i].tm_wday = (1 + i / 1440) % 7;
+        samples[i].tm_hour = (i / 60) % 24;
+        samples[i].tm_min = i % 60;
+    }
+}
+
+static ScheduleExpression hourWindow() {
+    return ScheduleExpression::hours(START_HOUR, END_HOUR);
+}
+
+static ScheduleExpression fourRules() {
+    ScheduleExpression expression;
+    expression.compile("30-59 6 * * MON-FRI; * 8-11,15-17 * * MON-FRI; * 10-20 * * SAT,SUN; * 22-1 * * SAT");
+    return expression;
+}
+
+// One query per operation, cycling through a week of minutes
+template <typename Query>
+static void runQueries(uint64_t iterations, Query query) {
+    fillSamples();
+    long sum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        sum += query(samples[i % SAMPLES]);
+    }
+    benchKeep(sum);
+}
+
+BENCH(window, hour_compare) {
+    runQueries(iterations, [](const struct tm& t) { return (long)legacyInWindow(t); });
+}
+
+BENCH(window, bitset_hours) {
+    ScheduleExpression hours = hourWindow();
+
+    // Same answers as the comparison it replaced, checked once
+    static bool checked;
+    if (!checked) {
+        checked = true;
+        fillSamples();
+        for (int i = 0; i < SAMPLES; i++) {
+            if (hours.matches(samples[i]) != legacyInWindow(samples[i])) {
+                fprintf(stderr, "MISMATCH at sample %d\n", i);
+                exit(1);
+            }
+        }
+    }
+    runQueries(iterations, [&](const struct tm& t) { return (long)hours.matches(t); });
+}
+
+BENCH(window, bitset_4_rules) {
+    ScheduleExpression complex = fourRules();
+    runQueries(iterations, [&](const struct tm& t) { return (long)complex.matches(t); });
+}
+
+// The scheduler asks at most two minutes ahead (its wait is capped at 60s);
+// a day and a week show the worst cases
+BENCH(window, edge_arithmetic) {
+    runQueries(iterations, [](const struct tm& t) { return legacySecondsUntilEdge(t); });
+}
+
+BENCH(window, minutes_until_2min) {
+    ScheduleExpression hours = hourWindow();
+    runQueries(iterations, [&](const struct tm& t) { return hours.minutesUntil(t, !hours.matches(t), 2); });
+}
+
+BENCH(window, minutes_until_1day) {
+    ScheduleExpression hours = hourWindow();
+    runQueries(iterations, [&](const struct tm& t) { return hours.minutesUntil(t, !hours.matches(t), 1440); });
+}
+
+BENCH(window, minutes_until_4_rules_1week) {
+    ScheduleExpression complex = fourRules();
+    runQueries(iterations, [&](const struct tm& t) { return complex.minutesUntil(t, !complex.matches(t), 7 * 1440); });
+}
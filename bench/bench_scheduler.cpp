@@ -0,0 +1,168 @@
+// bench/bench_scheduler.cpp
+// MistingScheduler hot paths: update() in each state, state and config
+// persistence through MockStateStorage, and printStatus() formatting
+
+#include "BenchHarness.h"
+#include "MistingScheduler.h"
+#include "native/mocks/MockTimeProvider.h"
+#include "native/mocks/MockRelayController.h"
+#include "native/mocks/MockStateStorage.h"
+
+static unsigned long loggedBytes;
+
+static void countText(const char* message) {
+    while (*message) {
+        loggedBytes++;
+        message++;
+    }
+}
+
+static void countEvent(const LogEvent& event) {
+    loggedBytes += event.id;
+}
+
+// Scheduler with mocks, driven into a given state
+struct SchedulerFixture {
+    MockTimeProvider time;
+    MockRelayController relay;
+    MockStateStorage storage;
+    MistingScheduler scheduler;
+
+    SchedulerFixture() : scheduler(&time, &relay, &storage) {}
+
+    // IDLE inside the window, one mist done, interval not yet elapsed
+    void idleAfterMist() {
+        time.setHour(10);
+        scheduler.update();
+        time.advanceMillis(MistingScheduler::MIST_DURATION);
+        scheduler.update();
+    }
+};
+
+BENCH(scheduler, update_waiting_sync) {
+    SchedulerFixture f;
+    f.time.setTimeAvailable(false);
+    for (uint64_t i = 0; i < iterations; i++) {
+        f.scheduler.update();
+    }
+    benchKeep(f.scheduler.getState());
+}
+
+BENCH(scheduler, update_idle_outside_window) {
+    SchedulerFixture f;
+    f.time.setHour(20);
+    for (uint64_t i = 0; i < iterations; i++) {
+        f.scheduler.update();
+    }
+    benchKeep(f.scheduler.getState());
+}
+
+BENCH(scheduler, update_idle_in_window) {
+    SchedulerFixture f;
+    f.idleAfterMist();
+    for (uint64_t i = 0; i < iterations; i++) {
+        f.scheduler.update();
+    }
+    benchKeep(f.scheduler.getState());
+}
+
+// Mist running, not yet due to stop
+BENCH(scheduler, update_misting) {
+    SchedulerFixture f;
+    f.scheduler.update();
+    for (uint64_t i = 0; i < iterations; i++) {
+        f.scheduler.update();
+    }
+    benchKeep(f.scheduler.getState());
+}
+
+BENCH(scheduler, update_disabled) {
+    SchedulerFixture f;
+    f.scheduler.setEnabled(false);
+    for (uint64_t i = 0; i < iterations; i++) {
+        f.scheduler.update();
+    }
+    benchKeep(f.scheduler.getState());
+}
+
+BENCH(scheduler, next_event_idle) {
+    SchedulerFixture f;
+    f.idleAfterMist();
+    unsigned long sum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        sum += f.scheduler.getNextEventMillis();
+    }
+    benchKeep(sum);
+}
+
+// State record and schedule config record, as at boot
+BENCH(storage, load_state) {
+    SchedulerFixture f;
+    f.idleAfterMist();
+    f.scheduler.setConfig(ScheduleConfig(20000, 3600, 8, 20));
+    for (uint64_t i = 0; i < iterations; i++) {
+        f.scheduler.loadState();
+    }
+    benchKeep(f.scheduler.getLastMistEpoch());
+}
+
+// Every call changes the state, so every call writes
+BENCH(storage, save_state_changed) {
+    SchedulerFixture f;
+    f.idleAfterMist();
+    for (uint64_t i = 0; i < iterations; i++) {
+        f.scheduler.setEnabled((i & 1) != 0);
+    }
+    benchKeep(f.storage.getSaveCallCount());
+}
+
+// Unchanged state: the write is skipped
+BENCH(storage, save_state_unchanged) {
+    SchedulerFixture f;
+    f.idleAfterMist();
+    for (uint64_t i = 0; i < iterations; i++) {
+        f.scheduler.saveState();
+    }
+    benchKeep(f.storage.getSaveCallCount());
+}
+
+// Validate, swap, encode and save a config record
+BENCH(storage, save_config) {
+    SchedulerFixture f;
+    ScheduleConfig configs[2] = { ScheduleConfig(20000, 3600, 8, 20), ScheduleConfig(25000, 7200, 9, 18) };
+    for (uint64_t i = 0; i < iterations; i++) {
+        f.scheduler.setConfig(configs[i & 1]);
+    }
+    benchKeep(f.storage.getScheduleConfigSaveCount());
+}
+
+// Text logging: every line formatted
+BENCH(status, print_status_text) {
+    MockTimeProvider time;
+    MockRelayController relay;
+    MistingScheduler scheduler(&time, &relay, nullptr, countText);
+    time.setHour(10);
+    scheduler.update();
+    time.advanceMillis(MistingScheduler::MIST_DURATION);
+    scheduler.update();
+    for (uint64_t i = 0; i < iterations; i++) {
+        scheduler.printStatus();
+    }
+    benchKeep(loggedBytes);
+}
+
+// Event logging: catalog IDs and arguments only (binary log path)
+BENCH(status, print_status_events) {
+    MockTimeProvider time;
+    MockRelayController relay;
+    MistingScheduler scheduler(&time, &relay);
+    scheduler.setEventLogger(countEvent);
+    time.setHour(10);
+    scheduler.update();
+    time.advanceMillis(MistingScheduler::MIST_DURATION);
+    scheduler.update();
+    for (uint64_t i = 0; i < iterations; i++) {
+        scheduler.printStatus();
+    }
+    benchKeep(loggedBytes);
+}
@@ -0,0 +1,283 @@
+// sim/DeviceSimulation.cpp
+#include "DeviceSimulation.h"
+#include <math.h>
+#include <algorithm>
+
+static const int64_t MS_PER_MINUTE = 60000;
+static const int64_t MS_PER_HOUR = 3600000;
+static const double MS_PER_YEAR = 365.2425 * 86400000.0;
+static const int64_t NEVER = INT64_MAX;
+
+// Power cut and NTP outage lengths (log-uniform between the bounds)
+static const int64_t POWER_CUT_MIN_MS = 1 * MS_PER_MINUTE;
+static const int64_t POWER_CUT_MAX_MS = 8 * MS_PER_HOUR;
+static const int64_t NTP_OUTAGE_MIN_MS = 10 * MS_PER_MINUTE;
+static const int64_t NTP_OUTAGE_MAX_MS = 72 * MS_PER_HOUR;
+
+// How far ahead to look for an active window edge before re-checking
+static const long WINDOW_LOOKAHEAD_MINUTES = 1440;
+
+void DayStats::add(const DayStats& other) {
+    hours += other.hours;
+    mists += other.mists;
+    onTimeMs += other.onTimeMs;
+    windows += other.windows;
+    missedWindows += other.missedWindows;
+    powerCuts += other.powerCuts;
+    boots += other.boots;
+    interruptedMists += other.interruptedMists;
+    lostSaves += other.lostSaves;
+}
+
+DeviceSimulation::DeviceSimulation(const SimOptions& options)
+    : options(options), relay(&clock), cutIndex(0), outageIndex(0), startMs(0), powered(false), booted(false), syncAtMs(NEVER),
+      schedulerDueMs(NEVER), windowOpen(false), windowMisted(false), windowEdgeMs(0), dayStartMs(0),
+      dayEndMs(0), daysDone(0), countedStarts(0), countedOnTimeMs(0), updateCount(0) {
+    clock.setTimeZone(options.timeZone);
+    zone.parse(options.timeZone);
+    trueLocal.setTimeZone(&zone);
+
+    // Local midnight of the first day
+    int64_t midnight = PosixTimeZone::daysFromCivil(options.startYear, options.startMonth, options.startDay) * 86400;
+    startMs = (midnight - zone.utcOffsetAt((time_t)midnight)) * 1000;
+
+    std::mt19937 rng(options.seed);
+    generate(rng, options.powerCutsPerYear, POWER_CUT_MIN_MS, POWER_CUT_MAX_MS, &powerCuts);
+    generate(rng, options.ntpOutagesPerYear, NTP_OUTAGE_MIN_MS, NTP_OUTAGE_MAX_MS, &ntpOutages);
+
+    // Not yet installed: unpowered until the first boot
+    if (options.firstBootMs > 0) {
+        addPowerCut(startMs, startMs + options.firstBootMs);
+    }
+    if (options.regionalCutStartMs >= 0 && options.regionalCutMs > 0) {
+        addPowerCut(startMs + options.regionalCutStartMs, startMs + options.regionalCutStartMs + options.regionalCutMs);
+    }
+}
+
+void DeviceSimulation::addPowerCut(int64_t cutStartMs, int64_t cutEndMs) {
+    Interval cut;
+    cut.startMs = cutStartMs;
+    cut.endMs = cutEndMs;
+    std::vector<Interval>::iterator it = powerCuts.begin();
+    while (it != powerCuts.end() && it->startMs < cutStartMs) {
+        ++it;
+    }
+    it = powerCuts.insert(it, cut);
+
+    // Merge with overlapping neighbours
+    if (it != powerCuts.begin() && (it - 1)->endMs >= it->startMs) {
+        --it;
+        it->endMs = std::max(it->endMs, (it + 1)->endMs);
+        powerCuts.erase(it + 1);
+    }
+    while (it + 1 != powerCuts.end() && (it + 1)->startMs <= it->endMs) {
+        it->endMs = std::max(it->endMs, (it + 1)->endMs);
+        powerCuts.erase(it + 1);
+    }
+}
+
+void DeviceSimulation::generate(std::mt19937& rng, double perYear, int64_t minMs, int64_t maxMs,
+                                std::vector<Interval>* out) {
+    if (perYear <= 0) {
+        return;
+    }
+    // Poisson arrivals over the whole run (plus a day of slack), never
+    // overlapping the previous interval
+    std::exponential_distribution<double> gap(perYear / MS_PER_YEAR);
+    std::uniform_real_distribution<double> logLength(log((double)minMs), log((double)maxMs));
+    int64_t endMs = startMs + ((int64_t)options.days + 1) * 24 * MS_PER_HOUR;
+    int64_t t = startMs;
+    while (true) {
+        t += (int64_t)gap(rng);
+        if (t >= endMs) {
+            break;
+        }
+        Interval interval;
+        interval.startMs = t;
+        interval.endMs = t + (int64_t)exp(logLength(rng));
+        out->push_back(interval);
+        t = interval.endMs;
+    }
+}
+
+void DeviceSimulation::run(DayCallback onDay, void* context) {
+    clock.advanceTo(startMs);
+    beginDay(startMs);
+
+    struct tm local;
+    trueLocal.toLocal((time_t)(startMs / 1000), &local);
+    windowOpen = options.config.activeWindow.matches(local);
+    windowEdgeMs = nextWindowEdge(startMs, local);
+    if (powerCuts.empty() || powerCuts[0].startMs > startMs) {
+        powerOn();
+    }
+
+    while (daysDone < options.days) {
+        int64_t next = dayEndMs;
+        if (windowEdgeMs < next) {
+            next = windowEdgeMs;
+        }
+        if (cutIndex < powerCuts.size()) {
+            int64_t cutEdge = powered ? powerCuts[cutIndex].startMs : powerCuts[cutIndex].endMs;
+            if (cutEdge < next) {
+                next = cutEdge;
+            }
+        }
+        if (powered) {
+            if (schedulerDueMs < next) {
+                next = schedulerDueMs;
+            }
+            if (syncAtMs < next) {
+                next = syncAtMs;
+            }
+        }
+        step(next, onDay, context);
+    }
+}
+
+void DeviceSimulation::step(int64_t nowMs, DayCallback onDay, void* context) {
+    clock.advanceTo(nowMs);
+
+    if (cutIndex < powerCuts.size()) {
+        if (powered && nowMs >= powerCuts[cutIndex].startMs) {
+            powerOff();
+        } else if (!powered && nowMs >= powerCuts[cutIndex].endMs) {
+            cutIndex++;
+            powerOn();
+        }
+    }
+    if (powered && nowMs >= syncAtMs) {
+        clock.sync();
+        syncAtMs = NEVER;
+    }
+
+    // A window closing at midnight belongs to the day that ends, one
+    // opening at midnight to the day that begins
+    struct tm local;
+    trueLocal.toLocal((time_t)(nowMs / 1000), &local);
+    bool active = options.config.activeWindow.matches(local);
+    if (windowOpen && !active) {
+        windowOpen = false;
+        if (booted) {
+            today.windows++;
+            if (!windowMisted) {
+                today.missedWindows++;
+            }
+        }
+    }
+    if (nowMs >= dayEndMs) {
+        finishDay(onDay, context);
+    }
+    if (!windowOpen && active) {
+        windowOpen = true;
+        windowMisted = false;
+    }
+    if (nowMs >= windowEdgeMs) {
+        windowEdgeMs = nextWindowEdge(nowMs, local);
+    }
+
+    if (!powered) {
+        return;
+    }
+
+    scheduler->update();
+    updateCount++;
+    schedulerDueMs = clock.toSimMs(scheduler->getNextEventMillis());
+    if (schedulerDueMs <= nowMs) {
+        schedulerDueMs = nowMs + 1;  // The main loop would spin; move on by the smallest step
+    }
+
+    uint32_t starts = relay.getStartCount();
+    if (starts != countedStarts) {
+        today.mists += starts - countedStarts;
+        countedStarts = starts;
+        if (windowOpen) {
+            windowMisted = true;
+        }
+    }
+}
+
+void DeviceSimulation::powerOn() {
+    clock.powerOn();
+    scheduler.reset(new MistingScheduler(&clock, &relay, &storage));
+    scheduler->setSaveCoalesceMs(options.saveCoalesceMs);
+    scheduler->loadState();
+    if (scheduler->getConfig() != options.config) {
+        scheduler->setConfig(options.config);  // First boot: persist the simulated schedule
+    }
+
+    powered = true;
+    booted = true;
+    syncAtMs = firstSyncAfter(clock.now() + options.syncDelayMs);
+    schedulerDueMs = clock.now();
+    today.boots++;
+}
+
+void DeviceSimulation::powerOff() {
+    if (relay.isOn()) {
+        today.interruptedMists++;
+    }
+    relay.turnOff();
+    if (scheduler->hasPendingSave()) {
+        today.lostSaves++;
+    }
+    scheduler.reset();
+
+    powered = false;
+    syncAtMs = NEVER;
+    schedulerDueMs = NEVER;
+    today.powerCuts++;
+}
+
+int64_t DeviceSimulation::firstSyncAfter(int64_t ms) {
+    while (outageIndex < ntpOutages.size() && ntpOutages[outageIndex].endMs <= ms) {
+        outageIndex++;
+    }
+    if (outageIndex < ntpOutages.size() && ntpOutages[outageIndex].startMs <= ms) {
+        return ntpOutages[outageIndex].endMs;  // SNTP keeps retrying; first answer once the outage ends
+    }
+    return ms;
+}
+
+void DeviceSimulation::beginDay(int64_t dayStart) {
+    struct tm local;
+    trueLocal.toLocal((time_t)(dayStart / 1000), &local);
+    today = DayStats();
+    today.year = local.tm_year + 1900;
+    today.month = local.tm_mon + 1;
+    today.day = local.tm_mday;
+
+    long secondOfDay = local.tm_hour * 3600L + local.tm_min * 60L + local.tm_sec;
+    dayStartMs = dayStart;
+    dayEndMs = wallClockLater(dayStart, 86400L - secondOfDay);
+}
+
+void DeviceSimulation::finishDay(DayCallback onDay, void* context) {
+    today.hours = (int)((dayEndMs - dayStartMs + MS_PER_HOUR / 2) / MS_PER_HOUR);
+    today.onTimeMs = relay.getOnTimeMs() - countedOnTimeMs;
+    countedOnTimeMs = relay.getOnTimeMs();
+
+    totals.add(today);
+    daysDone++;
+    if (onDay) {
+        onDay(today, context);
+    }
+    beginDay(dayEndMs);
+}
+
+int64_t DeviceSimulation::nextWindowEdge(int64_t nowMs, const struct tm& local) {
+    int64_t minuteStartMs = nowMs - (nowMs % MS_PER_MINUTE);
+    long minutes = options.config.activeWindow.minutesUntil(local, !windowOpen, WINDOW_LOOKAHEAD_MINUTES);
+    if (minutes < 0) {
+        minutes = WINDOW_LOOKAHEAD_MINUTES;
+    }
+    return wallClockLater(minuteStartMs, minutes * 60);
+}
+
+int64_t DeviceSimulation::wallClockLater(int64_t fromMs, long seconds) {
+    // Correct for a UTC offset change in between (23 and 25 hour days)
+    int64_t candidate = fromMs + (int64_t)seconds * 1000;
+    int32_t offsetBefore = zone.utcOffsetAt((time_t)(fromMs / 1000));
+    int32_t offsetAfter = zone.utcOffsetAt((time_t)(candidate / 1000));
+    return candidate + (int64_t)(offsetBefore - offsetAfter) * 1000;
+}
@@ -0,0 +1,154 @@
+// sim/DeviceSimulation.h
+#ifndef DEVICE_SIMULATION_H
+#define DEVICE_SIMULATION_H
+
+#include <stdint.h>
+#include <memory>
+#include <random>
+#include <vector>
+#include "MistingScheduler.h"
+#include "LocalTimeCache.h"
+#include "PosixTimeZone.h"
+#include "ScheduleConfig.h"
+#include "VirtualClock.h"
+#include "SimRelay.h"
+#include "native/mocks/MockStateStorage.h"
+
+struct SimOptions {
+    int startYear;                // First simulated day (local date)
+    int startMonth;
+    int startDay;
+    uint32_t days;
+    const char* timeZone;         // POSIX TZ string
+    ScheduleConfig config;        // Set on first boot, then loaded from storage
+    double powerCutsPerYear;      // Mean rate; lengths 1 min to 8 h
+    double ntpOutagesPerYear;     // Mean rate; lengths 10 min to 3 days
+    unsigned long syncDelayMs;    // Power-on to first NTP answer
+    unsigned long saveCoalesceMs; // As STATE_SAVE_COALESCE_MS in main.cpp
+    uint32_t seed;                // Outage and power cut times
+    int64_t firstBootMs;          // First power-on, after the start of the first day
+    int64_t regionalCutStartMs;   // Extra power cut, after the start of the first day (-1: none)
+    int64_t regionalCutMs;
+
+    SimOptions()
+        : startYear(2026), startMonth(1), startDay(1), days(365),
+          timeZone("PST8PDT,M3.2.0,M11.1.0"),
+          config(MistingScheduler::MIST_DURATION, MistingScheduler::MIST_INTERVAL_SECONDS,
+                 MistingScheduler::ACTIVE_WINDOW_START, MistingScheduler::ACTIVE_WINDOW_END),
+          powerCutsPerYear(12), ntpOutagesPerYear(6), syncDelayMs(4000), saveCoalesceMs(2000), seed(1),
+          firstBootMs(0), regionalCutStartMs(-1), regionalCutMs(0) {
+    }
+};
+
+// Statistics of one local calendar day (or the sum of several)
+struct DayStats {
+    int year;                   // Local date
+    int month;
+    int day;
+    int hours;                  // Length of the day: 23 or 25 on DST changes
+    uint32_t mists;             // Mists started
+    int64_t onTimeMs;           // Relay on-time of mists that ended this day
+    uint32_t windows;           // Active windows that closed this day
+    uint32_t missedWindows;     // ... without a mist starting in them
+    uint32_t powerCuts;
+    uint32_t boots;
+    uint32_t interruptedMists;  // Mists cut short by a power cut
+    uint32_t lostSaves;         // Coalesced state saves lost to a power cut
+
+    DayStats()
+        : year(0), month(0), day(0), hours(0), mists(0), onTimeMs(0), windows(0), missedWindows(0),
+          powerCuts(0), boots(0), interruptedMists(0), lostSaves(0) {
+    }
+
+    void add(const DayStats& other);
+};
+
+typedef void (*DayCallback)(const DayStats& day, void* context);
+
+/**
+ * Discrete-event simulation of one device: MistingScheduler with a virtual
+ * clock, a relay and in-memory storage, run through DST changes, power
+ * cuts and NTP outages.
+ *
+ * Time never ticks. Each step jumps straight to the earliest pending event:
+ * the scheduler's own deadline (getNextEventMillis(), as the tickless main
+ * loop sleeps), a power cut starting or ending, the NTP answer after boot,
+ * an active window edge or local midnight. A simulated year is about half
+ * a million steps, dominated by the scheduler's one-minute maximum wait.
+ *
+ * Power cuts drop the relay, discard the scheduler (and any coalesced save
+ * not yet written) and boot a new one from storage; the clock is unset
+ * until NTP answers, later if an NTP outage is in progress. Outages do not
+ * affect a device that is already synced, since its clock keeps running.
+ * Active windows are tracked in true local time from the first boot, so a
+ * window lost to a power cut or a slow sync counts as missed.
+ */
+class DeviceSimulation {
+public:
+    explicit DeviceSimulation(const SimOptions& options);
+
+    // Simulate every day, reporting each one as it ends (onDay may be null)
+    void run(DayCallback onDay, void* context);
+
+    // Report every relay on-period (mist) as it ends; set before run()
+    void setMistCallback(RelayPeriodCallback callback, void* context) { relay.setListener(callback, context); }
+
+    // Local midnight starting the first day, in simulation time (UTC ms)
+    int64_t getStartMs() const { return startMs; }
+
+    const DayStats& getTotals() const { return totals; }
+    uint64_t getUpdateCount() const { return updateCount; }
+
+private:
+    struct Interval {
+        int64_t startMs;
+        int64_t endMs;
+    };
+
+    SimOptions options;
+    VirtualClock clock;
+    SimRelay relay;
+    MockStateStorage storage;
+    std::unique_ptr<MistingScheduler> scheduler;
+
+    // True local time for the statistics, independent of the device clock
+    PosixTimeZone zone;
+    LocalTimeCache trueLocal;
+
+    std::vector<Interval> powerCuts;
+    std::vector<Interval> ntpOutages;
+    size_t cutIndex;
+    size_t outageIndex;
+
+    int64_t startMs;
+    bool powered;
+    bool booted;             // Powered on at least once (windows are counted from then)
+    int64_t syncAtMs;        // NTP answer for the current boot
+    int64_t schedulerDueMs;  // Scheduler's next deadline
+
+    bool windowOpen;
+    bool windowMisted;       // A mist started in the open window
+    int64_t windowEdgeMs;    // Next time to re-check the window
+
+    int64_t dayStartMs;
+    int64_t dayEndMs;
+    DayStats today;
+    DayStats totals;
+    uint32_t daysDone;
+    uint32_t countedStarts;  // Relay starts already attributed
+    int64_t countedOnTimeMs; // Relay on-time already attributed
+    uint64_t updateCount;
+
+    void step(int64_t nowMs, DayCallback onDay, void* context);
+    void powerOn();
+    void powerOff();
+    int64_t firstSyncAfter(int64_t ms);
+    void beginDay(int64_t dayStart);
+    void finishDay(DayCallback onDay, void* context);
+    int64_t nextWindowEdge(int64_t nowMs, const struct tm& local);
+    int64_t wallClockLater(int64_t fromMs, long seconds);
+    void generate(std::mt19937& rng, double perYear, int64_t minMs, int64_t maxMs, std::vector<Interval>* out);
+    void addPowerCut(int64_t cutStartMs, int64_t cutEndMs);
+};
+
+#endif
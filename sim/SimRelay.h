@@ -0,0 +1,59 @@
+// sim/SimRelay.h
+#ifndef SIM_RELAY_H
+#define SIM_RELAY_H
+
+#include <stdint.h>
+#include "IRelayController.h"
+#include "VirtualClock.h"
+
+// Called when the relay turns off, with the on-period in simulation time
+typedef void (*RelayPeriodCallback)(int64_t onMs, int64_t offMs, void* context);
+
+/**
+ * Relay that accounts its on-time against the simulated clock.
+ */
+class SimRelay : public IRelayController {
+public:
+    explicit SimRelay(VirtualClock* clock)
+        : clock(clock), listener(nullptr), listenerContext(nullptr), on(false), onSinceMs(0), startCount(0), onTimeMs(0) {
+    }
+
+    void setListener(RelayPeriodCallback callback, void* context) {
+        listener = callback;
+        listenerContext = context;
+    }
+
+    void turnOn() override {
+        if (!on) {
+            on = true;
+            onSinceMs = clock->now();
+            startCount++;
+        }
+    }
+
+    void turnOff() override {
+        if (on) {
+            on = false;
+            onTimeMs += clock->now() - onSinceMs;
+            if (listener) {
+                listener(onSinceMs, clock->now(), listenerContext);
+            }
+        }
+    }
+
+    bool isOn() const { return on; }
+    int64_t getOnSinceMs() const { return onSinceMs; }
+    uint32_t getStartCount() const { return startCount; }
+    int64_t getOnTimeMs() const { return onTimeMs; }
+
+private:
+    VirtualClock* clock;
+    RelayPeriodCallback listener;
+    void* listenerContext;
+    bool on;
+    int64_t onSinceMs;
+    uint32_t startCount;
+    int64_t onTimeMs;  // Completed on-periods only
+};
+
+#endif
@@ -0,0 +1,80 @@
+// sim/VirtualClock.h
+#ifndef VIRTUAL_CLOCK_H
+#define VIRTUAL_CLOCK_H
+
+#include <stdint.h>
+#include "ITimeProvider.h"
+#include "LocalTimeCache.h"
+#include "PosixTimeZone.h"
+
+/**
+ * Simulated device clock. True time (UTC milliseconds) only moves when the
+ * simulation advances it, so the scheduler can be run straight from one
+ * event to the next instead of tick by tick.
+ *
+ * Behaves like the ESP32 time sources after a power-on: millis() restarts
+ * at 0 and the system clock counts up from the 1970 epoch until NTP sets
+ * it, so local time is invalid until sync(), as with NTPTimeProvider.
+ * Once synced the clock is exact (no drift).
+ */
+class VirtualClock : public ITimeProvider {
+public:
+    VirtualClock() : nowMs(0), bootMs(0), synced(false) {}
+
+    // POSIX TZ string, converted as on the device (PosixTimeZone)
+    bool setTimeZone(const char* tz) {
+        bool parsed = timeZone.parse(tz);
+        localTime.setTimeZone(&timeZone);
+        return parsed;
+    }
+
+    void advanceTo(int64_t ms) { nowMs = ms; }
+    int64_t now() const { return nowMs; }
+
+    // Power-on reset: millis() from 0, system clock unset
+    void powerOn() {
+        bootMs = nowMs;
+        synced = false;
+    }
+
+    // First NTP answer after boot
+    void sync() { synced = true; }
+    bool isSynced() const { return synced; }
+
+    // Simulation time of a millis() value of the current boot
+    int64_t toSimMs(unsigned long deviceMillis) const { return bootMs + (int64_t)deviceMillis; }
+
+    bool getTime(struct tm* timeinfo) override {
+        return toLocal(getEpochTime(), timeinfo);
+    }
+
+    unsigned long getMillis() override {
+        return (unsigned long)(nowMs - bootMs);
+    }
+
+    time_t getEpochTime() override {
+        return (time_t)((synced ? nowMs : nowMs - bootMs) / 1000);
+    }
+
+    bool getSnapshot(TimeSnapshot* snapshot) override {
+        snapshot->millis = getMillis();
+        snapshot->epoch = getEpochTime();
+        snapshot->localValid = toLocal(snapshot->epoch, &snapshot->local);
+        return snapshot->localValid;
+    }
+
+private:
+    int64_t nowMs;   // True UTC time
+    int64_t bootMs;  // True time of the last power-on
+    bool synced;
+    PosixTimeZone timeZone;
+    LocalTimeCache localTime;
+
+    // Same validity rule as NTPTimeProvider
+    bool toLocal(time_t epoch, struct tm* timeinfo) {
+        localTime.toLocal(epoch, timeinfo);
+        return timeinfo->tm_year > (2016 - 1900);
+    }
+};
+
+#endif
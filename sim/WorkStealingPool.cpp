@@ -0,0 +1,83 @@
+// sim/WorkStealingPool.cpp
+#include "WorkStealingPool.h"
+#include <thread>
+#include <vector>
+
+WorkStealingPool::WorkStealingPool(unsigned threads) : threadCount(threads), steals(0) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    shares.reset(new Share[threadCount]);
+}
+
+void WorkStealingPool::run(size_t count, const Task& task) {
+    steals = 0;
+    for (unsigned i = 0; i < threadCount; i++) {
+        shares[i].begin = count * i / threadCount;
+        shares[i].end = count * (i + 1) / threadCount;
+    }
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount; i++) {
+        threads.push_back(std::thread(&WorkStealingPool::work, this, i, std::cref(task)));
+    }
+    work(0, task);
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+}
+
+void WorkStealingPool::work(unsigned worker, const Task& task) {
+    size_t index;
+    while (true) {
+        if (take(worker, &index)) {
+            task(index, worker);
+            continue;
+        }
+        // A range just stolen can be stolen again before it is taken from:
+        // stop only when a steal finds every share empty
+        if (!steal(worker)) {
+            break;
+        }
+    }
+}
+
+bool WorkStealingPool::take(unsigned worker, size_t* index) {
+    Share& share = shares[worker];
+    std::lock_guard<std::mutex> guard(share.lock);
+    if (share.begin >= share.end) {
+        return false;
+    }
+    *index = share.begin++;
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned thief) {
+    // Victims in turn, starting after the thief so thieves spread out
+    for (unsigned offset = 1; offset < threadCount; offset++) {
+        Share& victim = shares[(thief + offset) % threadCount];
+        size_t begin;
+        size_t end;
+        {
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (victim.begin >= victim.end) {
+                continue;
+            }
+            // Back half, rounded up so a single remaining index moves too
+            end = victim.end;
+            begin = victim.end - (victim.end - victim.begin + 1) / 2;
+            victim.end = begin;
+        }
+
+        Share& own = shares[thief];
+        std::lock_guard<std::mutex> guard(own.lock);
+        own.begin = begin;
+        own.end = end;
+        steals++;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,58 @@
+// sim/WorkStealingPool.h
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <stddef.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+/**
+ * Runs a task for every index in [0, count) on a fixed number of threads.
+ *
+ * Each worker starts with an equal contiguous share of the indices and
+ * takes them one at a time from the front of its share. A worker that runs
+ * dry steals the back half of another worker's remaining share, so uneven
+ * task costs (a device with many power cuts, a slow core) even out without
+ * a central queue. A share is touched by its owner once per task and by a
+ * thief once per steal, so its lock is almost never contended.
+ *
+ * A worker stops after finding every share empty; work moved by a steal in
+ * progress at that moment is finished by the thief.
+ */
+class WorkStealingPool {
+public:
+    typedef std::function<void(size_t index, unsigned worker)> Task;
+
+    // threads = 0: one per hardware thread
+    explicit WorkStealingPool(unsigned threads = 0);
+
+    unsigned getThreadCount() const { return threadCount; }
+
+    // Run task(index, worker) for every index; the caller is worker 0.
+    // Returns when all indices are done.
+    void run(size_t count, const Task& task);
+
+    // Steals during the last run()
+    unsigned long getStealCount() const { return steals.load(); }
+
+private:
+    // One worker's remaining indices [begin, end), padded to its own cache line
+    struct Share {
+        std::mutex lock;
+        size_t begin;
+        size_t end;
+        char padding[64];
+    };
+
+    unsigned threadCount;
+    std::unique_ptr<Share[]> shares;
+    std::atomic<unsigned long> steals;
+
+    void work(unsigned worker, const Task& task);
+    bool take(unsigned worker, size_t* index);
+    bool steal(unsigned thief);
+};
+
+#endif
@@ -0,0 +1,263 @@
+// sim/fleet_main.cpp
+// Simulates a fleet of independent devices on all cores and reports
+// fleet-wide load on a shared water line (make fleet)
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "DeviceSimulation.h"
+#include "WorkStealingPool.h"
+
+static const int64_t MS_PER_MINUTE = 60000;
+static const int64_t MS_PER_HOUR = 3600000;
+static const int TOP_MINUTES = 5;
+
+static void usage() {
+    printf("usage: program [options]\n"
+           "  --devices N        Devices in the fleet (default 10000)\n"
+           "  --days N           Days to simulate (default 30)\n"
+           "  --threads N        Worker threads (default: one per hardware thread)\n"
+           "  --start YYYY-MM-DD First local day (default 2026-01-01)\n"
+           "  --tz TZ            POSIX time zone (default PST8PDT,M3.2.0,M11.1.0)\n"
+           "  --schedule CRON    Active window as cron rules (default \"* 9-17 * * *\")\n"
+           "  --interval S       Seconds between mists (default 7200)\n"
+           "  --duration S       Mist length in seconds (default 25)\n"
+           "  --install-hours H  Devices first power on at random within H hours (default 24)\n"
+           "  --power-cuts N     Local power cuts per device per year (default 2)\n"
+           "  --ntp-outages N    NTP outages per device per year (default 2)\n"
+           "  --regional-cut D,H,M  Cut power to every device on day D (from 0) at\n"
+           "                     hour H after local midnight, for M minutes\n"
+           "  --seed N           Base random seed (default 1)\n");
+}
+
+/**
+ * One worker's results. Workers only write their own, so the fleet runs
+ * without shared state; the results are merged after the run.
+ */
+struct WorkerResults {
+    DayStats totals;
+    uint64_t updates;
+    uint32_t devices;
+    int64_t startMs;                      // Minute 0
+    std::vector<uint64_t> onMsByMinute;   // Relay on-time across the fleet
+    std::vector<uint32_t> startsByMinute; // Mists started across the fleet
+
+    WorkerResults() : updates(0), devices(0), startMs(0) {}
+};
+
+// Spread one mist's on-time over the minutes it covers
+static void recordMist(int64_t onMs, int64_t offMs, void* context) {
+    WorkerResults* results = (WorkerResults*)context;
+    int64_t first = (onMs - results->startMs) / MS_PER_MINUTE;
+    int64_t size = (int64_t)results->onMsByMinute.size();
+    if (first < 0 || first >= size) {
+        return;
+    }
+    results->startsByMinute[first]++;
+    for (int64_t minute = first; minute < size; minute++) {
+        int64_t minuteStart = results->startMs + minute * MS_PER_MINUTE;
+        int64_t from = std::max(onMs, minuteStart);
+        int64_t to = std::min(offMs, minuteStart + MS_PER_MINUTE);
+        if (from >= to) {
+            break;
+        }
+        results->onMsByMinute[minute] += to - from;
+    }
+}
+
+static void formatLocal(PosixTimeZone& zone, int64_t ms, char* out, size_t size) {
+    struct tm local;
+    zone.toLocal((time_t)(ms / 1000), &local);
+    snprintf(out, size, "%04d-%02d-%02d %02d:%02d", local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+             local.tm_hour, local.tm_min);
+}
+
+int main(int argc, char** argv) {
+    SimOptions base;
+    base.days = 30;
+    base.powerCutsPerYear = 2;
+    base.ntpOutagesPerYear = 2;
+    const char* schedule = nullptr;
+    unsigned long intervalSeconds = base.config.intervalSeconds;
+    unsigned long durationSeconds = base.config.mistDurationMs / 1000;
+    unsigned long devices = 10000;
+    unsigned threads = 0;
+    double installHours = 24;
+    int cutDay = -1;
+    int cutHour = 0;
+    int cutMinutes = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!value || strcmp(arg, "--help") == 0) {
+            usage();
+            return strcmp(arg, "--help") == 0 ? 0 : 1;
+        }
+        i++;
+        if (strcmp(arg, "--devices") == 0) {
+            devices = strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--days") == 0) {
+            base.days = (uint32_t)strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--threads") == 0) {
+            threads = (unsigned)strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--start") == 0) {
+            if (sscanf(value, "%d-%d-%d", &base.startYear, &base.startMonth, &base.startDay) != 3) {
+                fprintf(stderr, "ERROR: bad date: %s\n", value);
+                return 1;
+            }
+        } else if (strcmp(arg, "--tz") == 0) {
+            base.timeZone = value;
+        } else if (strcmp(arg, "--schedule") == 0) {
+            schedule = value;
+        } else if (strcmp(arg, "--interval") == 0) {
+            intervalSeconds = strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--duration") == 0) {
+            durationSeconds = strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--install-hours") == 0) {
+            installHours = atof(value);
+        } else if (strcmp(arg, "--power-cuts") == 0) {
+            base.powerCutsPerYear = atof(value);
+        } else if (strcmp(arg, "--ntp-outages") == 0) {
+            base.ntpOutagesPerYear = atof(value);
+        } else if (strcmp(arg, "--regional-cut") == 0) {
+            if (sscanf(value, "%d,%d,%d", &cutDay, &cutHour, &cutMinutes) != 3 || cutDay < 0 || cutMinutes <= 0) {
+                fprintf(stderr, "ERROR: bad regional cut (day,hour,minutes): %s\n", value);
+                return 1;
+            }
+        } else if (strcmp(arg, "--seed") == 0) {
+            base.seed = (uint32_t)strtoul(value, nullptr, 10);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    PosixTimeZone zone;
+    if (!zone.parse(base.timeZone)) {
+        fprintf(stderr, "ERROR: bad time zone: %s\n", base.timeZone);
+        return 1;
+    }
+    ScheduleExpression window = base.config.activeWindow;
+    if (schedule && !window.compile(schedule)) {
+        fprintf(stderr, "ERROR: bad schedule: %s\n", schedule);
+        return 1;
+    }
+    base.config = ScheduleConfig(durationSeconds * 1000, intervalSeconds, window);
+    if (!base.config.isValid() || devices == 0 || base.days == 0) {
+        fprintf(stderr, "ERROR: invalid schedule config, device count or day count\n");
+        return 1;
+    }
+    if (cutDay >= 0) {
+        // Counted in elapsed hours from the first midnight (no DST correction)
+        base.regionalCutStartMs = (int64_t)cutDay * 24 * MS_PER_HOUR + (int64_t)cutHour * MS_PER_HOUR;
+        base.regionalCutMs = (int64_t)cutMinutes * MS_PER_MINUTE;
+    }
+
+    WorkStealingPool pool(threads);
+    std::vector<WorkerResults> results(pool.getThreadCount());
+    size_t minutes = ((size_t)base.days + 1) * 1440;
+    int64_t startMs = DeviceSimulation(base).getStartMs();
+    for (size_t i = 0; i < results.size(); i++) {
+        results[i].startMs = startMs;
+        results[i].onMsByMinute.assign(minutes, 0);
+        results[i].startsByMinute.assign(minutes, 0);
+    }
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    pool.run(devices, [&](size_t index, unsigned worker) {
+        // Per-device jitter, reproducible from the base seed and the index
+        std::mt19937 rng(base.seed * 1000003u + (uint32_t)index);
+        SimOptions options = base;
+        options.seed = rng();
+        options.firstBootMs = (int64_t)(std::uniform_real_distribution<double>(0, installHours)(rng) * MS_PER_HOUR);
+        options.syncDelayMs = std::uniform_int_distribution<unsigned long>(2000, 10000)(rng);
+
+        WorkerResults& own = results[worker];
+        DeviceSimulation device(options);
+        device.setMistCallback(recordMist, &own);
+        device.run(nullptr, nullptr);
+        own.totals.add(device.getTotals());
+        own.updates += device.getUpdateCount();
+        own.devices++;
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    // Merge
+    WorkerResults fleet;
+    fleet.onMsByMinute.assign(minutes, 0);
+    fleet.startsByMinute.assign(minutes, 0);
+    for (size_t i = 0; i < results.size(); i++) {
+        fleet.totals.add(results[i].totals);
+        fleet.updates += results[i].updates;
+        fleet.devices += results[i].devices;
+        for (size_t m = 0; m < minutes; m++) {
+            fleet.onMsByMinute[m] += results[i].onMsByMinute[m];
+            fleet.startsByMinute[m] += results[i].startsByMinute[m];
+        }
+    }
+
+    char text[128];
+    base.config.activeWindow.format(text, sizeof(text));
+    printf("FLEET: devices=%lu days=%lu threads=%u window=\"%s\" interval=%lus mist=%lums seed=%lu\n",
+           (unsigned long)fleet.devices, (unsigned long)base.days, pool.getThreadCount(), text,
+           base.config.intervalSeconds, base.config.mistDurationMs, (unsigned long)base.seed);
+    const DayStats& totals = fleet.totals;
+    printf("FLEET: mists=%lu on=%.1fh windows=%lu missed=%lu (%.2f%%) cuts=%lu boots=%lu cut_mists=%lu lost_saves=%lu\n",
+           (unsigned long)totals.mists, totals.onTimeMs / 3600000.0, (unsigned long)totals.windows,
+           (unsigned long)totals.missedWindows, totals.windows ? 100.0 * totals.missedWindows / totals.windows : 0.0,
+           (unsigned long)totals.powerCuts, (unsigned long)totals.boots, (unsigned long)totals.interruptedMists,
+           (unsigned long)totals.lostSaves);
+
+    // Water line load: mean number of mists running during each minute
+    std::vector<size_t> order;
+    for (size_t m = 0; m < minutes; m++) {
+        if (fleet.onMsByMinute[m] > 0) {
+            order.push_back(m);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return fleet.onMsByMinute[a] > fleet.onMsByMinute[b];
+    });
+    if (!order.empty()) {
+        double p99 = fleet.onMsByMinute[order[order.size() / 100]] / (double)MS_PER_MINUTE;
+        double p50 = fleet.onMsByMinute[order[order.size() / 2]] / (double)MS_PER_MINUTE;
+        printf("FLEET: water line load (mean mists running, minutes with any): p50=%.1f p99=%.1f max=%.1f\n",
+               p50, p99, fleet.onMsByMinute[order[0]] / (double)MS_PER_MINUTE);
+        for (int i = 0; i < TOP_MINUTES && i < (int)order.size(); i++) {
+            formatLocal(zone, startMs + (int64_t)order[i] * MS_PER_MINUTE, text, sizeof(text));
+            printf("FLEET: busiest %s load=%.1f starts=%lu\n", text,
+                   fleet.onMsByMinute[order[i]] / (double)MS_PER_MINUTE, (unsigned long)fleet.startsByMinute[order[i]]);
+        }
+    }
+
+    if (cutDay >= 0) {
+        // The hour after power returns everywhere at once
+        size_t restored = (size_t)((base.regionalCutStartMs + base.regionalCutMs) / MS_PER_MINUTE);
+        uint64_t peakMs = 0;
+        size_t peakMinute = restored;
+        unsigned long starts = 0;
+        for (size_t m = restored; m < restored + 60 && m < minutes; m++) {
+            starts += fleet.startsByMinute[m];
+            if (fleet.onMsByMinute[m] > peakMs) {
+                peakMs = fleet.onMsByMinute[m];
+                peakMinute = m;
+            }
+        }
+        formatLocal(zone, startMs + (int64_t)restored * MS_PER_MINUTE, text, sizeof(text));
+        printf("FLEET: regional cut restored %s: %lu mists in the next hour, peak load=%.1f", text, starts,
+               peakMs / (double)MS_PER_MINUTE);
+        formatLocal(zone, startMs + (int64_t)peakMinute * MS_PER_MINUTE, text, sizeof(text));
+        printf(" at %s\n", text);
+    }
+
+    double deviceDays = (double)fleet.devices * base.days;
+    printf("FLEET: updates=%llu steals=%lu wall=%.2fs rate=%.0f device-days/s (%.0f per thread)\n",
+           (unsigned long long)fleet.updates, pool.getStealCount(), seconds, deviceDays / seconds,
+           deviceDays / seconds / pool.getThreadCount());
+    return 0;
+}
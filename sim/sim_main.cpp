@@ -0,0 +1,120 @@
+// sim/sim_main.cpp
+// Runs one device through years of simulated time and prints per-day
+// statistics (make sim, or .pio/build/sim/program --help)
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "DeviceSimulation.h"
+
+static void usage() {
+    printf("usage: program [options]\n"
+           "  --years N          Days to simulate, in years (default 1)\n"
+           "  --days N           Days to simulate\n"
+           "  --start YYYY-MM-DD First local day (default 2026-01-01)\n"
+           "  --tz TZ            POSIX time zone (default PST8PDT,M3.2.0,M11.1.0)\n"
+           "  --schedule CRON    Active window as cron rules (default \"* 9-17 * * *\")\n"
+           "  --interval S       Seconds between mists (default 7200)\n"
+           "  --duration S       Mist length in seconds (default 25)\n"
+           "  --power-cuts N     Power cuts per year (default 12)\n"
+           "  --ntp-outages N    NTP outages per year (default 6)\n"
+           "  --seed N           Random seed for cut and outage times (default 1)\n"
+           "  --quiet            Summary only, no per-day lines\n");
+}
+
+static void printDay(const DayStats& day, void* context) {
+    printf("%04d-%02d-%02d %dh mists=%lu on=%.1fs windows=%lu missed=%lu cuts=%lu boots=%lu "
+           "cut_mists=%lu lost_saves=%lu\n",
+           day.year, day.month, day.day, day.hours, (unsigned long)day.mists, day.onTimeMs / 1000.0,
+           (unsigned long)day.windows, (unsigned long)day.missedWindows, (unsigned long)day.powerCuts,
+           (unsigned long)day.boots, (unsigned long)day.interruptedMists, (unsigned long)day.lostSaves);
+}
+
+int main(int argc, char** argv) {
+    SimOptions options;
+    const char* schedule = nullptr;
+    unsigned long intervalSeconds = options.config.intervalSeconds;
+    unsigned long durationSeconds = options.config.mistDurationMs / 1000;
+    double years = 1;
+    long days = 0;
+    bool quiet = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--quiet") == 0) {
+            quiet = true;
+            continue;
+        }
+        if (!value || strcmp(arg, "--help") == 0) {
+            usage();
+            return strcmp(arg, "--help") == 0 ? 0 : 1;
+        }
+        i++;
+        if (strcmp(arg, "--years") == 0) {
+            years = atof(value);
+        } else if (strcmp(arg, "--days") == 0) {
+            days = atol(value);
+        } else if (strcmp(arg, "--start") == 0) {
+            if (sscanf(value, "%d-%d-%d", &options.startYear, &options.startMonth, &options.startDay) != 3) {
+                fprintf(stderr, "ERROR: bad date: %s\n", value);
+                return 1;
+            }
+        } else if (strcmp(arg, "--tz") == 0) {
+            options.timeZone = value;
+        } else if (strcmp(arg, "--schedule") == 0) {
+            schedule = value;
+        } else if (strcmp(arg, "--interval") == 0) {
+            intervalSeconds = strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--duration") == 0) {
+            durationSeconds = strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--power-cuts") == 0) {
+            options.powerCutsPerYear = atof(value);
+        } else if (strcmp(arg, "--ntp-outages") == 0) {
+            options.ntpOutagesPerYear = atof(value);
+        } else if (strcmp(arg, "--seed") == 0) {
+            options.seed = (uint32_t)strtoul(value, nullptr, 10);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    PosixTimeZone zone;
+    if (!zone.parse(options.timeZone)) {
+        fprintf(stderr, "ERROR: bad time zone: %s\n", options.timeZone);
+        return 1;
+    }
+    ScheduleExpression window = options.config.activeWindow;
+    if (schedule && !window.compile(schedule)) {
+        fprintf(stderr, "ERROR: bad schedule: %s\n", schedule);
+        return 1;
+    }
+    options.config = ScheduleConfig(durationSeconds * 1000, intervalSeconds, window);
+    if (!options.config.isValid()) {
+        fprintf(stderr, "ERROR: invalid schedule config (see ScheduleConfig limits)\n");
+        return 1;
+    }
+    options.days = (uint32_t)(days > 0 ? days : (long)(years * 365.2425 + 0.5));
+
+    DeviceSimulation simulation(options);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    simulation.run(quiet ? nullptr : printDay, nullptr);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const DayStats& totals = simulation.getTotals();
+    char text[128];
+    options.config.activeWindow.format(text, sizeof(text));
+    printf("SIM: days=%lu tz=%s window=\"%s\" interval=%lus mist=%lums seed=%lu\n",
+           (unsigned long)options.days, options.timeZone, text, options.config.intervalSeconds,
+           options.config.mistDurationMs, (unsigned long)options.seed);
+    printf("SIM: mists=%lu on=%.1fs windows=%lu missed=%lu cuts=%lu boots=%lu cut_mists=%lu lost_saves=%lu\n",
+           (unsigned long)totals.mists, totals.onTimeMs / 1000.0, (unsigned long)totals.windows,
+           (unsigned long)totals.missedWindows, (unsigned long)totals.powerCuts, (unsigned long)totals.boots,
+           (unsigned long)totals.interruptedMists, (unsigned long)totals.lostSaves);
+    printf("SIM: updates=%llu wall=%.3fs rate=%.1f simulated years/s\n",
+           (unsigned long long)simulation.getUpdateCount(), seconds,
+           seconds > 0 ? options.days / 365.2425 / seconds : 0.0);
+    return 0;
+}
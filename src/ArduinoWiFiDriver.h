@@ -0,0 +1,68 @@
+// src/ArduinoWiFiDriver.h
+#ifndef ARDUINO_WIFI_DRIVER_H
+#define ARDUINO_WIFI_DRIVER_H
+
+#include "INetworkDriver.h"
+#include "secrets.h"
+#include <Arduino.h>
+#include "WiFi.h"
+
+class ArduinoWiFiDriver : public INetworkDriver {
+public:
+    ArduinoWiFiDriver(const char* ssid, const char* password, const char* ntpServer)
+        : ssid(ssid), password(password), ntpServer(ntpServer) {}
+
+    void beginConnect() override {
+        WiFi.disconnect();
+        WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));  // DHCP
+        WiFi.begin(ssid, password);
+    }
+
+    void beginConnectFast(const NetworkCache& cache) override {
+        WiFi.disconnect();
+        if (cache.hasIpLease()) {
+            WiFi.config(IPAddress(cache.ip), IPAddress(cache.gateway),
+                        IPAddress(cache.subnet), IPAddress(cache.dns));
+        } else {
+            WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+        }
+        WiFi.begin(ssid, password, cache.channel, cache.bssid);
+    }
+
+    bool getConnectionInfo(NetworkCache* cache) override {
+        if (WiFi.status() != WL_CONNECTED) {
+            return false;
+        }
+        uint8_t* bssid = WiFi.BSSID();
+        if (!bssid) {
+            return false;
+        }
+        memcpy(cache->bssid, bssid, sizeof(cache->bssid));
+        cache->channel = (uint8_t)WiFi.channel();
+        cache->ip = (uint32_t)WiFi.localIP();
+        cache->gateway = (uint32_t)WiFi.gatewayIP();
+        cache->subnet = (uint32_t)WiFi.subnetMask();
+        cache->dns = (uint32_t)WiFi.dnsIP(0);
+        cache->valid = 1;
+        return true;
+    }
+
+    bool isConnected() override {
+        return WiFi.status() == WL_CONNECTED;
+    }
+
+    void startTimeSync() override {
+#ifdef TIMEZONE_STRING
+        configTzTime(TIMEZONE_STRING, ntpServer);
+#else
+        configTime(GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC, ntpServer);
+#endif
+    }
+
+private:
+    const char* ssid;
+    const char* password;
+    const char* ntpServer;
+};
+
+#endif
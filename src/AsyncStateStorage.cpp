@@ -0,0 +1,244 @@
+// src/AsyncStateStorage.cpp
+#include "AsyncStateStorage.h"
+#include <string.h>
+
+AsyncStateStorage::AsyncStateStorage(IStateStorage* backing, IWorkerTask* worker, LogCallback logger)
+    : backing(backing), worker(worker), logger(logger), started(false),
+      backSlot(0), frontSlot(1), sharedSlot(2), retryFront(false),
+      writtenStateSeq(0), writtenNetworkSeq(0), writtenZoneSeq(0), writtenConfigSeq(0),
+      persistedSeq(0), persistedStateSeq(0), writtenCount(0), failedCount(0) {
+    for (int i = 0; i < 3; i++) {
+        slots[i] = Snapshot();
+    }
+    lastAccepted = Snapshot();
+}
+
+AsyncStateStorage::~AsyncStateStorage() {
+    if (started) {
+        worker->stop();
+    }
+}
+
+bool AsyncStateStorage::begin() {
+    if (!worker) {
+        return true;
+    }
+    started = worker->start(&AsyncStateStorage::workerBody, this);
+    if (!started) {
+        log("STORAGE: Worker start failed");
+    }
+    return started;
+}
+
+unsigned long AsyncStateStorage::getLastMistTime() {
+    unsigned long lastMistTime;
+    bool hasEverMisted, enabled;
+    load(&lastMistTime, &hasEverMisted, &enabled);
+    return lastMistTime;
+}
+
+bool AsyncStateStorage::getHasEverMisted() {
+    unsigned long lastMistTime;
+    bool hasEverMisted, enabled;
+    load(&lastMistTime, &hasEverMisted, &enabled);
+    return hasEverMisted;
+}
+
+bool AsyncStateStorage::getEnabled() {
+    unsigned long lastMistTime;
+    bool hasEverMisted, enabled;
+    load(&lastMistTime, &hasEverMisted, &enabled);
+    return enabled;
+}
+
+bool AsyncStateStorage::save(unsigned long lastMistTime, bool hasEverMisted, bool enabled) {
+    lastAccepted.stateSeq++;
+    lastAccepted.lastMistTime = lastMistTime;
+    lastAccepted.hasEverMisted = hasEverMisted;
+    lastAccepted.enabled = enabled;
+    publish();
+    return true;  // Accepted; persistence is reported through flush()
+}
+
+bool AsyncStateStorage::load(unsigned long* lastMistTime, bool* hasEverMisted, bool* enabled) {
+    if (lastAccepted.stateSeq > 0) {
+        *lastMistTime = lastAccepted.lastMistTime;
+        *hasEverMisted = lastAccepted.hasEverMisted;
+        *enabled = lastAccepted.enabled;
+        return true;
+    }
+    return flush() && backing->load(lastMistTime, hasEverMisted, enabled);
+}
+
+bool AsyncStateStorage::loadNetworkCache(NetworkCache* cache) {
+    if (lastAccepted.networkSeq > 0) {
+        *cache = lastAccepted.network;
+        return cache->valid;
+    }
+    return flush() && backing->loadNetworkCache(cache);
+}
+
+bool AsyncStateStorage::saveNetworkCache(const NetworkCache& cache) {
+    lastAccepted.networkSeq++;
+    lastAccepted.network = cache;
+    publish();
+    return true;
+}
+
+bool AsyncStateStorage::loadZoneState(void* record, size_t length) {
+    if (lastAccepted.zone.seq > 0) {
+        return readRecord(lastAccepted.zone, record, length);
+    }
+    return flush() && backing->loadZoneState(record, length);
+}
+
+bool AsyncStateStorage::saveZoneState(const void* record, size_t length) {
+    return acceptRecord(&lastAccepted.zone, record, length);
+}
+
+bool AsyncStateStorage::loadScheduleConfig(void* record, size_t length) {
+    if (lastAccepted.config.seq > 0) {
+        return readRecord(lastAccepted.config, record, length);
+    }
+    return flush() && backing->loadScheduleConfig(record, length);
+}
+
+bool AsyncStateStorage::saveScheduleConfig(const void* record, size_t length) {
+    return acceptRecord(&lastAccepted.config, record, length);
+}
+
+void AsyncStateStorage::publish() {
+    lastAccepted.seq++;
+    slots[backSlot] = lastAccepted;
+
+    // Publish; whatever the consumer has not picked up yet is recycled
+    uint8_t previous = sharedSlot.exchange((uint8_t)(backSlot | SLOT_DIRTY), std::memory_order_acq_rel);
+    backSlot = previous & SLOT_MASK;
+
+    if (started) {
+        worker->wake();
+    }
+}
+
+bool AsyncStateStorage::acceptRecord(Record* record, const void* data, size_t length) {
+    if (length > MAX_RECORD_SIZE) {
+        log("STORAGE: Record too large for write-behind");
+        return false;
+    }
+    record->seq++;
+    record->length = (uint16_t)length;
+    memcpy(record->bytes, data, length);
+    publish();
+    return true;
+}
+
+bool AsyncStateStorage::readRecord(const Record& record, void* data, size_t length) {
+    if (record.length != length) {
+        return false;
+    }
+    memcpy(data, record.bytes, length);
+    return true;
+}
+
+bool AsyncStateStorage::flush(unsigned long timeoutMs) {
+    uint32_t target = lastAccepted.seq;
+    if (persistedSeq.load(std::memory_order_acquire) >= target) {
+        return true;
+    }
+
+    if (!started) {
+        persistPending();
+        return persistedSeq.load(std::memory_order_acquire) >= target;
+    }
+
+    worker->wake();
+    unsigned long waited = 0;
+    while (persistedSeq.load(std::memory_order_acquire) < target) {
+        if (waited >= timeoutMs) {
+            log("STORAGE: Flush timed out");
+            return false;
+        }
+        worker->sleepMs(1);
+        waited++;
+        if (waited % 100 == 0) {
+            worker->wake();  // Retry a failed write
+        }
+    }
+    return true;
+}
+
+bool AsyncStateStorage::persistPending() {
+    // Take the newest snapshot; a newer one supersedes a failed retry
+    if (sharedSlot.load(std::memory_order_acquire) & SLOT_DIRTY) {
+        uint8_t previous = sharedSlot.exchange(frontSlot, std::memory_order_acq_rel);
+        frontSlot = previous & SLOT_MASK;
+        retryFront = true;
+    }
+    if (!retryFront) {
+        return false;
+    }
+
+    // Write every record that changed since it was last written; one that
+    // fails is retried without holding back the others
+    const Snapshot& snapshot = slots[frontSlot];
+    bool success = true;
+    if (snapshot.stateSeq > writtenStateSeq) {
+        if (backing->save(snapshot.lastMistTime, snapshot.hasEverMisted, snapshot.enabled)) {
+            writtenStateSeq = snapshot.stateSeq;
+            writtenCount.fetch_add(1);
+            persistedStateSeq.store(snapshot.stateSeq);
+        } else {
+            success = false;
+        }
+    }
+    if (snapshot.networkSeq > writtenNetworkSeq) {
+        if (backing->saveNetworkCache(snapshot.network)) {
+            writtenNetworkSeq = snapshot.networkSeq;
+        } else {
+            success = false;
+        }
+    }
+    success &= persistRecord(snapshot.zone, &writtenZoneSeq, &IStateStorage::saveZoneState);
+    success &= persistRecord(snapshot.config, &writtenConfigSeq, &IStateStorage::saveScheduleConfig);
+
+    if (!success) {
+        failedCount.fetch_add(1);
+        log("STORAGE: Background save failed, will retry");
+        return true;
+    }
+
+    retryFront = false;
+    persistedSeq.store(snapshot.seq, std::memory_order_release);
+    return true;
+}
+
+bool AsyncStateStorage::persistRecord(const Record& record, uint32_t* writtenSeq,
+                                      bool (IStateStorage::*write)(const void*, size_t)) {
+    if (record.seq <= *writtenSeq) {
+        return true;
+    }
+    if (!(backing->*write)(record.bytes, record.length)) {
+        return false;
+    }
+    *writtenSeq = record.seq;
+    return true;
+}
+
+uint32_t AsyncStateStorage::getCollapsedCount() const {
+    uint32_t persisted = persistedStateSeq.load();
+    uint32_t written = writtenCount.load();
+    return (persisted > written) ? persisted - written : 0;
+}
+
+void AsyncStateStorage::workerBody(void* arg) {
+    AsyncStateStorage* self = static_cast<AsyncStateStorage*>(arg);
+    while (self->persistPending() && !self->retryFront) {
+        // Drain snapshots published while the previous write was in progress
+    }
+}
+
+void AsyncStateStorage::log(const char* message) {
+    if (logger) {
+        logger(message);
+    }
+}
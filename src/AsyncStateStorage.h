@@ -0,0 +1,137 @@
+// src/AsyncStateStorage.h
+#ifndef ASYNC_STATE_STORAGE_H
+#define ASYNC_STATE_STORAGE_H
+
+#include <atomic>
+#include <stdint.h>
+#include "IStateStorage.h"
+#include "IWorkerTask.h"
+#include "NetworkCache.h"
+
+// Logging callback type
+typedef void (*LogCallback)(const char* message);
+
+/**
+ * Write-behind IStateStorage decorator.
+ *
+ * Every save (state, network cache, zone state, schedule config) only
+ * updates the caller's copy of the records, publishes it into a lock-free
+ * single-producer / single-consumer triple buffer and wakes the worker, so
+ * the control loop never waits for a flash erase. The worker writes each
+ * record that changed since its last write, from the newest snapshot;
+ * snapshots superseded before the worker ran are collapsed (last writer
+ * wins). Persisted records therefore only move forward and are always
+ * whole.
+ *
+ * Reads return the last accepted record (read-your-writes). A record never
+ * saved through this object is read from the backing storage after a
+ * flush(), so the backing storage is never used from two tasks at once; if
+ * the flush times out the read fails instead. Saves must be called from a
+ * single task.
+ *
+ * Without a worker, persistPending() must be called by the owner
+ * (deterministic tests); flush() does so itself.
+ */
+class AsyncStateStorage : public IStateStorage {
+public:
+    static const unsigned long DEFAULT_FLUSH_TIMEOUT_MS = 2000;
+    static const size_t MAX_RECORD_SIZE = 128;  // Zone state and schedule config records
+
+    AsyncStateStorage(IStateStorage* backing, IWorkerTask* worker = nullptr, LogCallback logger = nullptr);
+    ~AsyncStateStorage();
+
+    /**
+     * Start the worker. Until then saves are queued but not persisted.
+     */
+    bool begin();
+
+    // IStateStorage interface implementation
+    unsigned long getLastMistTime() override;
+    bool getHasEverMisted() override;
+    bool getEnabled() override;
+    bool save(unsigned long lastMistTime, bool hasEverMisted, bool enabled) override;
+    bool load(unsigned long* lastMistTime, bool* hasEverMisted, bool* enabled) override;
+    bool loadNetworkCache(NetworkCache* cache) override;
+    bool saveNetworkCache(const NetworkCache& cache) override;
+    bool loadZoneState(void* record, size_t length) override;
+    bool saveZoneState(const void* record, size_t length) override;
+    bool loadScheduleConfig(void* record, size_t length) override;
+    bool saveScheduleConfig(const void* record, size_t length) override;
+
+    /**
+     * Barrier: wait until every accepted snapshot is persisted.
+     * @return false if not everything was persisted within timeoutMs
+     */
+    bool flush(unsigned long timeoutMs = DEFAULT_FLUSH_TIMEOUT_MS);
+
+    /**
+     * Consumer step (worker side): persist the newest snapshot, if any.
+     * @return true if a write was attempted
+     */
+    bool persistPending();
+
+    // Statistics (state saves)
+    uint32_t getAcceptedCount() const { return lastAccepted.stateSeq; }
+    uint32_t getWrittenCount() const { return writtenCount.load(); }
+    uint32_t getFailedCount() const { return failedCount.load(); }
+    uint32_t getCollapsedCount() const;
+
+private:
+    struct Record {
+        uint32_t seq;  // Saves of this record accepted so far (0: never saved here)
+        uint16_t length;
+        uint8_t bytes[MAX_RECORD_SIZE];
+    };
+
+    struct Snapshot {
+        uint32_t seq;  // Saves of any record accepted so far
+        uint32_t stateSeq;
+        unsigned long lastMistTime;
+        bool hasEverMisted;
+        bool enabled;
+        uint32_t networkSeq;
+        NetworkCache network;
+        Record zone;
+        Record config;
+    };
+
+    static const uint8_t SLOT_MASK = 0x03;
+    static const uint8_t SLOT_DIRTY = 0x04;
+
+    IStateStorage* backing;
+    IWorkerTask* worker;
+    LogCallback logger;
+    bool started;
+
+    // Triple buffer: producer owns slots[backSlot], consumer owns
+    // slots[frontSlot], the third index (plus dirty bit) is in sharedSlot
+    Snapshot slots[3];
+    uint8_t backSlot;
+    uint8_t frontSlot;
+    std::atomic<uint8_t> sharedSlot;
+    bool retryFront;  // Consumer: slots[frontSlot] not fully persisted
+
+    // Producer side: every record as last saved
+    Snapshot lastAccepted;
+
+    // Consumer side: per-record sequence last written
+    uint32_t writtenStateSeq;
+    uint32_t writtenNetworkSeq;
+    uint32_t writtenZoneSeq;
+    uint32_t writtenConfigSeq;
+
+    std::atomic<uint32_t> persistedSeq;
+    std::atomic<uint32_t> persistedStateSeq;
+    std::atomic<uint32_t> writtenCount;
+    std::atomic<uint32_t> failedCount;
+
+    void publish();
+    bool acceptRecord(Record* record, const void* data, size_t length);
+    static bool readRecord(const Record& record, void* data, size_t length);
+    bool persistRecord(const Record& record, uint32_t* writtenSeq,
+                       bool (IStateStorage::*write)(const void*, size_t));
+    static void workerBody(void* arg);
+    void log(const char* message);
+};
+
+#endif
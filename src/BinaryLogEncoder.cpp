@@ -0,0 +1,88 @@
+// src/BinaryLogEncoder.cpp
+#include "BinaryLogEncoder.h"
+#include "Crc32.h"
+#include <string.h>
+
+static size_t putVarint(uint8_t* out, uint32_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+// Small negative values stay small: 0, -1, 1, -2 -> 0, 1, 2, 3
+static uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+BinaryLogEncoder::BinaryLogEncoder()
+    : lastMillis(0), timeBaseValid(false), baseEpoch(0), baseMillis(0) {
+}
+
+size_t BinaryLogEncoder::encode(const LogEntry& entry, uint8_t* buffer, size_t size) {
+    if (size < MAX_OUTPUT) {
+        return 0;
+    }
+
+    size_t length = 0;
+    if (needsTimeBase(entry)) {
+        int32_t epoch = (int32_t)(uint32_t)entry.epoch;
+        length += encodeRecord(LOG_MSG_TIME_BASE, &epoch, nullptr, entry.millis, buffer);
+        timeBaseValid = true;
+        baseEpoch = entry.epoch;
+        baseMillis = entry.millis;
+    }
+    length += encodeRecord(entry.event.id, entry.event.args, entry.text, entry.millis, buffer + length);
+    return length;
+}
+
+bool BinaryLogEncoder::needsTimeBase(const LogEntry& entry) const {
+    if (entry.epoch < LogEntry::MIN_VALID_EPOCH) {
+        return false;  // No wall clock yet: decoder shows millis only
+    }
+    if (!timeBaseValid) {
+        return true;
+    }
+
+    // The decoder derives epoch from millis; resend when they disagree (NTP step)
+    time_t expected = baseEpoch + (time_t)((uint32_t)(entry.millis - baseMillis) / 1000);
+    time_t error = (entry.epoch > expected) ? entry.epoch - expected : expected - entry.epoch;
+    return error > 1;
+}
+
+size_t BinaryLogEncoder::encodeRecord(uint8_t id, const int32_t* args, const char* text,
+                                      unsigned long millis, uint8_t* buffer) {
+    size_t length = 0;
+    buffer[length++] = SYNC;
+    buffer[length++] = id;
+    length += putVarint(buffer + length, (uint32_t)(millis - lastMillis));
+    lastMillis = millis;
+
+    const char* types = logArgTypes(id);
+    for (uint8_t arg = 0; types[arg] && arg < LOG_EVENT_MAX_ARGS; arg++) {
+        switch (types[arg]) {
+            case 'i':
+                length += putVarint(buffer + length, zigzag(args[arg]));
+                break;
+            case 's':
+                buffer[length++] = (uint8_t)args[arg];
+                break;
+            case 't': {
+                size_t textLength = strnlen(text, LogEntry::MESSAGE_MAX - 1);
+                length += putVarint(buffer + length, (uint32_t)textLength);
+                memcpy(buffer + length, text, textLength);
+                length += textLength;
+                break;
+            }
+            default:  // 'u'
+                length += putVarint(buffer + length, (uint32_t)args[arg]);
+                break;
+        }
+    }
+
+    buffer[length] = (uint8_t)crc32(buffer + 1, length - 1);
+    return length + 1;
+}
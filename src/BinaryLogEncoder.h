@@ -0,0 +1,51 @@
+// src/BinaryLogEncoder.h
+#ifndef BINARY_LOG_ENCODER_H
+#define BINARY_LOG_ENCODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "LogRing.h"
+
+/**
+ * Turns queued log entries into compact binary records for the serial port
+ * (BINARY_LOG builds); tools/decode_log.py turns them back into text lines.
+ *
+ * Record layout:
+ *   SYNC, id, varint(millis since previous record), arguments, check
+ * Arguments follow logArgTypes(id): 'i' zigzag varint, 'u' varint,
+ * 's' one byte, 't' varint length + bytes. The check byte is the low byte
+ * of the CRC-32 of everything after SYNC.
+ *
+ * SYNC never occurs in ASCII, so plain text printed between records (command
+ * replies) passes through the decoder unchanged. Wall-clock time is not sent
+ * per record: a TIME_BASE record carries the epoch at its own millis, and is
+ * repeated only when the clock is first set or jumps.
+ */
+class BinaryLogEncoder {
+public:
+    static const uint8_t SYNC = 0xA5;
+
+    // TIME_BASE record followed by the largest (TEXT) record
+    static const size_t MAX_OUTPUT = 2 * (1 + 1 + 5 + 1) + 5 + 5 + LogEntry::MESSAGE_MAX;
+
+    BinaryLogEncoder();
+
+    /**
+     * Encode one entry, preceded by a TIME_BASE record when needed.
+     * @return Bytes written, or 0 if buffer is smaller than MAX_OUTPUT
+     */
+    size_t encode(const LogEntry& entry, uint8_t* buffer, size_t size);
+
+private:
+    unsigned long lastMillis;
+    bool timeBaseValid;
+    time_t baseEpoch;
+    unsigned long baseMillis;
+
+    size_t encodeRecord(uint8_t id, const int32_t* args, const char* text,
+                        unsigned long millis, uint8_t* buffer);
+    bool needsTimeBase(const LogEntry& entry) const;
+};
+
+#endif
@@ -0,0 +1,78 @@
+// src/BootOrchestrator.cpp
+#include "BootOrchestrator.h"
+
+BootOrchestrator::BootOrchestrator(ITimeProvider* timeProvider, INetworkDriver* networkDriver, LogCallback logger)
+    : timeProvider(timeProvider), networkDriver(networkDriver), logger(logger), eventLogger(nullptr), ready(false), readyMs(0) {
+    for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+        stageStartMs[i] = 0;
+        stageEndMs[i] = 0;
+        stageStarted[i] = false;
+        stageDone[i] = false;
+    }
+}
+
+void BootOrchestrator::beginStage(BootStage stage, unsigned long nowMs) {
+    stageStartMs[stage] = nowMs;
+    stageStarted[stage] = true;
+}
+
+void BootOrchestrator::endStage(BootStage stage, unsigned long nowMs) {
+    if (stageDone[stage]) {
+        return;
+    }
+    if (!stageStarted[stage]) {
+        beginStage(stage, nowMs);
+    }
+    stageEndMs[stage] = nowMs;
+    stageDone[stage] = true;
+
+    logEvent(LOG_MSG_BOOT_STAGE_DONE, stageName(stage), (int32_t)getStageDuration(stage), (int32_t)nowMs);
+}
+
+void BootOrchestrator::startBackground(unsigned long nowMs) {
+    beginStage(BOOT_NETWORK, nowMs);
+}
+
+void BootOrchestrator::step(unsigned long nowMs) {
+    if (stageStarted[BOOT_NETWORK] && !stageDone[BOOT_NETWORK] && networkDriver->isConnected()) {
+        endStage(BOOT_NETWORK, nowMs);
+        if (!stageDone[BOOT_TIME_SYNC]) {
+            beginStage(BOOT_TIME_SYNC, nowMs);  // NTP can only start once the link is up
+        }
+    }
+
+    if (!ready) {
+        struct tm timeinfo;
+        if (timeProvider->getTime(&timeinfo)) {
+            endStage(BOOT_TIME_SYNC, nowMs);
+            ready = true;
+            readyMs = nowMs;
+            logEvent(LOG_MSG_BOOT_READY, (int32_t)nowMs);
+        }
+    }
+}
+
+bool BootOrchestrator::isComplete() const {
+    for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+        if (!stageDone[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint8_t BootOrchestrator::stageName(BootStage stage) {
+    switch (stage) {
+        case BOOT_STATE_LOAD:
+            return LOG_STR_STATE_LOAD;
+        case BOOT_NETWORK:
+            return LOG_STR_NETWORK;
+        case BOOT_TIME_SYNC:
+        default:
+            return LOG_STR_TIME_SYNC;
+    }
+}
+
+void BootOrchestrator::logEvent(uint8_t id, int32_t arg0, int32_t arg1, int32_t arg2, int32_t arg3) {
+    emitLogEvent(eventLogger, logger, id, arg0, arg1, arg2, arg3);
+}
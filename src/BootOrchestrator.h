@@ -0,0 +1,69 @@
+// src/BootOrchestrator.h
+#ifndef BOOT_ORCHESTRATOR_H
+#define BOOT_ORCHESTRATOR_H
+
+#include "ITimeProvider.h"
+#include "INetworkDriver.h"
+#include "LogEvent.h"
+
+// Logging callback type (same as MistingScheduler)
+typedef void (*LogCallback)(const char* message);
+
+enum BootStage {
+    BOOT_STATE_LOAD,    // Restore scheduler state from storage (synchronous, first)
+    BOOT_NETWORK,       // WiFi association (background)
+    BOOT_TIME_SYNC,     // Waiting for a trustworthy wall clock (background)
+    BOOT_STAGE_COUNT
+};
+
+/**
+ * Tracks the boot pipeline and measures each stage.
+ * State load runs synchronously in setup(); network bring-up and time sync
+ * run in the background while loop() is already servicing commands and the
+ * scheduler. The system is ready as soon as trustworthy time is available,
+ * which may be before the network (e.g. clock retained across a soft reset);
+ * the network stage is still measured when it completes later.
+ */
+class BootOrchestrator {
+public:
+    BootOrchestrator(ITimeProvider* timeProvider, INetworkDriver* networkDriver, LogCallback logger = nullptr);
+
+    // Stage bookkeeping for synchronous stages run by the caller
+    void beginStage(BootStage stage, unsigned long nowMs);
+    void endStage(BootStage stage, unsigned long nowMs);
+
+    // Begin the background network stage (caller starts the connection)
+    void startBackground(unsigned long nowMs);
+
+    // Call from main loop; completes background stages as they finish
+    void step(unsigned long nowMs);
+
+    // Optional structured logging (see MistingScheduler::setEventLogger)
+    void setEventLogger(LogEventCallback callback) { eventLogger = callback; }
+
+    bool isReady() const { return ready; }
+
+    // Every stage measured; keep calling step() until then, even once ready
+    bool isComplete() const;
+    unsigned long getReadyMillis() const { return readyMs; }
+    bool isStageDone(BootStage stage) const { return stageDone[stage]; }
+    unsigned long getStageDuration(BootStage stage) const { return stageEndMs[stage] - stageStartMs[stage]; }
+
+private:
+    ITimeProvider* timeProvider;
+    INetworkDriver* networkDriver;
+    LogCallback logger;
+    LogEventCallback eventLogger;
+
+    unsigned long stageStartMs[BOOT_STAGE_COUNT];
+    unsigned long stageEndMs[BOOT_STAGE_COUNT];
+    bool stageStarted[BOOT_STAGE_COUNT];
+    bool stageDone[BOOT_STAGE_COUNT];
+    bool ready;
+    unsigned long readyMs;
+
+    static uint8_t stageName(BootStage stage);
+    void logEvent(uint8_t id, int32_t arg0 = 0, int32_t arg1 = 0, int32_t arg2 = 0, int32_t arg3 = 0);
+};
+
+#endif
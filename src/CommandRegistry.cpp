@@ -0,0 +1,208 @@
+// src/CommandRegistry.cpp
+#include "CommandRegistry.h"
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool isSeparator(char c) {
+    return c == ' ' || c == '\t';
+}
+
+// Next upper-cased, NUL-terminated token at *cursor; with restOfLine the
+// token runs to the end of the line (trailing blanks trimmed)
+static char* nextToken(char** cursor, bool restOfLine) {
+    char* p = *cursor;
+    while (isSeparator(*p)) {
+        p++;
+    }
+    if (!*p) {
+        *cursor = p;
+        return nullptr;
+    }
+
+    char* token = p;
+    while (*p && (restOfLine || !isSeparator(*p))) {
+        *p = (char)toupper((unsigned char)*p);
+        p++;
+    }
+    if (restOfLine) {
+        while (isSeparator(p[-1])) {
+            *--p = '\0';
+        }
+    } else if (*p) {
+        *p++ = '\0';
+    }
+    *cursor = p;
+    return token;
+}
+
+static bool parseNumber(const char* token, bool allowNegative, long* value) {
+    if (!allowNegative && *token == '-') {
+        return false;
+    }
+    char* end;
+    errno = 0;
+    long parsed = strtol(token, &end, 10);
+    if (end == token || *end != '\0' || errno == ERANGE) {
+        return false;
+    }
+    *value = parsed;
+    return true;
+}
+
+static bool parseBool(const char* token, long* value) {
+    if (strcmp(token, "ON") == 0 || strcmp(token, "1") == 0 || strcmp(token, "TRUE") == 0) {
+        *value = 1;
+        return true;
+    }
+    if (strcmp(token, "OFF") == 0 || strcmp(token, "0") == 0 || strcmp(token, "FALSE") == 0) {
+        *value = 0;
+        return true;
+    }
+    return false;
+}
+
+CommandRegistry::CommandRegistry(const CommandSpec* table, size_t count, void* context)
+    : table(table), count(count), context(context) {
+}
+
+CommandResult CommandRegistry::execute(char* line, ICommandOutput* out) {
+    char* cursor = line;
+    char* verb = nextToken(&cursor, false);
+    if (!verb) {
+        return CMD_EMPTY;
+    }
+
+    const CommandSpec* spec = find(verb);
+    if (!spec) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "ERROR: Unknown command: %s", verb);
+        out->println(buffer);
+        return CMD_UNKNOWN;
+    }
+
+    // Split the arguments; a trailing text argument takes the rest of the line
+    size_t specCount = strlen(spec->args);
+    size_t textIndex = (specCount > 0 && tolower((unsigned char)spec->args[specCount - 1]) == 't')
+                       ? specCount - 1 : COMMAND_MAX_ARGS;
+    char* tokens[COMMAND_MAX_ARGS];
+    size_t tokenCount = 0;
+    char* token;
+    while ((token = nextToken(&cursor, tokenCount == textIndex)) != nullptr) {
+        if (tokenCount == COMMAND_MAX_ARGS) {
+            printUsage(spec, out);
+            return CMD_BAD_ARGS;
+        }
+        tokens[tokenCount++] = token;
+    }
+
+    CommandArgs args;
+    if (!parseArgs(spec, tokens, tokenCount, &args, out)) {
+        return CMD_BAD_ARGS;
+    }
+
+    spec->handler(args, out, context);
+    return CMD_OK;
+}
+
+const CommandSpec* CommandRegistry::find(const char* name) const {
+    size_t lo = 0;
+    size_t hi = count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int order = strcmp(name, table[mid].name);
+        if (order == 0) {
+            return &table[mid];
+        }
+        if (order < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return nullptr;
+}
+
+bool CommandRegistry::parseArgs(const CommandSpec* spec, char** tokens, size_t tokenCount,
+                                CommandArgs* args, ICommandOutput* out) const {
+    size_t specCount = strlen(spec->args);
+    if (tokenCount > specCount) {
+        printUsage(spec, out);
+        return false;
+    }
+
+    args->count = tokenCount;
+    for (size_t i = 0; i < specCount; i++) {
+        char type = spec->args[i];
+        bool optional = isupper((unsigned char)type) != 0;
+        if (i >= tokenCount) {
+            if (!optional) {
+                printUsage(spec, out);
+                return false;
+            }
+            continue;
+        }
+
+        args->values[i] = 0;
+        args->words[i] = tokens[i];
+        bool valid;
+        switch (tolower((unsigned char)type)) {
+            case 'u':
+            case 'i':
+                valid = parseNumber(tokens[i], tolower((unsigned char)type) == 'i', &args->values[i]);
+                if (valid && (args->values[i] < spec->minValue || args->values[i] > spec->maxValue)) {
+                    char buffer[80];
+                    snprintf(buffer, sizeof(buffer), "ERROR: %s: %ld out of range (%ld-%ld)",
+                             spec->name, args->values[i], spec->minValue, spec->maxValue);
+                    out->println(buffer);
+                    return false;
+                }
+                break;
+            case 'b':
+                valid = parseBool(tokens[i], &args->values[i]);
+                break;
+            default:  // 'w', 't'
+                valid = true;
+                break;
+        }
+        if (!valid) {
+            printUsage(spec, out);
+            return false;
+        }
+    }
+    return true;
+}
+
+void CommandRegistry::printUsage(const CommandSpec* spec, ICommandOutput* out) const {
+    char buffer[80];
+    snprintf(buffer, sizeof(buffer), "ERROR: Usage: %s%s%s",
+             spec->name, *spec->usage ? " " : "", spec->usage);
+    out->println(buffer);
+}
+
+void CommandRegistry::printHelp(ICommandOutput* out, const char* name) const {
+    if (!name) {
+        for (size_t i = 0; i < count; i++) {
+            printHelpLine(&table[i], out);
+        }
+        return;
+    }
+
+    const CommandSpec* spec = find(name);
+    if (!spec) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "ERROR: Unknown command: %s", name);
+        out->println(buffer);
+        return;
+    }
+    printHelpLine(spec, out);
+}
+
+void CommandRegistry::printHelpLine(const CommandSpec* spec, ICommandOutput* out) const {
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "%s%s%s - %s",
+             spec->name, *spec->usage ? " " : "", spec->usage, spec->help);
+    out->println(buffer);
+}
@@ -0,0 +1,98 @@
+// src/CommandRegistry.h
+#ifndef COMMAND_REGISTRY_H
+#define COMMAND_REGISTRY_H
+
+#include <stddef.h>
+#include "ICommandOutput.h"
+
+static const size_t COMMAND_MAX_ARGS = 4;
+
+/**
+ * Parsed arguments, in CommandSpec::args order. Optional arguments that
+ * were not given are absent (index >= count).
+ */
+struct CommandArgs {
+    size_t count;
+    long values[COMMAND_MAX_ARGS];         // 'u', 'i' and 'b' arguments
+    const char* words[COMMAND_MAX_ARGS];   // Every argument's text (upper-cased, in the line buffer)
+
+    bool has(size_t index) const { return index < count; }
+};
+
+typedef void (*CommandHandler)(const CommandArgs& args, ICommandOutput* out, void* context);
+
+/**
+ * One command. Tables are plain constexpr arrays sorted by name, so lookup
+ * is a binary search and sorting is checked at compile time:
+ *
+ *   constexpr CommandSpec COMMANDS[] = { ... };
+ *   static_assert(commandTableSorted(COMMANDS, sizeof(COMMANDS) / sizeof(COMMANDS[0])), "...");
+ *
+ * args has one character per argument:
+ *   'u'  unsigned integer     'i'  signed integer
+ *   'b'  ON/OFF, 1/0, TRUE/FALSE
+ *   'w'  word (any token)
+ *   't'  text: the rest of the line, spaces included (last argument only)
+ * Upper case ('U', 'I', 'B', 'W', 'T') marks an optional argument; optional
+ * arguments must come last. Numeric arguments must lie in
+ * [minValue, maxValue].
+ */
+struct CommandSpec {
+    const char* name;      // Upper case verb
+    const char* args;
+    long minValue;
+    long maxValue;
+    const char* usage;     // Argument synopsis for help, e.g. "[seconds]"
+    const char* help;      // One-line description
+    CommandHandler handler;
+};
+
+enum CommandResult {
+    CMD_OK,
+    CMD_EMPTY,       // Blank line, nothing run
+    CMD_UNKNOWN,     // No such command
+    CMD_BAD_ARGS     // Missing, extra, malformed or out-of-range argument
+};
+
+// Compile-time helpers for static_assert on command tables
+constexpr int commandNameCompare(const char* a, const char* b) {
+    return (*a != *b || *a == '\0') ? (int)(unsigned char)*a - (int)(unsigned char)*b
+                                    : commandNameCompare(a + 1, b + 1);
+}
+
+constexpr bool commandTableSorted(const CommandSpec* table, size_t count) {
+    return count < 2 ||
+           (commandNameCompare(table[0].name, table[1].name) < 0 && commandTableSorted(table + 1, count - 1));
+}
+
+/**
+ * Transport-agnostic command parser and dispatcher. execute() takes one
+ * line from any source (serial, TCP, tests); replies and errors go to the
+ * given ICommandOutput. Verbs and words are case-insensitive.
+ */
+class CommandRegistry {
+public:
+    CommandRegistry(const CommandSpec* table, size_t count, void* context = nullptr);
+
+    /**
+     * Parse and run one command line. The line is modified in place.
+     */
+    CommandResult execute(char* line, ICommandOutput* out);
+
+    // Binary search for an upper-case verb; nullptr if unknown
+    const CommandSpec* find(const char* name) const;
+
+    // One line per command, or just the named command
+    void printHelp(ICommandOutput* out, const char* name = nullptr) const;
+
+private:
+    const CommandSpec* table;
+    size_t count;
+    void* context;
+
+    bool parseArgs(const CommandSpec* spec, char** tokens, size_t tokenCount, CommandArgs* args, ICommandOutput* out) const;
+    void printUsage(const CommandSpec* spec, ICommandOutput* out) const;
+    void printHelpLine(const CommandSpec* spec, ICommandOutput* out) const;
+};
+
+#endif
@@ -0,0 +1,68 @@
+// src/EspCutoffTimer.h
+#ifndef ESP_CUTOFF_TIMER_H
+#define ESP_CUTOFF_TIMER_H
+
+#include "ICutoffTimer.h"
+#include "IRelayController.h"
+#include <esp_timer.h>
+
+/**
+ * ICutoffTimer backed by a one-shot esp_timer.
+ * The callback runs in the esp_timer task and switches the relay off at the
+ * exact deadline, even if loop() is blocked (WiFi, flash writes, etc.).
+ */
+class EspCutoffTimer : public ICutoffTimer {
+public:
+    EspCutoffTimer(IRelayController* relayController)
+        : relayController(relayController), timer(nullptr), fired(false) {
+    }
+
+    ~EspCutoffTimer() {
+        if (timer) {
+            esp_timer_stop(timer);
+            esp_timer_delete(timer);
+        }
+    }
+
+    bool arm(unsigned long durationMs) override {
+        // Created lazily so construction is safe before the esp_timer service starts
+        if (!timer) {
+            esp_timer_create_args_t args = {};
+            args.callback = &EspCutoffTimer::onTimer;
+            args.arg = this;
+            args.dispatch_method = ESP_TIMER_TASK;
+            args.name = "mist_cutoff";
+            if (esp_timer_create(&args, &timer) != ESP_OK) {
+                timer = nullptr;
+                return false;
+            }
+        }
+
+        esp_timer_stop(timer);  // Ignore error if not running
+        fired = false;
+        return esp_timer_start_once(timer, (uint64_t)durationMs * 1000ULL) == ESP_OK;
+    }
+
+    void cancel() override {
+        if (timer) {
+            esp_timer_stop(timer);
+        }
+    }
+
+    bool hasFired() const override {
+        return fired;
+    }
+
+private:
+    IRelayController* relayController;
+    esp_timer_handle_t timer;
+    volatile bool fired;
+
+    static void onTimer(void* arg) {
+        EspCutoffTimer* self = static_cast<EspCutoffTimer*>(arg);
+        self->relayController->turnOff();
+        self->fired = true;
+    }
+};
+
+#endif
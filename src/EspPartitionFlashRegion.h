@@ -0,0 +1,54 @@
+// src/EspPartitionFlashRegion.h
+#ifndef ESP_PARTITION_FLASH_REGION_H
+#define ESP_PARTITION_FLASH_REGION_H
+
+#include "IFlashRegion.h"
+#include <esp_partition.h>
+
+/**
+ * IFlashRegion backed by a data partition from partitions.csv.
+ * The partition is looked up lazily so construction is safe as a global.
+ */
+class EspPartitionFlashRegion : public IFlashRegion {
+public:
+    static const esp_partition_subtype_t MIST_LOG_SUBTYPE = (esp_partition_subtype_t)0x40;
+
+    EspPartitionFlashRegion(const char* label) : label(label), partition(nullptr) {}
+
+    size_t getSize() const override {
+        const esp_partition_t* p = find();
+        return p ? p->size : 0;
+    }
+
+    size_t getSectorSize() const override {
+        return SPI_FLASH_SEC_SIZE;
+    }
+
+    bool read(size_t offset, void* data, size_t length) override {
+        const esp_partition_t* p = find();
+        return p && esp_partition_read(p, offset, data, length) == ESP_OK;
+    }
+
+    bool write(size_t offset, const void* data, size_t length) override {
+        const esp_partition_t* p = find();
+        return p && esp_partition_write(p, offset, data, length) == ESP_OK;
+    }
+
+    bool eraseSector(size_t sector) override {
+        const esp_partition_t* p = find();
+        return p && esp_partition_erase_range(p, sector * SPI_FLASH_SEC_SIZE, SPI_FLASH_SEC_SIZE) == ESP_OK;
+    }
+
+private:
+    const char* label;
+    mutable const esp_partition_t* partition;
+
+    const esp_partition_t* find() const {
+        if (!partition) {
+            partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, MIST_LOG_SUBTYPE, label);
+        }
+        return partition;
+    }
+};
+
+#endif
@@ -0,0 +1,66 @@
+// src/FreeRTOSWorkerTask.h
+#ifndef FREERTOS_WORKER_TASK_H
+#define FREERTOS_WORKER_TASK_H
+
+#include "IWorkerTask.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/**
+ * IWorkerTask backed by a FreeRTOS task that sleeps on its notification
+ * value, so wakes from the loop task are cheap and coalesce.
+ */
+class FreeRTOSWorkerTask : public IWorkerTask {
+public:
+    FreeRTOSWorkerTask(const char* name, UBaseType_t priority, uint32_t stackSize)
+        : name(name), priority(priority), stackSize(stackSize), handle(nullptr), body(nullptr), arg(nullptr) {
+    }
+
+    ~FreeRTOSWorkerTask() {
+        stop();
+    }
+
+    bool start(WorkFunction workBody, void* workArg) override {
+        if (handle) {
+            return true;
+        }
+        body = workBody;
+        arg = workArg;
+        return xTaskCreate(&FreeRTOSWorkerTask::taskMain, name, stackSize, this, priority, &handle) == pdPASS;
+    }
+
+    void wake() override {
+        if (handle) {
+            xTaskNotifyGive(handle);
+        }
+    }
+
+    void stop() override {
+        if (handle) {
+            vTaskDelete(handle);
+            handle = nullptr;
+        }
+    }
+
+    void sleepMs(unsigned long ms) override {
+        vTaskDelay(pdMS_TO_TICKS(ms) > 0 ? pdMS_TO_TICKS(ms) : 1);
+    }
+
+private:
+    const char* name;
+    UBaseType_t priority;
+    uint32_t stackSize;
+    TaskHandle_t handle;
+    WorkFunction body;
+    void* arg;
+
+    static void taskMain(void* param) {
+        FreeRTOSWorkerTask* self = static_cast<FreeRTOSWorkerTask*>(param);
+        for (;;) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            self->body(self->arg);
+        }
+    }
+};
+
+#endif
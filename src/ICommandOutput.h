@@ -0,0 +1,16 @@
+// src/ICommandOutput.h
+#ifndef I_COMMAND_OUTPUT_H
+#define I_COMMAND_OUTPUT_H
+
+/**
+ * Where command replies go (serial port, network socket, test capture).
+ */
+class ICommandOutput {
+public:
+    virtual ~ICommandOutput() = default;
+
+    // Write one reply line (no terminator)
+    virtual void println(const char* line) = 0;
+};
+
+#endif
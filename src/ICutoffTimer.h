@@ -0,0 +1,33 @@
+// src/ICutoffTimer.h
+#ifndef I_CUTOFF_TIMER_H
+#define I_CUTOFF_TIMER_H
+
+/**
+ * Interface for a one-shot relay cut-off timer.
+ * Implementations turn the relay off at the deadline on their own,
+ * independent of main loop latency. The scheduler only does the
+ * bookkeeping (state, persistence) on its next update().
+ */
+class ICutoffTimer {
+public:
+    virtual ~ICutoffTimer() = default;
+
+    /**
+     * Arm the timer to cut the relay off after durationMs.
+     * Re-arming replaces any pending deadline.
+     * @return true if the timer was armed, false on error
+     */
+    virtual bool arm(unsigned long durationMs) = 0;
+
+    /**
+     * Cancel a pending cut-off. Safe to call when not armed or already fired.
+     */
+    virtual void cancel() = 0;
+
+    /**
+     * Check whether the timer has cut the relay off since it was last armed.
+     */
+    virtual bool hasFired() const = 0;
+};
+
+#endif
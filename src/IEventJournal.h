@@ -0,0 +1,44 @@
+// src/IEventJournal.h
+#ifndef I_EVENT_JOURNAL_H
+#define I_EVENT_JOURNAL_H
+
+#include <stdint.h>
+
+// What started a mist cycle
+enum MistTrigger {
+  MIST_TRIGGER_SCHEDULE = 0,  // Interval/window schedule
+  MIST_TRIGGER_FORCE = 1      // FORCE_MIST command
+};
+
+// How a mist cycle ended
+enum MistOutcome {
+  MIST_OUTCOME_COMPLETED = 0,  // Stopped at the configured duration
+  MIST_OUTCOME_FAILSAFE = 1    // Stopped by the 3x duration safety limit
+};
+
+/**
+ * Interface for an append-only history of mist cycles.
+ * Optional: the scheduler works without one.
+ */
+class IEventJournal {
+public:
+    virtual ~IEventJournal() = default;
+
+    /**
+     * Append one completed mist cycle.
+     * @param startEpoch Epoch seconds when the mist started
+     * @param durationMs Actual relay-on time in milliseconds
+     * @param trigger What started the cycle
+     * @param outcome How the cycle ended
+     * @return true if the record was stored
+     */
+    virtual bool recordMist(uint32_t startEpoch, uint32_t durationMs, MistTrigger trigger, MistOutcome outcome) = 0;
+
+    /**
+     * Start time of the newest stored cycle.
+     * @return false if the journal is empty or cannot be read back
+     */
+    virtual bool getNewestStartEpoch(uint32_t* startEpoch) { return false; }
+};
+
+#endif
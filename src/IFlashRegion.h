@@ -0,0 +1,46 @@
+// src/IFlashRegion.h
+#ifndef I_FLASH_REGION_H
+#define I_FLASH_REGION_H
+
+#include <stddef.h>
+
+/**
+ * Interface for a raw region of NOR flash (e.g. a data partition).
+ * Erased bytes read as 0xFF; write() can only clear bits, so a location must
+ * be erased (whole sector) before it is written again.
+ */
+class IFlashRegion {
+public:
+    virtual ~IFlashRegion() = default;
+
+    /**
+     * @return Region size in bytes (a multiple of the sector size), 0 if unavailable
+     */
+    virtual size_t getSize() const = 0;
+
+    /**
+     * @return Erase granularity in bytes
+     */
+    virtual size_t getSectorSize() const = 0;
+
+    /**
+     * Read bytes from the region.
+     * @return true on success
+     */
+    virtual bool read(size_t offset, void* data, size_t length) = 0;
+
+    /**
+     * Program bytes into previously erased flash.
+     * @return true on success
+     */
+    virtual bool write(size_t offset, const void* data, size_t length) = 0;
+
+    /**
+     * Erase one sector (all bytes become 0xFF).
+     * @param sector Sector index within the region
+     * @return true on success
+     */
+    virtual bool eraseSector(size_t sector) = 0;
+};
+
+#endif
@@ -0,0 +1,34 @@
+// src/INetworkDriver.h
+#ifndef I_NETWORK_DRIVER_H
+#define I_NETWORK_DRIVER_H
+
+#include "NetworkCache.h"
+
+/**
+ * Interface for the network link and time sync hardware.
+ * All methods must return immediately; waiting is done by the caller
+ * (WiFiConnectionManager) across loop iterations.
+ */
+class INetworkDriver {
+public:
+    virtual ~INetworkDriver() = default;
+
+    // Start a connection attempt to the configured access point (non-blocking).
+    // Uses a full channel scan and DHCP.
+    virtual void beginConnect() = 0;
+
+    // Start a connection attempt directly to a cached BSSID/channel, skipping
+    // the scan; applies the cached IP lease as static config if present
+    virtual void beginConnectFast(const NetworkCache& cache) = 0;
+
+    // Read the current association parameters (valid only while connected)
+    virtual bool getConnectionInfo(NetworkCache* cache) = 0;
+
+    // Returns true if the link is up and has an IP address
+    virtual bool isConnected() = 0;
+
+    // (Re)start NTP time synchronization (non-blocking)
+    virtual void startTimeSync() = 0;
+};
+
+#endif
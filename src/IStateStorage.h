@@ -2,6 +2,9 @@
 #ifndef I_STATE_STORAGE_H
 #define I_STATE_STORAGE_H
 
+#include <stddef.h>
+#include "NetworkCache.h"
+
 /**
  * Interface for persistent state storage.
  * Abstracts the storage mechanism (NVS, EEPROM, in-memory, etc.)
@@ -37,6 +40,72 @@ public:
      * @return true if save succeeded, false on error
      */
     virtual bool save(unsigned long lastMistTime, bool hasEverMisted, bool enabled) = 0;
+
+    /**
+     * Load all scheduler state in one batch. Implementations backed by slow
+     * storage should override this to read a single record; the default
+     * falls back to the individual getters.
+     * @param lastMistTime Receives the last misting time (0 if none)
+     * @param hasEverMisted Receives whether any misting cycle has occurred
+     * @param enabled Receives whether automatic misting is enabled
+     * @return true if stored state was found, false if defaults were returned
+     */
+    virtual bool load(unsigned long* lastMistTime, bool* hasEverMisted, bool* enabled) {
+        *lastMistTime = getLastMistTime();
+        *hasEverMisted = getHasEverMisted();
+        *enabled = getEnabled();
+        return *hasEverMisted || *lastMistTime != 0;
+    }
+
+    /**
+     * Load the cached WiFi association (BSSID, channel, optional IP lease).
+     * Optional: storage without network cache support returns false.
+     * @param cache Filled with the cached parameters on success
+     * @return true if a valid cache was loaded
+     */
+    virtual bool loadNetworkCache(NetworkCache* cache) { return false; }
+
+    /**
+     * Save the WiFi association parameters for the next fast connect.
+     * @param cache Parameters of the last successful connection
+     * @return true if save succeeded, false on error or if unsupported
+     */
+    virtual bool saveNetworkCache(const NetworkCache& cache) { return false; }
+
+    /**
+     * Load the multi-zone state record written by saveZoneState().
+     * Optional: storage without zone state support returns false.
+     * @param record Buffer receiving the record
+     * @param length Expected record size in bytes
+     * @return true if a record of exactly length bytes was loaded
+     */
+    virtual bool loadZoneState(void* record, size_t length) { return false; }
+
+    /**
+     * Save the multi-zone state record as a single write.
+     * @param record Record bytes
+     * @param length Record size in bytes
+     * @return true if save succeeded, false on error or if unsupported
+     */
+    virtual bool saveZoneState(const void* record, size_t length) { return false; }
+
+    /**
+     * Load the schedule configuration record (see ScheduleConfigRecord).
+     * Optional: storage without config support returns false and the
+     * compiled-in defaults are used.
+     * @param record Buffer receiving the record
+     * @param length Expected record size in bytes
+     * @return true if a record of exactly length bytes was loaded
+     */
+    virtual bool loadScheduleConfig(void* record, size_t length) { return false; }
+
+    /**
+     * Save the schedule configuration record as a single write.
+     * @param record Record bytes
+     * @param length Record size in bytes
+     * @return true if save succeeded, false on error or if unsupported
+     */
+    virtual bool saveScheduleConfig(const void* record, size_t length) { return false; }
 };
 
 #endif
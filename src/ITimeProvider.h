@@ -4,6 +4,14 @@
 
 #include <time.h>
 
+// One consistent reading of all clocks, taken once per scheduler tick
+struct TimeSnapshot {
+    time_t epoch;           // Unix epoch seconds (0 if not available)
+    unsigned long millis;   // millis() at the time of the snapshot
+    struct tm local;        // Broken-down local time (valid only if localValid)
+    bool localValid;
+};
+
 class ITimeProvider {
 public:
     virtual ~ITimeProvider() = default;
@@ -16,6 +24,16 @@ public:
 
     // Returns current Unix epoch time in seconds (0 if not available)
     virtual time_t getEpochTime() = 0;
+
+    // Fills all fields from a single reading so they cannot disagree across a
+    // second boundary. Returns localValid. Providers with a cheaper combined
+    // path (see NTPTimeProvider) override this.
+    virtual bool getSnapshot(TimeSnapshot* snapshot) {
+        snapshot->millis = getMillis();
+        snapshot->epoch = getEpochTime();
+        snapshot->localValid = getTime(&snapshot->local);
+        return snapshot->localValid;
+    }
 };
 
 #endif
@@ -0,0 +1,38 @@
+// src/IWorkerTask.h
+#ifndef I_WORKER_TASK_H
+#define I_WORKER_TASK_H
+
+/**
+ * Interface for a background worker that runs a body function each time it
+ * is woken. Abstracts FreeRTOS tasks (target) and std::thread (native tests).
+ */
+class IWorkerTask {
+public:
+    typedef void (*WorkFunction)(void* arg);
+
+    virtual ~IWorkerTask() = default;
+
+    /**
+     * Start the worker. body(arg) runs on the worker after every wake().
+     * @return true if the worker is running
+     */
+    virtual bool start(WorkFunction body, void* arg) = 0;
+
+    /**
+     * Request one run of the body. Wakes coalesce while the body is busy.
+     * Safe to call from any task.
+     */
+    virtual void wake() = 0;
+
+    /**
+     * Stop the worker after the current run, if any.
+     */
+    virtual void stop() = 0;
+
+    /**
+     * Block the calling task for about ms milliseconds (used by barriers).
+     */
+    virtual void sleepMs(unsigned long ms) = 0;
+};
+
+#endif
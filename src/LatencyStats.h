@@ -0,0 +1,30 @@
+// src/LatencyStats.h
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <stdint.h>
+
+/**
+ * Running count / last / max / mean of a latency in microseconds.
+ */
+struct LatencyStats {
+    uint32_t count;
+    uint32_t lastUs;
+    uint32_t maxUs;
+    uint64_t totalUs;
+
+    LatencyStats() : count(0), lastUs(0), maxUs(0), totalUs(0) {}
+
+    void record(uint32_t us) {
+        count++;
+        lastUs = us;
+        if (us > maxUs) {
+            maxUs = us;
+        }
+        totalUs += us;
+    }
+
+    uint32_t getMeanUs() const { return count ? (uint32_t)(totalUs / count) : 0; }
+};
+
+#endif
@@ -0,0 +1,37 @@
+// src/LineAssembler.cpp
+#include "LineAssembler.h"
+
+LineAssembler::LineAssembler() {
+    reset();
+}
+
+LineStatus LineAssembler::push(char c) {
+    if (c == '\n' || c == '\r') {
+        if (discarding) {
+            reset();
+            return LINE_TOO_LONG;
+        }
+        if (length == 0) {
+            return LINE_NONE;  // Empty line, or the LF of a CRLF
+        }
+        buffer[length] = '\0';
+        length = 0;
+        return LINE_READY;
+    }
+
+    if (discarding) {
+        return LINE_NONE;
+    }
+    if (length >= MAX_LINE - 1) {
+        discarding = true;
+        return LINE_NONE;
+    }
+    buffer[length++] = c;
+    return LINE_NONE;
+}
+
+void LineAssembler::reset() {
+    length = 0;
+    discarding = false;
+    buffer[0] = '\0';
+}
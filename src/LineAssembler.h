@@ -0,0 +1,38 @@
+// src/LineAssembler.h
+#ifndef LINE_ASSEMBLER_H
+#define LINE_ASSEMBLER_H
+
+#include <stddef.h>
+
+enum LineStatus {
+    LINE_NONE,      // Byte consumed, line not complete yet
+    LINE_READY,     // Terminator received: getLine() holds the command
+    LINE_TOO_LONG   // Terminator received after an overlong line (discarded)
+};
+
+/**
+ * Assembles serial command lines one byte at a time, so a command split
+ * across several reads (or loop passes) is dispatched whole, exactly when
+ * its terminator arrives. CR, LF and CRLF all end a line; empty lines are
+ * ignored.
+ */
+class LineAssembler {
+public:
+    static const size_t MAX_LINE = 64;  // Including the terminating NUL
+
+    LineAssembler();
+
+    LineStatus push(char c);
+
+    // Completed line; valid after LINE_READY until the next push()
+    const char* getLine() const { return buffer; }
+
+    void reset();
+
+private:
+    char buffer[MAX_LINE];
+    size_t length;
+    bool discarding;  // Line overflowed; drop bytes until the terminator
+};
+
+#endif
@@ -0,0 +1,56 @@
+// src/LocalTimeCache.h
+#ifndef LOCAL_TIME_CACHE_H
+#define LOCAL_TIME_CACHE_H
+
+#include <time.h>
+#include "PosixTimeZone.h"
+
+/**
+ * Caches the epoch -> local time conversion (localtime_r with TZ rules).
+ * UTC offset changes always fall on a whole minute, so within the cached
+ * minute only tm_sec differs and no conversion is needed. The full
+ * conversion runs once per minute at most, or after a clock jump.
+ * With a PosixTimeZone set, conversions use its precomputed transition
+ * table instead of libc's localtime_r.
+ */
+class LocalTimeCache {
+public:
+    LocalTimeCache() : timeZone(nullptr), minuteStart(0), valid(false), conversions(0) {}
+
+    // Use a parsed time zone instead of libc TZ handling (nullptr = libc)
+    void setTimeZone(PosixTimeZone* zone) {
+        timeZone = zone;
+        valid = false;
+    }
+
+    // Convert epoch to broken-down local time
+    void toLocal(time_t epoch, struct tm* out) {
+        time_t start = epoch - (epoch % 60);
+        if (!valid || start != minuteStart) {
+            if (timeZone) {
+                timeZone->toLocal(start, &cached);
+            } else {
+                localtime_r(&start, &cached);
+            }
+            minuteStart = start;
+            valid = true;
+            conversions++;
+        }
+        *out = cached;
+        out->tm_sec = (int)(epoch - start);
+    }
+
+    // Drop the cached conversion (e.g. after the TZ rules change)
+    void invalidate() { valid = false; }
+
+    unsigned long getConversionCount() const { return conversions; }
+
+private:
+    PosixTimeZone* timeZone;
+    time_t minuteStart;  // Epoch of the start of the cached minute
+    struct tm cached;    // Local time at minuteStart
+    bool valid;
+    unsigned long conversions;
+};
+
+#endif
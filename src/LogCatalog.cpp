@@ -0,0 +1,34 @@
+// src/LogCatalog.cpp
+#include "LogCatalog.h"
+
+#define LOG_CATALOG_TYPES(name, types, format) types,
+static const char* const ARG_TYPES[LOG_MSG_COUNT] = {
+    LOG_MESSAGES(LOG_CATALOG_TYPES)
+};
+#undef LOG_CATALOG_TYPES
+
+const char* logArgTypes(uint8_t id) {
+    return (id < LOG_MSG_COUNT) ? ARG_TYPES[id] : "";
+}
+
+#if !BINARY_LOG
+#define LOG_CATALOG_FORMAT(name, types, format) format,
+static const char* const FORMATS[LOG_MSG_COUNT] = {
+    LOG_MESSAGES(LOG_CATALOG_FORMAT)
+};
+#undef LOG_CATALOG_FORMAT
+
+#define LOG_CATALOG_STRING(name, text) text,
+static const char* const STRINGS[LOG_STR_COUNT] = {
+    LOG_STRINGS(LOG_CATALOG_STRING)
+};
+#undef LOG_CATALOG_STRING
+
+const char* logFormat(uint8_t id) {
+    return (id < LOG_MSG_COUNT) ? FORMATS[id] : "?";
+}
+
+const char* logString(uint8_t id) {
+    return (id < LOG_STR_COUNT) ? STRINGS[id] : "?";
+}
+#endif
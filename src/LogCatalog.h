@@ -0,0 +1,127 @@
+// src/LogCatalog.h
+#ifndef LOG_CATALOG_H
+#define LOG_CATALOG_H
+
+#include <stdint.h>
+
+// Binary log mode: format strings are compiled out and log events are sent as
+// compact records decoded on the host (tools/decode_log.py). Must be set for
+// the whole build (build_flags = -DBINARY_LOG=1), not per file.
+#ifndef BINARY_LOG
+#define BINARY_LOG 0
+#endif
+
+/**
+ * Catalog of structured log messages: X(NAME, ARG_TYPES, FORMAT).
+ *
+ * ARG_TYPES has one character per argument, matching the conversions in
+ * FORMAT:
+ *   'i'  signed 32-bit     (%ld)
+ *   'u'  unsigned 32-bit   (%lu)
+ *   's'  LogStringId index (%s), see LOG_STRINGS
+ *   't'  free text         (%s), TEXT records only
+ *
+ * IDs are positions in this list and are part of the wire format: append new
+ * messages at the end and never reorder or reuse entries. The host decoder
+ * reads this file directly, so keep one entry per line.
+ */
+#define LOG_MESSAGES(X) \
+    X(TEXT,                     "t",   "%s") \
+    X(TIME_BASE,                "u",   "time base %lu") \
+    X(TIME_JUMP,                "i",   "WARNING: Time jump detected: %ld seconds") \
+    X(MIST_FAILSAFE,            "",    "CRITICAL: Mist duration exceeded safety limit, forcing stop") \
+    X(CUTOFF_ARM_FAILED,        "",    "WARNING: Cut-off timer arm failed, relying on loop timing") \
+    X(MIST_START,               "",    "MIST START") \
+    X(MIST_STOP,                "",    "MIST STOP") \
+    X(JOURNAL_APPEND_FAILED,    "",    "WARNING: Mist journal append failed") \
+    X(STATE_LOADED,             "",    "Loaded state from NVS") \
+    X(ENABLED_IDLE,             "",    "Scheduler ENABLED (transitioned to IDLE)") \
+    X(ENABLED_WAITING_SYNC,     "",    "Scheduler ENABLED (waiting for time sync)") \
+    X(ENABLED,                  "",    "Scheduler ENABLED") \
+    X(DISABLED,                 "",    "Scheduler DISABLED") \
+    X(FORCE_ALREADY_MISTING,    "",    "ERROR: Already misting, cannot force") \
+    X(FORCE_DISABLED,           "",    "ERROR: Scheduler disabled, cannot force mist") \
+    X(FORCE_MIST,               "",    "FORCE MIST") \
+    X(STATUS_STATE,             "sss", "STATUS: state=%s enabled=%s hasEverMisted=%s") \
+    X(STATUS_SAVES,             "uus", "STATUS: saves requested=%lu written=%lu%s") \
+    X(STATUS_LAST_MIST,         "ii",  "STATUS: lastMist=%ldh %ldm ago") \
+    X(STATUS_LAST_MIST_NEVER,   "",    "STATUS: lastMist=never") \
+    X(STATUS_NEXT_MIST,         "ii",  "STATUS: nextMist=in %ldh %ldm") \
+    X(STATUS_NEXT_MIST_WINDOW,  "",    "STATUS: nextMist=waiting for active window") \
+    X(BOOT_STAGE_DONE,          "suu", "BOOT: %s done in %lums (t=%lums)") \
+    X(BOOT_READY,               "u",   "BOOT: ready in %lums") \
+    X(WIFI_DISCONNECTED,        "",    "WARNING: WiFi disconnected, attempting reconnect") \
+    X(WIFI_FAST_CONNECT_FAILED, "",    "WARNING: Fast WiFi connect failed, falling back to full scan") \
+    X(WIFI_CONNECTED,           "us",  "WiFi connected in %lums (%s)") \
+    X(WIFI_RETRY,               "u",   "ERROR: WiFi reconnection failed, retry in %lus") \
+    X(JOURNAL_UNAVAILABLE,      "",    "JOURNAL: Flash region unavailable") \
+    X(JOURNAL_EMPTY,            "",    "JOURNAL: Empty") \
+    X(JOURNAL_HEAD,             "uuuu", "JOURNAL: Head at sector %lu slot %lu, next seq %lu (%lu reads)") \
+    X(JOURNAL_ERASE_FAILED,     "",    "JOURNAL: Sector erase failed") \
+    X(JOURNAL_WRITE_FAILED,     "",    "JOURNAL: Record write failed") \
+    X(CONFIG_LOADED,            "",    "Loaded schedule config") \
+    X(CONFIG_CHANGED,           "uu",  "CONFIG: interval=%lus mist=%lums") \
+    X(CONFIG_SAVE_FAILED,       "",    "WARNING: Schedule config save failed") \
+    X(STATUS_CONFIG,            "uu",  "STATUS: interval=%lus mist=%lums") \
+    X(ZONE_TABLE_FULL,          "",    "ERROR: Zone table full") \
+    X(ZONE_INVALID_CONFIG,      "",    "ERROR: Invalid zone config") \
+    X(ZONE_NOT_FOUND,           "",    "ERROR: No such zone") \
+    X(ZONE_CUTOFF_ARM_FAILED,   "u",   "ZONE %lu: WARNING: Cut-off timer arm failed, relying on loop timing") \
+    X(ZONE_MIST_START,          "u",   "ZONE %lu: MIST START") \
+    X(ZONE_MIST_STOP,           "u",   "ZONE %lu: MIST STOP") \
+    X(ZONE_MIST_FAILSAFE,       "u",   "ZONE %lu: CRITICAL: Mist duration exceeded safety limit, forcing stop") \
+    X(ZONE_ENABLED,             "u",   "ZONE %lu: ENABLED") \
+    X(ZONE_DISABLED,            "u",   "ZONE %lu: DISABLED") \
+    X(ZONE_FORCE_ALREADY_MISTING, "u", "ZONE %lu: ERROR: Already misting, cannot force") \
+    X(ZONE_FORCE_DISABLED,      "u",   "ZONE %lu: ERROR: Zone disabled, cannot force mist") \
+    X(ZONE_FORCE_MIST,          "u",   "ZONE %lu: FORCE MIST") \
+    X(ZONE_STATE_IGNORED,       "",    "WARNING: Ignoring corrupt or incompatible zone state record") \
+    X(ZONE_STATE_LOADED,        "u",   "Loaded state for %lu zones") \
+    X(ZONE_STATE_SAVE_FAILED,   "",    "ERROR: Zone state save failed")
+
+/**
+ * Fixed strings passed as 's' arguments, sent as a one-byte index.
+ * Same wire-format rules as LOG_MESSAGES.
+ */
+#define LOG_STRINGS(X) \
+    X(EMPTY,          "") \
+    X(FALSE,          "false") \
+    X(TRUE,           "true") \
+    X(WAITING_SYNC,   "WAITING_SYNC") \
+    X(IDLE,           "IDLE") \
+    X(MISTING,        "MISTING") \
+    X(PENDING,        " (pending)") \
+    X(STATE_LOAD,     "state load") \
+    X(NETWORK,        "network") \
+    X(TIME_SYNC,      "time sync") \
+    X(CACHED_BSSID,   "cached BSSID") \
+    X(FULL_SCAN,      "full scan") \
+    X(AUTO_RECONNECT, "auto-reconnect")
+
+#define LOG_CATALOG_ENUM(name, ...) LOG_MSG_##name,
+enum LogMessageId {
+    LOG_MESSAGES(LOG_CATALOG_ENUM)
+    LOG_MSG_COUNT
+};
+#undef LOG_CATALOG_ENUM
+
+#define LOG_CATALOG_ENUM(name, ...) LOG_STR_##name,
+enum LogStringId {
+    LOG_STRINGS(LOG_CATALOG_ENUM)
+    LOG_STR_COUNT
+};
+#undef LOG_CATALOG_ENUM
+
+// Most arguments any catalog message takes
+static const uint8_t LOG_EVENT_MAX_ARGS = 4;
+
+// Argument types of a message (kept in binary builds: the encoder needs them)
+const char* logArgTypes(uint8_t id);
+
+#if !BINARY_LOG
+// Text for a message or string ID; text builds only
+const char* logFormat(uint8_t id);
+const char* logString(uint8_t id);
+#endif
+
+#endif
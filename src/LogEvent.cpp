@@ -0,0 +1,103 @@
+// src/LogEvent.cpp
+#include "LogEvent.h"
+#include <stdio.h>
+#include <string.h>
+
+// Append one snprintf result, keeping the running length inside the buffer
+static void advance(size_t* length, int written, size_t size) {
+    if (written < 0) {
+        return;
+    }
+    *length += (size_t)written;
+    if (*length > size - 1) {
+        *length = size - 1;
+    }
+}
+
+size_t formatLogEvent(const LogEvent& event, char* buffer, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+
+    const char* types = logArgTypes(event.id);
+    size_t length = 0;
+
+#if BINARY_LOG
+    advance(&length, snprintf(buffer, size, "EVENT %u:", (unsigned)event.id), size);
+    for (uint8_t arg = 0; types[arg] && arg < LOG_EVENT_MAX_ARGS && length < size - 1; arg++) {
+        advance(&length, snprintf(buffer + length, size - length, " %ld", (long)event.args[arg]), size);
+    }
+#else
+    // Substitute arguments one conversion at a time, by catalog type
+    const char* format = logFormat(event.id);
+    uint8_t arg = 0;
+    while (*format && length < size - 1) {
+        if (*format != '%') {
+            buffer[length++] = *format++;
+            continue;
+        }
+        if (format[1] == '%') {
+            buffer[length++] = '%';
+            format += 2;
+            continue;
+        }
+
+        char spec[8];
+        size_t specLength = 0;
+        spec[specLength++] = *format++;
+        while (*format && !strchr("diuxs", *format) && specLength < sizeof(spec) - 2) {
+            spec[specLength++] = *format++;
+        }
+        if (!*format) {
+            break;
+        }
+        spec[specLength++] = *format++;
+        spec[specLength] = '\0';
+
+        char type = (arg < LOG_EVENT_MAX_ARGS) ? types[arg] : '\0';
+        int32_t value = type ? event.args[arg++] : 0;
+        char* out = buffer + length;
+        size_t room = size - length;
+        switch (type) {
+            case 'i':
+                advance(&length, snprintf(out, room, spec, (long)value), size);
+                break;
+            case 'u':
+                advance(&length, snprintf(out, room, spec, (unsigned long)(uint32_t)value), size);
+                break;
+            case 's':
+                advance(&length, snprintf(out, room, spec, logString((uint8_t)value)), size);
+                break;
+            default:
+                advance(&length, snprintf(out, room, "?"), size);
+                break;
+        }
+    }
+    buffer[length] = '\0';
+#endif
+    return length;
+}
+
+void emitLogEvent(LogEventCallback eventLogger, LogCallback logger, uint8_t id,
+                  int32_t arg0, int32_t arg1, int32_t arg2, int32_t arg3) {
+    if (!eventLogger && !logger) {
+        return;
+    }
+
+    LogEvent event;
+    event.id = id;
+    event.args[0] = arg0;
+    event.args[1] = arg1;
+    event.args[2] = arg2;
+    event.args[3] = arg3;
+
+    if (eventLogger) {
+        eventLogger(event);
+        return;
+    }
+
+    char buffer[96];
+    formatLogEvent(event, buffer, sizeof(buffer));
+    logger(buffer);
+}
@@ -0,0 +1,38 @@
+// src/LogEvent.h
+#ifndef LOG_EVENT_H
+#define LOG_EVENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "LogCatalog.h"
+
+// Logging callback type (same as MistingScheduler)
+typedef void (*LogCallback)(const char* message);
+
+/**
+ * A catalog message ID plus its raw arguments, not yet formatted.
+ * Arguments are interpreted per logArgTypes(id); unused slots are 0.
+ */
+struct LogEvent {
+    uint8_t id;  // LogMessageId
+    int32_t args[LOG_EVENT_MAX_ARGS];
+};
+
+// Structured logging callback: receives events instead of formatted text
+typedef void (*LogEventCallback)(const LogEvent& event);
+
+/**
+ * Format an event as the text line it stands for. Binary builds have no
+ * format strings and produce "EVENT <id>: <args>" instead.
+ * @return Length written (excluding the terminator), truncated to fit
+ */
+size_t formatLogEvent(const LogEvent& event, char* buffer, size_t size);
+
+/**
+ * Deliver a catalog message: as an event if an event logger is installed
+ * (formatting deferred to the sink), otherwise formatted to the text logger.
+ */
+void emitLogEvent(LogEventCallback eventLogger, LogCallback logger, uint8_t id,
+                  int32_t arg0 = 0, int32_t arg1 = 0, int32_t arg2 = 0, int32_t arg3 = 0);
+
+#endif
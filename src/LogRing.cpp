@@ -0,0 +1,101 @@
+// src/LogRing.cpp
+#include "LogRing.h"
+#include <string.h>
+
+LogRing::LogRing()
+    : enqueuePos(0), dequeuePos(0), pushedCount(0), droppedCount(0), maxDepth(0) {
+    for (size_t i = 0; i < CAPACITY; i++) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool LogRing::push(const char* message, unsigned long millis, time_t epoch) {
+    size_t pos;
+    Cell* cell = claim(&pos);
+    if (!cell) {
+        return false;
+    }
+
+    cell->entry.millis = millis;
+    cell->entry.epoch = epoch;
+    cell->entry.event.id = LOG_MSG_TEXT;
+    strncpy(cell->entry.text, message, LogEntry::MESSAGE_MAX - 1);
+    cell->entry.text[LogEntry::MESSAGE_MAX - 1] = '\0';
+    publish(pos);
+    return true;
+}
+
+bool LogRing::push(const LogEvent& event, unsigned long millis, time_t epoch) {
+    size_t pos;
+    Cell* cell = claim(&pos);
+    if (!cell) {
+        return false;
+    }
+
+    cell->entry.millis = millis;
+    cell->entry.epoch = epoch;
+    cell->entry.event = event;
+    cell->entry.text[0] = '\0';
+    publish(pos);
+    return true;
+}
+
+LogRing::Cell* LogRing::claim(size_t* pos) {
+    size_t claimed = enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell* cell = &cells[claimed & MASK];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        long diff = (long)(sequence - claimed);  // Wrap-safe
+        if (diff == 0) {
+            // Slot free for this position: claim it
+            if (enqueuePos.compare_exchange_weak(claimed, claimed + 1, std::memory_order_relaxed)) {
+                *pos = claimed;
+                return cell;
+            }
+        } else if (diff < 0) {
+            // Consumer has not freed this slot yet: full
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        } else {
+            claimed = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void LogRing::publish(size_t pos) {
+    cells[pos & MASK].sequence.store(pos + 1, std::memory_order_release);
+
+    pushedCount.fetch_add(1, std::memory_order_relaxed);
+
+    // High-water mark (the consumer may already be past this entry)
+    long depth = (long)(pos + 1 - dequeuePos.load(std::memory_order_relaxed));
+    size_t seen = maxDepth.load(std::memory_order_relaxed);
+    while (depth > (long)seen && !maxDepth.compare_exchange_weak(seen, (size_t)depth, std::memory_order_relaxed)) {
+    }
+}
+
+bool LogRing::peek(LogEntry* entry) {
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell* cell = &cells[pos & MASK];
+    // Empty, or the producer that claimed this slot is still copying
+    if (cell->sequence.load(std::memory_order_acquire) != pos + 1) {
+        return false;
+    }
+    *entry = cell->entry;
+    return true;
+}
+
+void LogRing::pop() {
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell* cell = &cells[pos & MASK];
+    if (cell->sequence.load(std::memory_order_acquire) != pos + 1) {
+        return;
+    }
+    // Hand the slot back to producers one lap ahead
+    cell->sequence.store(pos + CAPACITY, std::memory_order_release);
+    dequeuePos.store(pos + 1, std::memory_order_relaxed);
+}
+
+size_t LogRing::getDepth() const {
+    return enqueuePos.load(std::memory_order_relaxed) - dequeuePos.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,90 @@
+// src/LogRing.h
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "LogEvent.h"
+
+/**
+ * One queued log message with the time it was produced: either plain text
+ * (event.id == LOG_MSG_TEXT) or an unformatted catalog event.
+ */
+struct LogEntry {
+    static const size_t MESSAGE_MAX = 96;  // Longer messages are truncated
+    static const time_t MIN_VALID_EPOCH = 1483228800;  // 2017-01-01, as getLocalTime()
+
+    unsigned long millis;
+    time_t epoch;  // 0 if wall-clock time was not available
+    LogEvent event;
+    char text[MESSAGE_MAX];  // LOG_MSG_TEXT entries only
+};
+
+/**
+ * Fixed-size, allocation-free multi-producer / single-consumer log queue
+ * (bounded MPSC ring after Dmitry Vyukov).
+ *
+ * push() never blocks: any task may log, and a full ring drops the new
+ * message and counts it. The single consumer (the main loop) peeks the
+ * oldest entry, emits it once the UART has room, then pops it, so slow
+ * output never stalls the producer.
+ */
+class LogRing {
+public:
+    static const size_t CAPACITY = 32;  // Power of two
+
+    LogRing();
+
+    /**
+     * Queue a message (any task, never blocks).
+     * @return false if the ring was full and the message was dropped
+     */
+    bool push(const char* message, unsigned long millis, time_t epoch);
+
+    /**
+     * Queue a catalog event; formatting is left to the consumer.
+     * @return false if the ring was full and the event was dropped
+     */
+    bool push(const LogEvent& event, unsigned long millis, time_t epoch);
+
+    /**
+     * Consumer: copy the oldest entry without removing it.
+     * @return false if the ring is empty
+     */
+    bool peek(LogEntry* entry);
+
+    /**
+     * Consumer: remove the entry returned by the last successful peek().
+     */
+    void pop();
+
+    bool isEmpty() const { return getDepth() == 0; }
+    size_t getDepth() const;
+
+    // Statistics
+    uint32_t getPushedCount() const { return pushedCount.load(); }
+    uint32_t getDroppedCount() const { return droppedCount.load(); }
+    size_t getMaxDepth() const { return maxDepth.load(); }
+
+private:
+    static const size_t MASK = CAPACITY - 1;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        LogEntry entry;
+    };
+
+    Cell cells[CAPACITY];
+    std::atomic<size_t> enqueuePos;
+    std::atomic<size_t> dequeuePos;  // Written by the consumer only
+    std::atomic<uint32_t> pushedCount;
+    std::atomic<uint32_t> droppedCount;
+    std::atomic<size_t> maxDepth;
+
+    Cell* claim(size_t* pos);
+    void publish(size_t pos);
+};
+
+#endif
@@ -0,0 +1,185 @@
+// src/LoopTelemetry.cpp
+#include "LoopTelemetry.h"
+#include <stdio.h>
+#include <string.h>
+
+void LogHistogram::record(uint32_t us) {
+    counts[bucketFor(us)]++;
+    count++;
+    if (us > maxUs) {
+        maxUs = us;
+    }
+}
+
+void LogHistogram::reset() {
+    memset(counts, 0, sizeof(counts));
+    count = 0;
+    maxUs = 0;
+}
+
+size_t LogHistogram::bucketFor(uint32_t us) {
+    if (us == 0) {
+        return 0;
+    }
+    size_t bits = 32 - __builtin_clz(us);
+    return (bits < BUCKETS) ? bits : BUCKETS - 1;
+}
+
+uint32_t LogHistogram::getPercentileBoundUs(uint32_t percent) const {
+    if (count == 0) {
+        return 0;
+    }
+    // Nearest rank: the ceil(percent% of count)-th smallest sample
+    uint64_t rank = ((uint64_t)count * percent + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (size_t b = 0; b < BUCKETS - 1; b++) {
+        seen += counts[b];
+        if (seen >= rank) {
+            uint32_t top = bucketLowUs(b + 1) - 1;
+            return (top < maxUs) ? top : maxUs;
+        }
+    }
+    return maxUs;
+}
+
+void LogHistogram::format(char* buffer, size_t size) const {
+    size_t used = 0;
+    buffer[0] = '\0';
+    for (size_t b = 0; b < BUCKETS; b++) {
+        if (counts[b] == 0) {
+            continue;
+        }
+        int length = snprintf(buffer + used, size - used, "%s%lu:%lu", used ? " " : "",
+                              (unsigned long)bucketLowUs(b), (unsigned long)counts[b]);
+        if (length < 0 || (size_t)length >= size - used) {
+            buffer[used] = '\0';  // Drop the partial pair
+            return;
+        }
+        used += length;
+    }
+}
+
+void LoopTelemetry::beginIteration(uint32_t nowUs) {
+    if (started) {
+        period.record(nowUs - iterationStartUs);
+    }
+    started = true;
+    iterationStartUs = nowUs;
+    markUs = nowUs;
+    iterationWorst = LOOP_WIFI;
+    iterationWorstUs = 0;
+    current = LOOP_WIFI;
+}
+
+void LoopTelemetry::mark(LoopSubsystem subsystem, uint32_t nowUs) {
+    uint32_t us = nowUs - markUs;
+    if (subsystem == LOOP_IDLE) {
+        work.record(markUs - iterationStartUs);  // The wait began at the previous mark
+    }
+    markUs = nowUs;
+    if (us > subsystemMaxUs[subsystem]) {
+        subsystemMaxUs[subsystem] = us;
+    }
+    if (us > iterationWorstUs) {
+        iterationWorstUs = us;
+        iterationWorst = subsystem;
+    }
+    if (subsystem == LOOP_SCHEDULER) {
+        updateDuration.record(us);
+    }
+    current = (LoopSubsystem)(subsystem + 1);
+}
+
+void LoopTelemetry::watchdogFed(uint32_t nowUs) {
+    if (fed) {
+        uint32_t gap = nowUs - lastFeedUs;
+        if (gap > maxWatchdogGapUs) {
+            maxWatchdogGapUs = gap;
+            worstGapSubsystem = iterationWorst;
+            // Fed from inside a step (a long command): that step so far counts too
+            if (started && current < LOOP_SUBSYSTEM_COUNT && nowUs - markUs > iterationWorstUs) {
+                worstGapSubsystem = current;
+            }
+        }
+    }
+    fed = true;
+    lastFeedUs = nowUs;
+}
+
+void LoopTelemetry::reset() {
+    period.reset();
+    work.reset();
+    updateDuration.reset();
+    memset(subsystemMaxUs, 0, sizeof(subsystemMaxUs));
+    started = false;
+    iterationStartUs = 0;
+    markUs = 0;
+    iterationWorst = LOOP_WIFI;
+    iterationWorstUs = 0;
+    current = LOOP_SUBSYSTEM_COUNT;
+    // Keep the feed timestamp: the next gap is still a real gap
+    maxWatchdogGapUs = 0;
+    worstGapSubsystem = LOOP_WIFI;
+}
+
+LoopSubsystem LoopTelemetry::getWorstSubsystem() const {
+    LoopSubsystem worst = LOOP_WIFI;
+    for (int s = 1; s < LOOP_IDLE; s++) {
+        if (subsystemMaxUs[s] > subsystemMaxUs[worst]) {
+            worst = (LoopSubsystem)s;
+        }
+    }
+    return worst;
+}
+
+const char* LoopTelemetry::subsystemName(LoopSubsystem subsystem) {
+    switch (subsystem) {
+        case LOOP_WIFI:      return "wifi";
+        case LOOP_BOOT:      return "boot";
+        case LOOP_COMMANDS:  return "commands";
+        case LOOP_SCHEDULER: return "scheduler";
+        case LOOP_LOG:       return "log";
+        case LOOP_IDLE:      return "idle";
+        default:             return "?";
+    }
+}
+
+void LoopTelemetry::printHistogram(ICommandOutput* out, const char* name, const LogHistogram& histogram) const {
+    char line[160];
+    snprintf(line, sizeof(line), "STATS: %s n=%lu p50<=%luus p99<=%luus max=%luus", name,
+             (unsigned long)histogram.getCount(),
+             (unsigned long)histogram.getPercentileBoundUs(50),
+             (unsigned long)histogram.getPercentileBoundUs(99),
+             (unsigned long)histogram.getMaxUs());
+    out->println(line);
+
+    char buckets[128];
+    histogram.format(buckets, sizeof(buckets));
+    snprintf(line, sizeof(line), "STATS: %s_hist %s", name, buckets);
+    out->println(line);
+}
+
+void LoopTelemetry::print(ICommandOutput* out, uint32_t watchdogTimeoutMs) const {
+    printHistogram(out, "loop", period);
+    printHistogram(out, "work", work);
+    printHistogram(out, "update", updateDuration);
+
+    char line[160];
+    uint32_t gapMs = maxWatchdogGapUs / 1000;
+    snprintf(line, sizeof(line), "STATS: watchdog maxGap=%lums timeout=%lums margin=%ldms slowestStep=%s",
+             (unsigned long)gapMs, (unsigned long)watchdogTimeoutMs,
+             (long)watchdogTimeoutMs - (long)gapMs, subsystemName(worstGapSubsystem));
+    out->println(line);
+
+    LoopSubsystem worst = getWorstSubsystem();
+    snprintf(line, sizeof(line),
+             "STATS: worst=%s maxUs=%lu wifi=%lu boot=%lu commands=%lu scheduler=%lu log=%lu idle=%lu",
+             subsystemName(worst), (unsigned long)subsystemMaxUs[worst],
+             (unsigned long)subsystemMaxUs[LOOP_WIFI], (unsigned long)subsystemMaxUs[LOOP_BOOT],
+             (unsigned long)subsystemMaxUs[LOOP_COMMANDS], (unsigned long)subsystemMaxUs[LOOP_SCHEDULER],
+             (unsigned long)subsystemMaxUs[LOOP_LOG], (unsigned long)subsystemMaxUs[LOOP_IDLE]);
+    out->println(line);
+}
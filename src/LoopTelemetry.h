@@ -0,0 +1,125 @@
+// src/LoopTelemetry.h
+#ifndef LOOP_TELEMETRY_H
+#define LOOP_TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ICommandOutput.h"
+
+/**
+ * Counts of microsecond durations in power-of-two buckets: bucket 0 holds
+ * 0us, bucket b holds [2^(b-1), 2^b) us and the last bucket everything from
+ * 2^24 us (16.8 s) up. Recording is a count-leading-zeros and an increment.
+ */
+class LogHistogram {
+public:
+    static const size_t BUCKETS = 26;
+
+    LogHistogram() { reset(); }
+
+    void record(uint32_t us);
+    void reset();
+
+    uint32_t getCount() const { return count; }
+    uint32_t getMaxUs() const { return maxUs; }
+    uint32_t getBucketCount(size_t bucket) const { return counts[bucket]; }
+
+    // Bound on the given percentile (1-100): the top of its bucket, or the
+    // maximum if that is lower. 0 when empty.
+    uint32_t getPercentileBoundUs(uint32_t percent) const;
+
+    static size_t bucketFor(uint32_t us);
+    static uint32_t bucketLowUs(size_t bucket) { return bucket ? (uint32_t)1 << (bucket - 1) : 0; }
+
+    // Non-empty buckets as "lowUs:count" pairs; pairs that do not fit are left out
+    void format(char* buffer, size_t size) const;
+
+private:
+    uint32_t counts[BUCKETS];
+    uint32_t count;
+    uint32_t maxUs;
+};
+
+// Steps of loop(), in the order they run
+enum LoopSubsystem {
+    LOOP_WIFI,       // wifiManager.step()
+    LOOP_BOOT,       // boot.step()
+    LOOP_COMMANDS,   // processSerialCommands()
+    LOOP_SCHEDULER,  // scheduler.update()
+    LOOP_LOG,        // drainLog()
+    LOOP_IDLE,       // waitForNextEvent() / delay(): sleeping, not working
+    LOOP_SUBSYSTEM_COUNT
+};
+
+/**
+ * Always-on loop instrumentation: loop period (wake to wake), work per pass
+ * (start of the pass to the start of the wait) and update() duration
+ * histograms, the longest gap between watchdog feeds and the slowest
+ * subsystem. Each call costs a subtraction, a compare and at most one
+ * histogram increment; timestamps come from the caller (micros()).
+ * Single task only (the loop task).
+ *
+ *   loop():  feedWatchdog -> watchdogFed(now); beginIteration(now);
+ *            wifi step -> mark(LOOP_WIFI, now); ... drainLog -> mark(LOOP_LOG, now)
+ *            wait -> mark(LOOP_IDLE, now)
+ *
+ * The wait is tracked like a step so a watchdog gap made mostly of sleep
+ * is charged to "idle" rather than to the slowest working step.
+ */
+class LoopTelemetry {
+public:
+    LoopTelemetry() : fed(false), lastFeedUs(0) { reset(); }
+
+    // Start of loop(): records the period since the previous start
+    void beginIteration(uint32_t nowUs);
+
+    // End of a subsystem's step: charged the time since the previous mark
+    void mark(LoopSubsystem subsystem, uint32_t nowUs);
+
+    // esp_task_wdt_reset() was just called
+    void watchdogFed(uint32_t nowUs);
+
+    // Clear the statistics (STATS RESET), e.g. before reproducing a stall
+    void reset();
+
+    const LogHistogram& getPeriod() const { return period; }
+    const LogHistogram& getWork() const { return work; }
+    const LogHistogram& getUpdateDuration() const { return updateDuration; }
+    uint32_t getMaxWatchdogGapUs() const { return maxWatchdogGapUs; }
+    uint32_t getSubsystemMaxUs(LoopSubsystem subsystem) const { return subsystemMaxUs[subsystem]; }
+
+    // Working subsystem (not LOOP_IDLE) with the longest single step so far
+    LoopSubsystem getWorstSubsystem() const;
+
+    // Slowest step, the wait included, of the iteration before the longest watchdog gap
+    LoopSubsystem getWorstGapSubsystem() const { return worstGapSubsystem; }
+
+    static const char* subsystemName(LoopSubsystem subsystem);
+
+    // "STATS: ..." report lines
+    void print(ICommandOutput* out, uint32_t watchdogTimeoutMs) const;
+
+private:
+    LogHistogram period;
+    LogHistogram work;
+    LogHistogram updateDuration;
+    uint32_t subsystemMaxUs[LOOP_SUBSYSTEM_COUNT];
+
+    bool started;
+    uint32_t iterationStartUs;
+    uint32_t markUs;
+
+    // Slowest step since the last beginIteration()
+    LoopSubsystem iterationWorst;
+    uint32_t iterationWorstUs;
+    LoopSubsystem current;  // Step now running; LOOP_SUBSYSTEM_COUNT between passes
+
+    bool fed;
+    uint32_t lastFeedUs;
+    uint32_t maxWatchdogGapUs;
+    LoopSubsystem worstGapSubsystem;
+
+    void printHistogram(ICommandOutput* out, const char* name, const LogHistogram& histogram) const;
+};
+
+#endif
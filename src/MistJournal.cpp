@@ -0,0 +1,196 @@
+// src/MistJournal.cpp
+#include "MistJournal.h"
+#include "Crc32.h"
+#include <string.h>
+
+MistJournal::MistJournal(IFlashRegion* flash, LogCallback logger)
+    : flash(flash), logger(logger), eventLogger(nullptr), ready(false), sectorCount(0), slotsPerSector(0),
+      headSector(0), headSlot(0), nextSequence(1), recoveryReads(0) {
+}
+
+bool MistJournal::begin() {
+    ready = false;
+    recoveryReads = 0;
+
+    size_t size = flash->getSize();
+    size_t sectorSize = flash->getSectorSize();
+    if (size == 0 || sectorSize < sizeof(MistRecord) || size < 2 * sectorSize) {
+        logEvent(LOG_MSG_JOURNAL_UNAVAILABLE);
+        return false;
+    }
+    sectorCount = size / sectorSize;
+    slotsPerSector = sectorSize / sizeof(MistRecord);
+
+    // Sector keys increase along the ring up to the head, then drop to older
+    // (or erased = 0) sectors. Sector 0 is only erased while wrapping, so a
+    // blank sector 0 means either an empty journal or a wrap cut short.
+    uint32_t firstKey = sectorKey(0);
+    if (firstKey == 0) {
+        if (sectorKey(sectorCount - 1) == 0) {
+            // Empty: pretend the last sector is full so the first append
+            // erases and starts sector 0
+            headSector = sectorCount - 1;
+            headSlot = slotsPerSector;
+            nextSequence = 1;
+            ready = true;
+            logEvent(LOG_MSG_JOURNAL_EMPTY);
+            return true;
+        }
+        headSector = sectorCount - 1;
+    } else {
+        // Largest sector index whose key is still >= key of sector 0
+        size_t lo = 0;
+        size_t hi = sectorCount - 1;
+        while (lo < hi) {
+            size_t mid = (lo + hi + 1) / 2;
+            if (sectorKey(mid) >= firstKey) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+        headSector = lo;
+    }
+
+    // Slots fill in order: first erased slot after the (used) slot 0
+    size_t lo = 1;
+    size_t hi = slotsPerSector;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (isSlotErased(headSector, mid)) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    headSlot = lo;
+    nextSequence = sectorKey(headSector) + (uint32_t)headSlot;
+    ready = true;
+
+    logEvent(LOG_MSG_JOURNAL_HEAD, (int32_t)headSector, (int32_t)headSlot,
+             (int32_t)nextSequence, (int32_t)recoveryReads);
+    return true;
+}
+
+bool MistJournal::recordMist(uint32_t startEpoch, uint32_t durationMs, MistTrigger trigger, MistOutcome outcome) {
+    if (!ready) {
+        return false;
+    }
+
+    // Current sector full: erase the oldest one (next in the ring) and move on
+    if (headSlot >= slotsPerSector) {
+        size_t next = (headSector + 1) % sectorCount;
+        if (!flash->eraseSector(next)) {
+            logEvent(LOG_MSG_JOURNAL_ERASE_FAILED);
+            return false;
+        }
+        headSector = next;
+        headSlot = 0;
+    }
+
+    MistRecord record;
+    memset(&record, 0, sizeof(record));
+    record.sequence = nextSequence;
+    record.startEpoch = startEpoch;
+    record.durationMs = durationMs;
+    record.trigger = (uint8_t)trigger;
+    record.outcome = (uint8_t)outcome;
+    record.crc = recordCrc(record);
+
+    // The slot is consumed even if programming fails: its contents are unknown
+    bool success = flash->write(slotOffset(headSector, headSlot), &record, sizeof(record));
+    headSlot++;
+    nextSequence++;
+
+    if (!success) {
+        logEvent(LOG_MSG_JOURNAL_WRITE_FAILED);
+    }
+    return success;
+}
+
+bool MistJournal::getNewestStartEpoch(uint32_t* startEpoch) {
+    MistRecord record;
+    if (readRecent(&record, 1) == 0) {
+        return false;
+    }
+    *startEpoch = record.startEpoch;
+    return true;
+}
+
+size_t MistJournal::readRecent(MistRecord* out, size_t maxRecords) {
+    if (!ready || maxRecords == 0) {
+        return 0;
+    }
+
+    size_t count = 0;
+    size_t sector = headSector;
+    size_t slot = headSlot;
+    uint32_t newerKey = 0;
+
+    for (size_t visited = 0; visited < sectorCount; visited++) {
+        uint32_t key = sectorKey(sector);
+        // Older sectors have smaller keys; anything else is erased or stale
+        if (key == 0 || (newerKey != 0 && key >= newerKey)) {
+            break;
+        }
+
+        while (slot > 0 && count < maxRecords) {
+            slot--;
+            MistRecord record;
+            if (readSlot(sector, slot, &record) && isValid(record)) {
+                out[count++] = record;
+            }
+        }
+        if (count >= maxRecords) {
+            break;
+        }
+
+        newerKey = key;
+        sector = (sector + sectorCount - 1) % sectorCount;
+        slot = slotsPerSector;
+    }
+    return count;
+}
+
+bool MistJournal::readSlot(size_t sector, size_t slot, MistRecord* record) {
+    recoveryReads++;
+    return flash->read(slotOffset(sector, slot), record, sizeof(*record));
+}
+
+uint32_t MistJournal::sectorKey(size_t sector) {
+    MistRecord record;
+    if (!readSlot(sector, 0, &record) || !isValid(record)) {
+        return 0;
+    }
+    return record.sequence;
+}
+
+bool MistJournal::isSlotErased(size_t sector, size_t slot) {
+    MistRecord record;
+    if (!readSlot(sector, slot, &record)) {
+        return false;
+    }
+    const uint8_t* bytes = (const uint8_t*)&record;
+    for (size_t i = 0; i < sizeof(record); i++) {
+        if (bytes[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t MistJournal::slotOffset(size_t sector, size_t slot) const {
+    return sector * flash->getSectorSize() + slot * sizeof(MistRecord);
+}
+
+uint32_t MistJournal::recordCrc(const MistRecord& record) {
+    return crc32(&record, offsetof(MistRecord, crc));
+}
+
+bool MistJournal::isValid(const MistRecord& record) {
+    return record.sequence != 0 && record.sequence != 0xFFFFFFFF && record.crc == recordCrc(record);
+}
+
+void MistJournal::logEvent(uint8_t id, int32_t arg0, int32_t arg1, int32_t arg2, int32_t arg3) {
+    emitLogEvent(eventLogger, logger, id, arg0, arg1, arg2, arg3);
+}
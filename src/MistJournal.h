@@ -0,0 +1,90 @@
+// src/MistJournal.h
+#ifndef MIST_JOURNAL_H
+#define MIST_JOURNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "IEventJournal.h"
+#include "IFlashRegion.h"
+#include "LogEvent.h"
+
+// Logging callback type
+typedef void (*LogCallback)(const char* message);
+
+/**
+ * One journal entry. Fixed size so slot offsets are computable and the
+ * head can be located by binary search.
+ */
+struct MistRecord {
+    uint32_t sequence;    // Global, strictly increasing (slot 0 of a sector = sector key)
+    uint32_t startEpoch;
+    uint32_t durationMs;
+    uint8_t trigger;      // MistTrigger
+    uint8_t outcome;      // MistOutcome
+    uint8_t reserved[2];
+    uint32_t crc;         // CRC-32 of the preceding bytes
+};
+
+/**
+ * Log-structured, wear-leveled mist history in a dedicated flash region.
+ *
+ * Records are appended to the current sector; when it is full the next
+ * sector (round-robin) is erased and writing continues there, so every
+ * sector is erased equally often and the oldest history is overwritten.
+ * Each record carries a sequence number; slot n of a sector holds the
+ * sector's first sequence + n, torn slots included.
+ *
+ * begin() recovers the head without a full scan: a binary search over the
+ * first record of each sector finds the newest sector, and a second binary
+ * search finds the first erased slot in it (O(log sectors + log slots)
+ * reads). A record torn by a power cut fails its CRC and is skipped.
+ */
+class MistJournal : public IEventJournal {
+public:
+    MistJournal(IFlashRegion* flash, LogCallback logger = nullptr);
+
+    /**
+     * Locate the head. Must be called before append/read.
+     * @return false if the region is unusable
+     */
+    bool begin();
+
+    // Optional structured logging (see MistingScheduler::setEventLogger)
+    void setEventLogger(LogEventCallback callback) { eventLogger = callback; }
+
+    // IEventJournal
+    bool recordMist(uint32_t startEpoch, uint32_t durationMs, MistTrigger trigger, MistOutcome outcome) override;
+    bool getNewestStartEpoch(uint32_t* startEpoch) override;
+
+    /**
+     * Copy up to maxRecords valid records, newest first.
+     * @return Number of records copied
+     */
+    size_t readRecent(MistRecord* out, size_t maxRecords);
+
+    uint32_t getNextSequence() const { return nextSequence; }
+    size_t getCapacity() const { return sectorCount * slotsPerSector; }
+    size_t getLastRecoveryReads() const { return recoveryReads; }
+
+private:
+    IFlashRegion* flash;
+    LogCallback logger;
+    LogEventCallback eventLogger;
+    bool ready;
+    size_t sectorCount;
+    size_t slotsPerSector;
+    size_t headSector;      // Sector holding the newest record
+    size_t headSlot;        // Next free slot in headSector (== slotsPerSector when full)
+    uint32_t nextSequence;
+    size_t recoveryReads;
+
+    bool readSlot(size_t sector, size_t slot, MistRecord* record);
+    uint32_t sectorKey(size_t sector);
+    bool isSlotErased(size_t sector, size_t slot);
+    size_t slotOffset(size_t sector, size_t slot) const;
+    static uint32_t recordCrc(const MistRecord& record);
+    static bool isValid(const MistRecord& record);
+    void logEvent(uint8_t id, int32_t arg0 = 0, int32_t arg1 = 0, int32_t arg2 = 0, int32_t arg3 = 0);
+};
+
+#endif
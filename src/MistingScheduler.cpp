@@ -1,20 +1,34 @@
 // src/MistingScheduler.cpp
 #include "MistingScheduler.h"
-#include <stdio.h>
 
-MistingScheduler::MistingScheduler(ITimeProvider* timeProvider, IRelayController* relayController, IStateStorage* stateStorage, LogCallback logger)
-    : timeProvider(timeProvider), relayController(relayController), stateStorage(stateStorage), logger(logger),
-      currentState(WAITING_SYNC), lastMistEpoch(0), lastKnownEpoch(0), mistStartTime(0), hasEverMisted(false), schedulerEnabled(true) {
+MistingScheduler::MistingScheduler(ITimeProvider* timeProvider, IRelayController* relayController, IStateStorage* stateStorage, LogCallback logger, ICutoffTimer* cutoffTimer)
+    : timeProvider(timeProvider), relayController(relayController), stateStorage(stateStorage), logger(logger), eventLogger(nullptr), cutoffTimer(cutoffTimer), journal(nullptr),
+      configs(ScheduleConfig(MIST_DURATION, MIST_INTERVAL_SECONDS, ACTIVE_WINDOW_START, ACTIVE_WINDOW_END)),
+      currentState(WAITING_SYNC), lastMistEpoch(0), lastKnownEpoch(0), mistStartTime(0), mistDurationMs(MIST_DURATION), hasEverMisted(false), schedulerEnabled(true),
+      mistTrigger(MIST_TRIGGER_SCHEDULE),
+      committedValid(false), committedLastMistEpoch(0), committedHasEverMisted(false), committedEnabled(true),
+      saveCoalesceMs(0), savePending(false), saveRequestedAt(0), saveRequestCount(0), saveWriteCount(0) {
 }
 
 void MistingScheduler::update() {
+    // Commit a coalesced save once the quiet period has passed
+    if (savePending && timeProvider->getMillis() - saveRequestedAt >= saveCoalesceMs) {
+        flushPendingSave();
+    }
+
     // Check if scheduler is disabled
     if (!schedulerEnabled) {
         return;
     }
 
+    // Read all clocks (and the config) once so every check in this tick sees
+    // the same time and schedule
+    TimeSnapshot now;
+    timeProvider->getSnapshot(&now);
+    ScheduleConfig config = configs.current();
+
     // Time jump detection (NTP adjustments)
-    time_t currentEpoch = timeProvider->getEpochTime();
+    time_t currentEpoch = now.epoch;
     if (lastKnownEpoch > 0 && currentEpoch > 0) {
         time_t timeDelta = (currentEpoch > lastKnownEpoch) ?
                            (currentEpoch - lastKnownEpoch) :
@@ -22,10 +36,7 @@ void MistingScheduler::update() {
 
         // If time jumped more than 5 minutes, log it
         if (timeDelta > 300) {
-            char buffer[80];
-            snprintf(buffer, sizeof(buffer),
-                     "WARNING: Time jump detected: %ld seconds", (long)timeDelta);
-            log(buffer);
+            logEvent(LOG_MSG_TIME_JUMP, (int32_t)timeDelta);
         }
     }
     lastKnownEpoch = currentEpoch;
@@ -33,8 +44,7 @@ void MistingScheduler::update() {
     switch (currentState) {
         case WAITING_SYNC:
             {
-                struct tm timeinfo;
-                if (timeProvider->getTime(&timeinfo)) {
+                if (now.localValid) {
                     currentState = IDLE;
                     // Don't reset lastMistEpoch - it may have been loaded from storage
                     // Fall through to check IDLE conditions immediately
@@ -45,102 +55,300 @@ void MistingScheduler::update() {
             }
 
         case IDLE:
-            if (shouldStartMisting()) {
-                startMisting();
+            if (shouldStartMisting(now, config)) {
+                startMisting(now, MIST_TRIGGER_SCHEDULE, config.mistDurationMs);
             }
             break;
 
         case MISTING:
             {
-                unsigned long elapsed = timeProvider->getMillis() - mistStartTime;
-                if (elapsed >= MIST_DURATION) {
-                    stopMisting();
-                } else if (elapsed >= MIST_DURATION * 3) {
-                    // Safety failsafe: mist duration exceeded 3x normal time (75 seconds)
-                    log("CRITICAL: Mist duration exceeded safety limit, forcing stop");
+                unsigned long elapsed = now.millis - mistStartTime;
+                bool cutOff = cutoffTimer && cutoffTimer->hasFired();
+                if (elapsed >= mistDurationMs * 3 && !cutOff) {
+                    // Safety failsafe: mist ran 3x its duration (75 seconds for a
+                    // scheduled mist) and no cut-off timer stopped it
+                    logEvent(LOG_MSG_MIST_FAILSAFE);
                     relayController->turnOff();
+                    if (cutoffTimer) {
+                        cutoffTimer->cancel();
+                    }
                     currentState = IDLE;
+                    recordMist(elapsed, MIST_OUTCOME_FAILSAFE);
                     // Don't save state or update lastMistEpoch - this is an error condition
+                } else if (cutOff || elapsed >= mistDurationMs) {
+                    // Relay may already be off (cut-off timer); finish the bookkeeping.
+                    // A fired timer stopped the relay at exactly mistDurationMs.
+                    stopMisting(cutOff ? mistDurationMs : elapsed);
                 }
             }
             break;
     }
 }
 
-bool MistingScheduler::isInActiveWindow() {
-    struct tm timeinfo;
-    if (!timeProvider->getTime(&timeinfo)) {
+bool MistingScheduler::isInActiveWindow(const TimeSnapshot& now, const ScheduleConfig& config) {
+    if (!now.localValid) {
         return false;
     }
 
-    int hour = timeinfo.tm_hour;
-    return (hour >= ACTIVE_WINDOW_START && hour < ACTIVE_WINDOW_END);
+    return config.activeWindow.matches(now.local);
 }
 
-bool MistingScheduler::shouldStartMisting() {
-    if (!isInActiveWindow()) return false;
+bool MistingScheduler::shouldStartMisting(const TimeSnapshot& now, const ScheduleConfig& config) {
+    if (!isInActiveWindow(now, config)) return false;
     if (currentState != IDLE) return false;
 
     // First mist
     if (!hasEverMisted) return true;
 
-    // Check if 2 hours have passed using epoch time
-    time_t currentEpoch = timeProvider->getEpochTime();
+    // Check if the interval has passed using epoch time
+    time_t currentEpoch = now.epoch;
     if (currentEpoch == 0 || lastMistEpoch == 0) {
         return false;  // Time not available
     }
 
     time_t elapsed = currentEpoch - lastMistEpoch;
-    return (elapsed >= MIST_INTERVAL_SECONDS);
+    return (elapsed >= (time_t)config.intervalSeconds);
 }
 
-void MistingScheduler::startMisting() {
+unsigned long MistingScheduler::getNextEventMillis() {
+    TimeSnapshot snapshot;
+    timeProvider->getSnapshot(&snapshot);
+    unsigned long now = snapshot.millis;
+
+    // Disabled: nothing to do until a command arrives, but keep a bounded wait
+    unsigned long next = schedulerEnabled ? getNextScheduleMillis(snapshot, configs.current()) : now + MAX_EVENT_WAIT_MS;
+
+    // A coalesced save must be committed when its quiet period ends
+    if (savePending) {
+        unsigned long saveDue = saveRequestedAt + saveCoalesceMs;
+        if ((long)(saveDue - next) < 0) {
+            return saveDue;
+        }
+    }
+    return next;
+}
+
+unsigned long MistingScheduler::getNextScheduleMillis(const TimeSnapshot& snapshot, const ScheduleConfig& config) {
+    unsigned long now = snapshot.millis;
+
+    switch (currentState) {
+        case WAITING_SYNC:
+            return now + SYNC_POLL_MS;
+
+        case MISTING:
+            return mistStartTime + mistDurationMs;
+
+        case IDLE:
+            break;
+    }
+
+    unsigned long waitSeconds = secondsUntilNextEvent(snapshot, config);
+    if (waitSeconds >= MAX_EVENT_WAIT_MS / 1000) {
+        // Cap the wait so wall-clock jumps (NTP, DST) are picked up promptly
+        return now + MAX_EVENT_WAIT_MS;
+    }
+    return now + waitSeconds * 1000;
+}
+
+unsigned long MistingScheduler::secondsUntilNextEvent(const TimeSnapshot& now, const ScheduleConfig& config) {
+    if (!now.localValid) {
+        return SYNC_POLL_MS / 1000;
+    }
+
+    // The caller caps the wait at MAX_EVENT_WAIT_MS, so window edges only
+    // need to be found that far ahead
+    const long lookaheadMinutes = MAX_EVENT_WAIT_MS / 60000 + 1;
+    const long beyondLookahead = lookaheadMinutes * 60;
+
+    // Outside the window the next event is the window opening
+    if (!isInActiveWindow(now, config)) {
+        long untilOpen = config.activeWindow.minutesUntil(now.local, true, lookaheadMinutes);
+        return (untilOpen < 0) ? beyondLookahead : untilOpen * 60 - now.local.tm_sec;
+    }
+
+    // Inside the window: next event is interval expiry or window close
+    long untilClose = config.activeWindow.minutesUntil(now.local, false, lookaheadMinutes);
+    long untilWindowEnd = (untilClose < 0) ? beyondLookahead : untilClose * 60 - now.local.tm_sec;
+    if (!hasEverMisted) {
+        return 0;  // First mist is due now
+    }
+
+    time_t currentEpoch = now.epoch;
+    if (currentEpoch == 0 || lastMistEpoch == 0) {
+        return SYNC_POLL_MS / 1000;  // Time not available, poll
+    }
+
+    time_t elapsed = currentEpoch - lastMistEpoch;
+    if (elapsed >= (time_t)config.intervalSeconds) {
+        return 0;
+    }
+
+    long untilInterval = (long)(config.intervalSeconds - elapsed);
+    return (untilInterval < untilWindowEnd) ? untilInterval : untilWindowEnd;
+}
+
+void MistingScheduler::startMisting(const TimeSnapshot& now, MistTrigger trigger, unsigned long durationMs) {
     relayController->turnOn();
-    mistStartTime = timeProvider->getMillis();
-    lastMistEpoch = timeProvider->getEpochTime();
+    mistStartTime = now.millis;
+    mistDurationMs = durationMs;
+    mistTrigger = trigger;
+    if (cutoffTimer && !cutoffTimer->arm(durationMs)) {
+        logEvent(LOG_MSG_CUTOFF_ARM_FAILED);
+    }
+    lastMistEpoch = now.epoch;
     currentState = MISTING;
     hasEverMisted = true;
-    log("MIST START");
+    logEvent(LOG_MSG_MIST_START);
     // Don't save here - save only on successful completion (reduces NVS writes)
 }
 
-void MistingScheduler::stopMisting() {
+void MistingScheduler::stopMisting(unsigned long durationMs) {
     relayController->turnOff();
+    if (cutoffTimer) {
+        cutoffTimer->cancel();
+    }
     currentState = IDLE;
-    log("MIST STOP");
+    logEvent(LOG_MSG_MIST_STOP);
+    recordMist(durationMs, MIST_OUTCOME_COMPLETED);
     // Save state after successful misting cycle (single write per cycle)
     saveState();
 }
 
-void MistingScheduler::log(const char* message) {
-    if (logger) {
-        logger(message);
+void MistingScheduler::recordMist(unsigned long durationMs, MistOutcome outcome) {
+    if (journal && !journal->recordMist((uint32_t)lastMistEpoch, (uint32_t)durationMs, mistTrigger, outcome)) {
+        logEvent(LOG_MSG_JOURNAL_APPEND_FAILED);
     }
 }
 
+void MistingScheduler::logEvent(uint8_t id, int32_t arg0, int32_t arg1, int32_t arg2) {
+    emitLogEvent(eventLogger, logger, id, arg0, arg1, arg2);
+}
+
 void MistingScheduler::loadState() {
     if (!stateStorage) {
         return;
     }
 
-    // Note: NVS still stores as unsigned long for compatibility
-    // We cast it to time_t (which should also be compatible)
-    lastMistEpoch = (time_t)stateStorage->getLastMistTime();
-    hasEverMisted = stateStorage->getHasEverMisted();
-    schedulerEnabled = stateStorage->getEnabled();
+    // One batch read; NVS stores the epoch as unsigned long, cast to time_t
+    unsigned long storedLastMist = 0;
+    bool found = stateStorage->load(&storedLastMist, &hasEverMisted, &schedulerEnabled);
+    lastMistEpoch = (time_t)storedLastMist;
+
+    // What was just read is what storage holds: identical saves can be skipped
+    committedValid = found;
+    committedLastMistEpoch = lastMistEpoch;
+    committedHasEverMisted = hasEverMisted;
+    committedEnabled = schedulerEnabled;
 
     if (lastMistEpoch > 0) {
-        log("Loaded state from NVS");
+        logEvent(LOG_MSG_STATE_LOADED);
+    }
+
+    // Schedule config is a separate record; a missing, corrupt or invalid
+    // one leaves the defaults in place
+    ScheduleConfigRecord record;
+    ScheduleConfig config;
+    if (stateStorage->loadScheduleConfig(&record, sizeof(record)) && record.decode(&config)) {
+        configs.publish(config);
+        logEvent(LOG_MSG_CONFIG_LOADED);
     }
 }
 
+bool MistingScheduler::setConfig(const ScheduleConfig& config) {
+    if (!config.isValid()) {
+        return false;
+    }
+    if (config == configs.current()) {
+        return true;  // No change: skip the swap and the flash write
+    }
+    configs.publish(config);
+    logEvent(LOG_MSG_CONFIG_CHANGED, (int32_t)config.intervalSeconds, (int32_t)config.mistDurationMs);
+
+    if (stateStorage) {
+        ScheduleConfigRecord record;
+        record.encode(config);
+        if (!stateStorage->saveScheduleConfig(&record, sizeof(record))) {
+            logEvent(LOG_MSG_CONFIG_SAVE_FAILED);
+        }
+    }
+    return true;
+}
+
 void MistingScheduler::saveState() {
     if (!stateStorage) {
         return;
     }
 
+    saveRequestCount++;
+
+    // Nothing changed since the last commit: skip the flash write
+    if (!isStateDirty()) {
+        savePending = false;
+        return;
+    }
+
+    if (saveCoalesceMs > 0) {
+        // Restart the quiet period; update() commits once it expires
+        savePending = true;
+        saveRequestedAt = timeProvider->getMillis();
+        return;
+    }
+
+    commitState();
+}
+
+void MistingScheduler::flushPendingSave() {
+    if (!stateStorage || !savePending) {
+        return;
+    }
+    savePending = false;
+    if (isStateDirty()) {
+        commitState();
+    }
+}
+
+void MistingScheduler::copyStateTo(MistingScheduler* copy) const {
+    copy->configs.publish(configs.current());
+    copy->currentState = currentState;
+    copy->lastMistEpoch = lastMistEpoch;
+    copy->lastKnownEpoch = lastKnownEpoch;
+    copy->mistStartTime = mistStartTime;
+    copy->mistDurationMs = mistDurationMs;
+    copy->hasEverMisted = hasEverMisted;
+    copy->schedulerEnabled = schedulerEnabled;
+    copy->mistTrigger = mistTrigger;
+    copy->committedValid = committedValid;
+    copy->committedLastMistEpoch = committedLastMistEpoch;
+    copy->committedHasEverMisted = committedHasEverMisted;
+    copy->committedEnabled = committedEnabled;
+    // A save still pending here is the live scheduler's to commit
+    copy->savePending = false;
+}
+
+bool MistingScheduler::isStateDirty() const {
+    return !committedValid ||
+           committedLastMistEpoch != lastMistEpoch ||
+           committedHasEverMisted != hasEverMisted ||
+           committedEnabled != schedulerEnabled;
+}
+
+void MistingScheduler::commitState() {
+    if (!stateStorage) {
+        return;
+    }
+
+    saveWriteCount++;
+
     // Save epoch time as unsigned long for NVS compatibility
-    stateStorage->save((unsigned long)lastMistEpoch, hasEverMisted, schedulerEnabled);
+    if (!stateStorage->save((unsigned long)lastMistEpoch, hasEverMisted, schedulerEnabled)) {
+        committedValid = false;  // Unknown contents, retry on the next save
+        return;
+    }
+
+    committedValid = true;
+    committedLastMistEpoch = lastMistEpoch;
+    committedHasEverMisted = hasEverMisted;
+    committedEnabled = schedulerEnabled;
 }
 
 void MistingScheduler::setEnabled(bool enabled) {
@@ -152,57 +360,63 @@ void MistingScheduler::setEnabled(bool enabled) {
         if (timeProvider->getTime(&timeinfo)) {
             currentState = IDLE;
             lastMistEpoch = 0;
-            log("Scheduler ENABLED (transitioned to IDLE)");
+            logEvent(LOG_MSG_ENABLED_IDLE);
         } else {
-            log("Scheduler ENABLED (waiting for time sync)");
+            logEvent(LOG_MSG_ENABLED_WAITING_SYNC);
         }
     } else if (enabled) {
-        log("Scheduler ENABLED");
+        logEvent(LOG_MSG_ENABLED);
     } else {
-        log("Scheduler DISABLED");
+        logEvent(LOG_MSG_DISABLED);
     }
 
     saveState();
 }
 
 void MistingScheduler::forceMist() {
+    forceMist(configs.current().mistDurationMs);
+}
+
+void MistingScheduler::forceMist(unsigned long durationMs) {
     // Check if already misting
     if (currentState == MISTING) {
-        log("ERROR: Already misting, cannot force");
+        logEvent(LOG_MSG_FORCE_ALREADY_MISTING);
         return;
     }
 
     // Check if scheduler is enabled
     if (!schedulerEnabled) {
-        log("ERROR: Scheduler disabled, cannot force mist");
+        logEvent(LOG_MSG_FORCE_DISABLED);
         return;
     }
 
-    log("FORCE MIST");
-    startMisting();
+    logEvent(LOG_MSG_FORCE_MIST);
+    TimeSnapshot now;
+    timeProvider->getSnapshot(&now);
+    startMisting(now, MIST_TRIGGER_FORCE, durationMs);
 }
 
 void MistingScheduler::printStatus() {
     // Print current state
-    const char* stateStr = "";
+    uint8_t stateStr = LOG_STR_WAITING_SYNC;
     switch (currentState) {
         case WAITING_SYNC:
-            stateStr = "WAITING_SYNC";
+            stateStr = LOG_STR_WAITING_SYNC;
             break;
         case IDLE:
-            stateStr = "IDLE";
+            stateStr = LOG_STR_IDLE;
             break;
         case MISTING:
-            stateStr = "MISTING";
+            stateStr = LOG_STR_MISTING;
             break;
     }
 
-    char buffer[256];
-    snprintf(buffer, sizeof(buffer), "STATUS: state=%s enabled=%s hasEverMisted=%s",
-             stateStr,
-             schedulerEnabled ? "true" : "false",
-             hasEverMisted ? "true" : "false");
-    log(buffer);
+    logEvent(LOG_MSG_STATUS_STATE, stateStr,
+             schedulerEnabled ? LOG_STR_TRUE : LOG_STR_FALSE,
+             hasEverMisted ? LOG_STR_TRUE : LOG_STR_FALSE);
+
+    logEvent(LOG_MSG_STATUS_SAVES, (int32_t)saveRequestCount, (int32_t)saveWriteCount,
+             savePending ? LOG_STR_PENDING : LOG_STR_EMPTY);
 
     // Print last mist time using epoch time
     if (hasEverMisted && lastMistEpoch > 0) {
@@ -212,30 +426,29 @@ void MistingScheduler::printStatus() {
             long elapsedMin = elapsed / 60;
             long elapsedHours = elapsedMin / 60;
 
-            snprintf(buffer, sizeof(buffer), "STATUS: lastMist=%ldh %ldm ago",
-                     elapsedHours, elapsedMin % 60);
-            log(buffer);
+            logEvent(LOG_MSG_STATUS_LAST_MIST, (int32_t)elapsedHours, (int32_t)(elapsedMin % 60));
         }
     } else {
-        log("STATUS: lastMist=never");
+        logEvent(LOG_MSG_STATUS_LAST_MIST_NEVER);
     }
 
     // Print next mist estimate if in IDLE state
+    ScheduleConfig config = configs.current();
     if (currentState == IDLE && schedulerEnabled && hasEverMisted) {
         time_t currentEpoch = timeProvider->getEpochTime();
         if (currentEpoch > 0 && lastMistEpoch > 0) {
             time_t elapsed = currentEpoch - lastMistEpoch;
-            if (elapsed < MIST_INTERVAL_SECONDS) {
-                time_t remaining = MIST_INTERVAL_SECONDS - elapsed;
+            if (elapsed < (time_t)config.intervalSeconds) {
+                time_t remaining = config.intervalSeconds - elapsed;
                 long remainingMin = remaining / 60;
                 long remainingHours = remainingMin / 60;
 
-                snprintf(buffer, sizeof(buffer), "STATUS: nextMist=in %ldh %ldm",
-                         remainingHours, remainingMin % 60);
-                log(buffer);
+                logEvent(LOG_MSG_STATUS_NEXT_MIST, (int32_t)remainingHours, (int32_t)(remainingMin % 60));
             } else {
-                log("STATUS: nextMist=waiting for active window");
+                logEvent(LOG_MSG_STATUS_NEXT_MIST_WINDOW);
             }
         }
     }
-}
+
+    logEvent(LOG_MSG_STATUS_CONFIG, (int32_t)config.intervalSeconds, (int32_t)config.mistDurationMs);
+}
\ No newline at end of file
@@ -5,6 +5,10 @@
 #include "ITimeProvider.h"
 #include "IRelayController.h"
 #include "IStateStorage.h"
+#include "ICutoffTimer.h"
+#include "IEventJournal.h"
+#include "ScheduleConfig.h"
+#include "LogEvent.h"
 
 // Logging callback type
 typedef void (*LogCallback)(const char* message);
@@ -17,7 +21,7 @@ enum MisterState {
 
 class MistingScheduler {
 public:
-    MistingScheduler(ITimeProvider* timeProvider, IRelayController* relayController, IStateStorage* stateStorage = nullptr, LogCallback logger = nullptr);
+    MistingScheduler(ITimeProvider* timeProvider, IRelayController* relayController, IStateStorage* stateStorage = nullptr, LogCallback logger = nullptr, ICutoffTimer* cutoffTimer = nullptr);
 
     // Call from main loop
     void update();
@@ -26,6 +30,12 @@ public:
     MisterState getState() const { return currentState; }
     time_t getLastMistEpoch() const { return lastMistEpoch; }
     unsigned long getMistStartTime() const { return mistStartTime; }
+    unsigned long getMistDurationMs() const { return mistDurationMs; }
+
+    // Absolute millis() value of the next state-relevant event (mist stop,
+    // window open/close, interval expiry). Calling update() before then is
+    // a no-op, so the main loop may sleep until this deadline.
+    unsigned long getNextEventMillis();
 
     // State management
     void loadState();
@@ -33,35 +43,94 @@ public:
     void setEnabled(bool enabled);
     bool isEnabled() const { return schedulerEnabled; }
 
-    // Manual control
+    // Write coalescing: with a non-zero quiet period, saveState() defers the
+    // commit until no further change was requested for quietMs. 0 = write
+    // immediately (default).
+    void setSaveCoalesceMs(unsigned long quietMs) { saveCoalesceMs = quietMs; }
+    bool hasPendingSave() const { return savePending; }
+    void flushPendingSave();
+
+    // Persistence counters: saves requested vs. writes that reached storage
+    unsigned long getSaveRequestCount() const { return saveRequestCount; }
+    unsigned long getSaveWriteCount() const { return saveWriteCount; }
+
+    // Optional mist history: every finished cycle is appended
+    void setJournal(IEventJournal* eventJournal) { journal = eventJournal; }
+
+    // Optional structured logging: messages go out as catalog events instead
+    // of being formatted here (see LogCatalog.h)
+    void setEventLogger(LogEventCallback callback) { eventLogger = callback; }
+
+    // Manual control: a forced mist runs for the configured duration unless
+    // one is given
     void forceMist();
+    void forceMist(unsigned long durationMs);
     void printStatus();
 
-    // Configuration
+    // Copy the schedule and state into another scheduler, typically one
+    // built with a detached relay and no storage, journal or cut-off timer:
+    // its update() then does the same work without side effects (BENCH)
+    void copyStateTo(MistingScheduler* copy) const;
+
+    // Runtime schedule configuration. setConfig() validates the whole config,
+    // swaps it in atomically and persists it; a mist already running keeps
+    // the duration it started with.
+    // @return false (config unchanged) if the config is invalid
+    bool setConfig(const ScheduleConfig& config);
+    ScheduleConfig getConfig() const { return configs.current(); }
+
+    // Default configuration, used until a config is loaded or set
     static const unsigned long MIST_DURATION = 25000;         // 25 seconds
     static const unsigned long MIST_INTERVAL_SECONDS = 7200;  // 2 hours in seconds
     static const int ACTIVE_WINDOW_START = 9;                 // 9am
     static const int ACTIVE_WINDOW_END = 18;                  // 6pm (exclusive)
 
+    // Timing
+    static const unsigned long SYNC_POLL_MS = 1000;           // Re-check time sync every second
+    static const unsigned long MAX_EVENT_WAIT_MS = 60000;     // Re-evaluate at least once a minute
+
 private:
     ITimeProvider* timeProvider;
     IRelayController* relayController;
     IStateStorage* stateStorage;
     LogCallback logger;
+    LogEventCallback eventLogger;
+    ICutoffTimer* cutoffTimer;    // Optional hardware cut-off (relay off at exact deadline)
+    IEventJournal* journal;       // Optional mist history
+    ScheduleConfigBuffer configs; // Live schedule, read once per update()
 
     MisterState currentState;
     time_t lastMistEpoch;         // Epoch time of last mist start (seconds)
     time_t lastKnownEpoch;        // Track last known epoch for time jump detection
     unsigned long mistStartTime;  // millis() when mist started (for duration)
+    unsigned long mistDurationMs; // Duration of the current mist, fixed at its start
     bool hasEverMisted;
     bool schedulerEnabled;
+    MistTrigger mistTrigger;      // What started the current mist
+
+    // Last record known to be in storage, for skipping identical writes
+    bool committedValid;
+    time_t committedLastMistEpoch;
+    bool committedHasEverMisted;
+    bool committedEnabled;
+
+    unsigned long saveCoalesceMs;
+    bool savePending;
+    unsigned long saveRequestedAt;  // millis() of the latest coalesced request
+    unsigned long saveRequestCount;
+    unsigned long saveWriteCount;
 
     // Internal logic methods
-    bool isInActiveWindow();
-    bool shouldStartMisting();
-    void startMisting();
-    void stopMisting();
-    void log(const char* message);
+    bool isInActiveWindow(const TimeSnapshot& now, const ScheduleConfig& config);
+    bool shouldStartMisting(const TimeSnapshot& now, const ScheduleConfig& config);
+    unsigned long secondsUntilNextEvent(const TimeSnapshot& now, const ScheduleConfig& config);
+    unsigned long getNextScheduleMillis(const TimeSnapshot& now, const ScheduleConfig& config);
+    void startMisting(const TimeSnapshot& now, MistTrigger trigger, unsigned long durationMs);
+    void stopMisting(unsigned long durationMs);
+    void recordMist(unsigned long durationMs, MistOutcome outcome);
+    bool isStateDirty() const;
+    void commitState();
+    void logEvent(uint8_t id, int32_t arg0 = 0, int32_t arg1 = 0, int32_t arg2 = 0);
 };
 
 #endif
@@ -0,0 +1,204 @@
+// src/MmapStateStorage.cpp
+#include "MmapStateStorage.h"
+#include "Crc32.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MmapStateStorage::MmapStateStorage(const char* path, LogCallback logger)
+    : path(path), logger(logger), map(nullptr), slotSize(0), activeSlot(-1) {
+    current = Slot();
+}
+
+MmapStateStorage::~MmapStateStorage() {
+    close();
+}
+
+bool MmapStateStorage::open() {
+    if (map) {
+        return true;
+    }
+
+    // One page per slot so each commit is a single-page msync
+    long pageSize = sysconf(_SC_PAGESIZE);
+    slotSize = ((sizeof(Slot) + pageSize - 1) / pageSize) * pageSize;
+    size_t fileSize = 2 * slotSize;
+
+    int fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        log("MMAP: Failed to open state file");
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || ((size_t)st.st_size < fileSize && ftruncate(fd, fileSize) != 0)) {
+        log("MMAP: Failed to size state file");
+        ::close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);  // The mapping keeps the file referenced
+    if (mapping == MAP_FAILED) {
+        log("MMAP: Failed to map state file");
+        return false;
+    }
+    map = (uint8_t*)mapping;
+
+    // Newest slot with a valid CRC wins
+    activeSlot = -1;
+    for (int i = 0; i < 2; i++) {
+        const Slot* slot = slotAt(i);
+        if (isSlotValid(*slot) && (activeSlot < 0 || slot->sequence > slotAt(activeSlot)->sequence)) {
+            activeSlot = i;
+        }
+    }
+
+    if (activeSlot >= 0) {
+        memcpy(&current, slotAt(activeSlot), sizeof(current));
+    } else {
+        current = Slot();
+        log("MMAP: No valid state, starting fresh");
+    }
+    return true;
+}
+
+void MmapStateStorage::close() {
+    if (map) {
+        munmap(map, 2 * slotSize);
+        map = nullptr;
+    }
+}
+
+unsigned long MmapStateStorage::getLastMistTime() {
+    unsigned long lastMistTime;
+    bool hasEverMisted, enabled;
+    load(&lastMistTime, &hasEverMisted, &enabled);
+    return lastMistTime;
+}
+
+bool MmapStateStorage::getHasEverMisted() {
+    unsigned long lastMistTime;
+    bool hasEverMisted, enabled;
+    load(&lastMistTime, &hasEverMisted, &enabled);
+    return hasEverMisted;
+}
+
+bool MmapStateStorage::getEnabled() {
+    unsigned long lastMistTime;
+    bool hasEverMisted, enabled;
+    load(&lastMistTime, &hasEverMisted, &enabled);
+    return enabled;
+}
+
+bool MmapStateStorage::load(unsigned long* lastMistTime, bool* hasEverMisted, bool* enabled) {
+    if (current.state.decode(lastMistTime, hasEverMisted, enabled)) {
+        return true;
+    }
+    *lastMistTime = 0;
+    *hasEverMisted = false;
+    *enabled = true;
+    return false;
+}
+
+bool MmapStateStorage::save(unsigned long lastMistTime, bool hasEverMisted, bool enabled) {
+    Slot slot = current;
+    slot.state.encode(lastMistTime, hasEverMisted, enabled);
+    return commit(slot);
+}
+
+bool MmapStateStorage::loadNetworkCache(NetworkCache* cache) {
+    if (!current.network.valid) {
+        return false;
+    }
+    *cache = current.network;
+    return true;
+}
+
+bool MmapStateStorage::saveNetworkCache(const NetworkCache& cache) {
+    Slot slot = current;
+    slot.network = cache;
+    return commit(slot);
+}
+
+bool MmapStateStorage::loadZoneState(void* record, size_t length) {
+    if (current.zoneLength == 0 || current.zoneLength != length) {
+        return false;
+    }
+    memcpy(record, current.zoneState, length);
+    return true;
+}
+
+bool MmapStateStorage::saveZoneState(const void* record, size_t length) {
+    if (length > MAX_ZONE_STATE) {
+        log("MMAP: Zone state too large");
+        return false;
+    }
+    Slot slot = current;
+    memcpy(slot.zoneState, record, length);
+    slot.zoneLength = (uint32_t)length;
+    return commit(slot);
+}
+
+bool MmapStateStorage::loadScheduleConfig(void* record, size_t length) {
+    if (length != sizeof(current.config) || current.config.version == 0) {
+        return false;
+    }
+    memcpy(record, &current.config, length);
+    return true;
+}
+
+bool MmapStateStorage::saveScheduleConfig(const void* record, size_t length) {
+    if (length != sizeof(ScheduleConfigRecord)) {
+        log("MMAP: Schedule config size mismatch");
+        return false;
+    }
+    Slot slot = current;
+    memcpy(&slot.config, record, length);
+    return commit(slot);
+}
+
+bool MmapStateStorage::commit(Slot& slot) {
+    if (!map) {
+        log("MMAP: State file not open");
+        return false;
+    }
+
+    slot.magic = SLOT_MAGIC;
+    slot.sequence = current.sequence + 1;
+    slot.crc = slotCrc(slot);
+
+    // Never touch the active slot: a crash from here on leaves it intact
+    int target = (activeSlot == 0) ? 1 : 0;
+    uint8_t* page = map + target * slotSize;
+    memcpy(page, &slot, sizeof(slot));
+    if (msync(page, slotSize, MS_SYNC) != 0) {
+        log("MMAP: msync failed");
+        return false;
+    }
+
+    activeSlot = target;
+    current = slot;
+    return true;
+}
+
+MmapStateStorage::Slot* MmapStateStorage::slotAt(int index) const {
+    return (Slot*)(map + index * slotSize);
+}
+
+uint32_t MmapStateStorage::slotCrc(const Slot& slot) {
+    return crc32(&slot, offsetof(Slot, crc));
+}
+
+bool MmapStateStorage::isSlotValid(const Slot& slot) {
+    return slot.magic == SLOT_MAGIC && slot.crc == slotCrc(slot);
+}
+
+void MmapStateStorage::log(const char* message) {
+    if (logger) {
+        logger(message);
+    }
+}
@@ -0,0 +1,86 @@
+// src/MmapStateStorage.h
+#ifndef MMAP_STATE_STORAGE_H
+#define MMAP_STATE_STORAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "IStateStorage.h"
+#include "StateRecord.h"
+#include "ScheduleConfig.h"
+
+// Logging callback type
+typedef void (*LogCallback)(const char* message);
+
+/**
+ * POSIX file-backed implementation of IStateStorage for Linux hosts and
+ * long-running simulations (not built for the ESP32).
+ *
+ * The state file holds two page-aligned slots, each a complete copy of
+ * all persisted state with a sequence number and CRC. A save fills the
+ * inactive slot in the memory mapping and msync()s that page; the newest
+ * slot with a valid CRC wins on open. A crash mid-save leaves a torn
+ * inactive slot and the previous commit intact. Saves need no
+ * open/write/close syscalls, only the msync.
+ */
+class MmapStateStorage : public IStateStorage {
+public:
+    static const size_t MAX_ZONE_STATE = 128;
+
+    MmapStateStorage(const char* path, LogCallback logger = nullptr);
+    ~MmapStateStorage();
+
+    /**
+     * Create or map the state file and select the newest valid slot.
+     * @return false if the file cannot be created or mapped
+     */
+    bool open();
+    void close();
+    bool isOpen() const { return map != nullptr; }
+
+    // IStateStorage interface implementation
+    unsigned long getLastMistTime() override;
+    bool getHasEverMisted() override;
+    bool getEnabled() override;
+    bool save(unsigned long lastMistTime, bool hasEverMisted, bool enabled) override;
+    bool load(unsigned long* lastMistTime, bool* hasEverMisted, bool* enabled) override;
+    bool loadNetworkCache(NetworkCache* cache) override;
+    bool saveNetworkCache(const NetworkCache& cache) override;
+    bool loadZoneState(void* record, size_t length) override;
+    bool saveZoneState(const void* record, size_t length) override;
+    bool loadScheduleConfig(void* record, size_t length) override;
+    bool saveScheduleConfig(const void* record, size_t length) override;
+
+    // Inspection
+    int getActiveSlot() const { return activeSlot; }
+    uint32_t getSequence() const { return current.sequence; }
+    size_t getSlotSize() const { return slotSize; }
+
+private:
+    struct Slot {
+        uint32_t magic;
+        uint32_t sequence;
+        StateRecord state;
+        NetworkCache network;
+        uint32_t zoneLength;
+        uint8_t zoneState[MAX_ZONE_STATE];
+        ScheduleConfigRecord config;
+        uint32_t crc;
+    };
+
+    static const uint32_t SLOT_MAGIC = 0x4D535446;  // "MSTF"
+
+    const char* path;
+    LogCallback logger;
+    uint8_t* map;
+    size_t slotSize;
+    int activeSlot;      // -1 until the first commit of a fresh file
+    Slot current;        // Copy of the active slot
+
+    bool commit(Slot& slot);
+    Slot* slotAt(int index) const;
+    static uint32_t slotCrc(const Slot& slot);
+    static bool isSlotValid(const Slot& slot);
+    void log(const char* message);
+};
+
+#endif
@@ -0,0 +1,307 @@
+// src/MultiZoneScheduler.cpp
+#include "MultiZoneScheduler.h"
+#include <string.h>
+
+MultiZoneScheduler::MultiZoneScheduler(ITimeProvider* timeProvider, IStateStorage* stateStorage, LogCallback logger)
+    : timeProvider(timeProvider), stateStorage(stateStorage), logger(logger), eventLogger(nullptr), zoneCount(0), lastKnownEpoch(0) {
+    memset(zoneState, WAITING_SYNC, sizeof(zoneState));
+    memset(zoneFlags, 0, sizeof(zoneFlags));
+    memset(lastMistEpoch, 0, sizeof(lastMistEpoch));
+    memset(mistStartTime, 0, sizeof(mistStartTime));
+    memset(relays, 0, sizeof(relays));
+    memset(cutoffTimers, 0, sizeof(cutoffTimers));
+    memset(durationMs, 0, sizeof(durationMs));
+    memset(intervalSeconds, 0, sizeof(intervalSeconds));
+    memset(windowStartHour, 0, sizeof(windowStartHour));
+    memset(windowEndHour, 0, sizeof(windowEndHour));
+}
+
+int MultiZoneScheduler::addZone(IRelayController* relay, const ZoneConfig& config, ICutoffTimer* cutoffTimer) {
+    if (zoneCount >= MAX_ZONES) {
+        logEvent(LOG_MSG_ZONE_TABLE_FULL);
+        return -1;
+    }
+    // Same duration and interval limits as the single-zone schedule; the
+    // window must not wrap past midnight
+    ScheduleConfig limits(config.durationMs, config.intervalSeconds, config.windowStartHour, config.windowEndHour);
+    if (!relay || !limits.isValid() ||
+        config.windowStartHour >= config.windowEndHour || config.windowEndHour > 24) {
+        logEvent(LOG_MSG_ZONE_INVALID_CONFIG);
+        return -1;
+    }
+
+    uint8_t zone = zoneCount++;
+    relays[zone] = relay;
+    cutoffTimers[zone] = cutoffTimer;
+    durationMs[zone] = config.durationMs;
+    intervalSeconds[zone] = config.intervalSeconds;
+    windowStartHour[zone] = config.windowStartHour;
+    windowEndHour[zone] = config.windowEndHour;
+    zoneState[zone] = WAITING_SYNC;
+    zoneFlags[zone] = FLAG_ENABLED;
+    return zone;
+}
+
+void MultiZoneScheduler::update() {
+    // Read all clocks once so every zone in this tick sees the same time
+    TimeSnapshot now;
+    timeProvider->getSnapshot(&now);
+    checkTimeJump(now);
+
+    bool dirty = false;
+    for (uint8_t zone = 0; zone < zoneCount; zone++) {
+        // A running mist always finishes, even if the zone was disabled mid-cycle
+        if (zoneState[zone] == MISTING) {
+            unsigned long elapsed = now.millis - mistStartTime[zone];
+            bool cutOff = cutoffTimers[zone] && cutoffTimers[zone]->hasFired();
+            if (elapsed >= durationMs[zone] * 3 && !cutOff) {
+                // Safety failsafe: no cut-off timer stopped the mist and the
+                // loop stalled past 3x its duration
+                forceStopMisting(zone);
+            } else if (cutOff || elapsed >= durationMs[zone]) {
+                // Relay may already be off (cut-off timer); finish the bookkeeping
+                stopMisting(zone);
+                dirty = true;
+            }
+            continue;
+        }
+
+        if (!(zoneFlags[zone] & FLAG_ENABLED)) {
+            continue;
+        }
+
+        if (zoneState[zone] == WAITING_SYNC) {
+            if (!now.localValid) {
+                continue;
+            }
+            zoneState[zone] = IDLE;
+        }
+
+        if (shouldStartMisting(zone, now)) {
+            startMisting(zone, now);
+        }
+    }
+
+    // Zones finishing in the same tick share one write
+    if (dirty) {
+        saveState();
+    }
+}
+
+void MultiZoneScheduler::checkTimeJump(const TimeSnapshot& now) {
+    time_t currentEpoch = now.epoch;
+    if (lastKnownEpoch > 0 && currentEpoch > 0) {
+        time_t timeDelta = (currentEpoch > lastKnownEpoch) ?
+                           (currentEpoch - lastKnownEpoch) :
+                           (lastKnownEpoch - currentEpoch);
+
+        // If time jumped more than 5 minutes, log it
+        if (timeDelta > 300) {
+            logEvent(LOG_MSG_TIME_JUMP, (int32_t)timeDelta);
+        }
+    }
+    if (currentEpoch > 0) {
+        // A last mist stamped by a clock that ran ahead (corrected by NTP)
+        // would hold its zone off until real time caught up; count the
+        // interval from now instead
+        for (uint8_t zone = 0; zone < zoneCount; zone++) {
+            if ((time_t)lastMistEpoch[zone] > currentEpoch) {
+                lastMistEpoch[zone] = (uint32_t)currentEpoch;
+            }
+        }
+    }
+    lastKnownEpoch = currentEpoch;
+}
+
+bool MultiZoneScheduler::shouldStartMisting(uint8_t zone, const TimeSnapshot& now) {
+    if (!now.localValid) return false;
+
+    int hour = now.local.tm_hour;
+    if (hour < windowStartHour[zone] || hour >= windowEndHour[zone]) return false;
+
+    // First mist
+    if (!(zoneFlags[zone] & FLAG_HAS_EVER_MISTED)) return true;
+
+    if (now.epoch == 0 || lastMistEpoch[zone] == 0) {
+        return false;  // Time not available
+    }
+
+    time_t elapsed = now.epoch - (time_t)lastMistEpoch[zone];
+    return (elapsed >= (time_t)intervalSeconds[zone]);
+}
+
+unsigned long MultiZoneScheduler::getNextEventMillis() {
+    TimeSnapshot snapshot;
+    timeProvider->getSnapshot(&snapshot);
+    unsigned long now = snapshot.millis;
+
+    // Cap the wait so wall-clock jumps (NTP, DST) are picked up promptly
+    unsigned long waitMs = MistingScheduler::MAX_EVENT_WAIT_MS;
+    for (uint8_t zone = 0; zone < zoneCount; zone++) {
+        unsigned long zoneWaitMs;
+        if (zoneState[zone] == MISTING) {
+            unsigned long elapsed = now - mistStartTime[zone];
+            zoneWaitMs = (elapsed >= durationMs[zone]) ? 0 : durationMs[zone] - elapsed;
+        } else if (!(zoneFlags[zone] & FLAG_ENABLED)) {
+            continue;
+        } else if (zoneState[zone] == WAITING_SYNC && !snapshot.localValid) {
+            zoneWaitMs = MistingScheduler::SYNC_POLL_MS;
+        } else {
+            unsigned long waitSeconds = secondsUntilNextEvent(zone, snapshot);
+            if (waitSeconds >= MistingScheduler::MAX_EVENT_WAIT_MS / 1000) {
+                continue;
+            }
+            zoneWaitMs = waitSeconds * 1000;
+        }
+
+        if (zoneWaitMs < waitMs) {
+            waitMs = zoneWaitMs;
+        }
+    }
+    return now + waitMs;
+}
+
+unsigned long MultiZoneScheduler::secondsUntilNextEvent(uint8_t zone, const TimeSnapshot& now) {
+    if (!now.localValid) {
+        return MistingScheduler::SYNC_POLL_MS / 1000;
+    }
+
+    long secondOfDay = now.local.tm_hour * 3600L + now.local.tm_min * 60L + now.local.tm_sec;
+    long windowStart = windowStartHour[zone] * 3600L;
+    long windowEnd = windowEndHour[zone] * 3600L;
+
+    // Outside the window the next event is the window opening
+    if (secondOfDay < windowStart) {
+        return windowStart - secondOfDay;
+    }
+    if (secondOfDay >= windowEnd) {
+        return 86400L - secondOfDay + windowStart;
+    }
+
+    // Inside the window: next event is interval expiry or window close
+    long untilWindowEnd = windowEnd - secondOfDay;
+    if (!(zoneFlags[zone] & FLAG_HAS_EVER_MISTED)) {
+        return 0;  // First mist is due now
+    }
+
+    if (now.epoch == 0 || lastMistEpoch[zone] == 0) {
+        return MistingScheduler::SYNC_POLL_MS / 1000;  // Time not available, poll
+    }
+
+    time_t elapsed = now.epoch - (time_t)lastMistEpoch[zone];
+    if (elapsed >= (time_t)intervalSeconds[zone]) {
+        return 0;
+    }
+
+    long untilInterval = (long)(intervalSeconds[zone] - elapsed);
+    return (untilInterval < untilWindowEnd) ? untilInterval : untilWindowEnd;
+}
+
+void MultiZoneScheduler::startMisting(uint8_t zone, const TimeSnapshot& now) {
+    relays[zone]->turnOn();
+    mistStartTime[zone] = now.millis;
+    if (cutoffTimers[zone] && !cutoffTimers[zone]->arm(durationMs[zone])) {
+        logEvent(LOG_MSG_ZONE_CUTOFF_ARM_FAILED, zone);
+    }
+    lastMistEpoch[zone] = (uint32_t)now.epoch;
+    zoneState[zone] = MISTING;
+    zoneFlags[zone] |= FLAG_HAS_EVER_MISTED;
+    logEvent(LOG_MSG_ZONE_MIST_START, zone);
+    // Don't save here - save only on successful completion (reduces NVS writes)
+}
+
+void MultiZoneScheduler::stopMisting(uint8_t zone) {
+    relays[zone]->turnOff();
+    if (cutoffTimers[zone]) {
+        cutoffTimers[zone]->cancel();
+    }
+    zoneState[zone] = IDLE;
+    logEvent(LOG_MSG_ZONE_MIST_STOP, zone);
+}
+
+void MultiZoneScheduler::forceStopMisting(uint8_t zone) {
+    logEvent(LOG_MSG_ZONE_MIST_FAILSAFE, zone);
+    relays[zone]->turnOff();
+    if (cutoffTimers[zone]) {
+        cutoffTimers[zone]->cancel();
+    }
+    zoneState[zone] = IDLE;
+    // Not saved: this is an error condition, not a completed mist
+}
+
+void MultiZoneScheduler::setZoneEnabled(uint8_t zone, bool enabled) {
+    if (zone >= zoneCount) {
+        return;
+    }
+
+    if (enabled) {
+        zoneFlags[zone] |= FLAG_ENABLED;
+    } else {
+        zoneFlags[zone] &= ~FLAG_ENABLED;
+    }
+    logEvent(enabled ? LOG_MSG_ZONE_ENABLED : LOG_MSG_ZONE_DISABLED, zone);
+    saveState();
+}
+
+bool MultiZoneScheduler::forceMist(uint8_t zone) {
+    if (zone >= zoneCount) {
+        logEvent(LOG_MSG_ZONE_NOT_FOUND);
+        return false;
+    }
+    if (zoneState[zone] == MISTING) {
+        logEvent(LOG_MSG_ZONE_FORCE_ALREADY_MISTING, zone);
+        return false;
+    }
+    if (!(zoneFlags[zone] & FLAG_ENABLED)) {
+        logEvent(LOG_MSG_ZONE_FORCE_DISABLED, zone);
+        return false;
+    }
+
+    logEvent(LOG_MSG_ZONE_FORCE_MIST, zone);
+    TimeSnapshot now;
+    timeProvider->getSnapshot(&now);
+    startMisting(zone, now);
+    return true;
+}
+
+void MultiZoneScheduler::loadState() {
+    if (!stateStorage) {
+        return;
+    }
+
+    ZoneStateRecord record;
+    if (!stateStorage->loadZoneState(&record, sizeof(record))) {
+        return;
+    }
+    if (!record.isValid() || record.zoneCount > MAX_ZONES) {
+        logEvent(LOG_MSG_ZONE_STATE_IGNORED);
+        return;
+    }
+
+    // Zones added or removed since the record was written keep their defaults
+    uint8_t count = (record.zoneCount < zoneCount) ? record.zoneCount : zoneCount;
+    memcpy(lastMistEpoch, record.lastMistEpoch, count * sizeof(lastMistEpoch[0]));
+    memcpy(zoneFlags, record.flags, count * sizeof(zoneFlags[0]));
+
+    logEvent(LOG_MSG_ZONE_STATE_LOADED, count);
+}
+
+void MultiZoneScheduler::saveState() {
+    if (!stateStorage) {
+        return;
+    }
+
+    ZoneStateRecord record;
+    record.zoneCount = zoneCount;
+    memcpy(record.lastMistEpoch, lastMistEpoch, sizeof(record.lastMistEpoch));
+    memcpy(record.flags, zoneFlags, sizeof(record.flags));
+    record.seal();
+
+    if (!stateStorage->saveZoneState(&record, sizeof(record))) {
+        logEvent(LOG_MSG_ZONE_STATE_SAVE_FAILED);
+    }
+}
+
+void MultiZoneScheduler::logEvent(uint8_t id, int32_t arg0) {
+    emitLogEvent(eventLogger, logger, id, arg0);
+}
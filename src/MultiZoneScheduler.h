@@ -0,0 +1,147 @@
+// src/MultiZoneScheduler.h
+#ifndef MULTI_ZONE_SCHEDULER_H
+#define MULTI_ZONE_SCHEDULER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "Crc32.h"
+#include "ICutoffTimer.h"
+#include "ITimeProvider.h"
+#include "IRelayController.h"
+#include "IStateStorage.h"
+#include "LogEvent.h"
+#include "MistingScheduler.h"
+
+/**
+ * Per-zone timing. Each zone mists for durationMs every intervalSeconds
+ * while the local hour is in [windowStartHour, windowEndHour). Duration and
+ * interval have the same limits as ScheduleConfig.
+ */
+struct ZoneConfig {
+    unsigned long durationMs;
+    unsigned long intervalSeconds;
+    uint8_t windowStartHour;
+    uint8_t windowEndHour;
+};
+
+/**
+ * Drives up to MAX_ZONES independent mist zones, each with its own relay,
+ * duration, interval and active window.
+ *
+ * Per-zone state is kept as a struct-of-arrays table so the single update()
+ * pass walks small contiguous arrays, and is persisted as one ZoneStateRecord
+ * (one flash write) instead of one key per field per zone.
+ *
+ * Each zone gets the same protection as MistingScheduler: an optional
+ * cut-off timer stops the relay at the deadline, and a mist still running
+ * after 3x its duration is forced off.
+ */
+class MultiZoneScheduler {
+public:
+    static const uint8_t MAX_ZONES = 16;
+
+    // Per-zone flag bits (persisted)
+    static const uint8_t FLAG_ENABLED = 0x01;
+    static const uint8_t FLAG_HAS_EVER_MISTED = 0x02;
+
+    MultiZoneScheduler(ITimeProvider* timeProvider, IStateStorage* stateStorage = nullptr, LogCallback logger = nullptr);
+
+    /**
+     * Register a zone. Call before loadState().
+     * @param cutoffTimer Optional one-shot timer that turns this zone's relay off
+     * @return Zone index, or -1 if the table is full or the config is invalid
+     */
+    int addZone(IRelayController* relay, const ZoneConfig& config, ICutoffTimer* cutoffTimer = nullptr);
+    uint8_t getZoneCount() const { return zoneCount; }
+
+    // Optional structured logging (see MistingScheduler::setEventLogger)
+    void setEventLogger(LogEventCallback callback) { eventLogger = callback; }
+
+    // Call from main loop: one time snapshot, one pass over all zones
+    void update();
+
+    // Earliest absolute millis() deadline over all zones (see MistingScheduler)
+    unsigned long getNextEventMillis();
+
+    // Per-zone query; an unknown zone reads as WAITING_SYNC, never misted, disabled
+    MisterState getZoneState(uint8_t zone) const {
+        return (zone < zoneCount) ? (MisterState)zoneState[zone] : WAITING_SYNC;
+    }
+    time_t getZoneLastMistEpoch(uint8_t zone) const { return (zone < zoneCount) ? (time_t)lastMistEpoch[zone] : 0; }
+    bool isZoneEnabled(uint8_t zone) const { return zone < zoneCount && (zoneFlags[zone] & FLAG_ENABLED) != 0; }
+    bool hasZoneEverMisted(uint8_t zone) const {
+        return zone < zoneCount && (zoneFlags[zone] & FLAG_HAS_EVER_MISTED) != 0;
+    }
+
+    // Per-zone control
+    void setZoneEnabled(uint8_t zone, bool enabled);
+    bool forceMist(uint8_t zone);
+
+    // State management (all zones in one record)
+    void loadState();
+    void saveState();
+
+private:
+    ITimeProvider* timeProvider;
+    IStateStorage* stateStorage;
+    LogCallback logger;
+    LogEventCallback eventLogger;
+    uint8_t zoneCount;
+    time_t lastKnownEpoch;               // Track last known epoch for time jump detection
+
+    // Hot per-tick state
+    uint8_t zoneState[MAX_ZONES];        // MisterState
+    uint8_t zoneFlags[MAX_ZONES];        // FLAG_* bits
+    uint32_t lastMistEpoch[MAX_ZONES];   // Epoch seconds of last mist start
+    unsigned long mistStartTime[MAX_ZONES];  // millis() when the current mist started
+
+    // Configuration
+    IRelayController* relays[MAX_ZONES];
+    ICutoffTimer* cutoffTimers[MAX_ZONES];  // Optional, per zone
+    uint32_t durationMs[MAX_ZONES];
+    uint32_t intervalSeconds[MAX_ZONES];
+    uint8_t windowStartHour[MAX_ZONES];
+    uint8_t windowEndHour[MAX_ZONES];
+
+    bool shouldStartMisting(uint8_t zone, const TimeSnapshot& now);
+    unsigned long secondsUntilNextEvent(uint8_t zone, const TimeSnapshot& now);
+    void startMisting(uint8_t zone, const TimeSnapshot& now);
+    void stopMisting(uint8_t zone);
+    void forceStopMisting(uint8_t zone);
+    void checkTimeJump(const TimeSnapshot& now);
+    void logEvent(uint8_t id, int32_t arg0 = 0);
+};
+
+/**
+ * Persisted form of the per-zone state table. Only the fields that must
+ * survive a reboot are stored; zone configuration comes from firmware.
+ * Sealed with a CRC like StateRecord, so a torn write is rejected on load.
+ *
+ * Layout (88 bytes, little-endian on ESP32):
+ *   version(1) zoneCount(1) reserved(2) lastMistEpoch(4 x 16) flags(1 x 16) crc(4)
+ */
+struct ZoneStateRecord {
+    static const uint8_t VERSION = 2;
+
+    uint8_t version;
+    uint8_t zoneCount;
+    uint8_t reserved[2];
+    uint32_t lastMistEpoch[MultiZoneScheduler::MAX_ZONES];
+    uint8_t flags[MultiZoneScheduler::MAX_ZONES];
+    uint32_t crc;
+
+    ZoneStateRecord() { memset(this, 0, sizeof(*this)); }
+
+    // Set the version and seal the record with a CRC
+    void seal() {
+        version = VERSION;
+        crc = computeCrc();
+    }
+
+    bool isValid() const { return version == VERSION && crc == computeCrc(); }
+
+    uint32_t computeCrc() const { return crc32(this, offsetof(ZoneStateRecord, crc)); }
+};
+
+#endif
@@ -3,12 +3,14 @@
 #define NTP_TIME_PROVIDER_H
 
 #include "ITimeProvider.h"
+#include "LocalTimeCache.h"
+#include "PosixTimeZone.h"
 #include <Arduino.h>
 
 class NTPTimeProvider : public ITimeProvider {
 public:
     bool getTime(struct tm* timeinfo) override {
-        return getLocalTime(timeinfo);
+        return toLocal(getEpochTime(), timeinfo);
     }
 
     unsigned long getMillis() override {
@@ -20,6 +22,35 @@ public:
         time(&now);
         return now;
     }
+
+    bool getSnapshot(TimeSnapshot* snapshot) override {
+        snapshot->millis = millis();
+        snapshot->epoch = getEpochTime();
+        snapshot->localValid = toLocal(snapshot->epoch, &snapshot->local);
+        return snapshot->localValid;
+    }
+
+    // Convert with a precomputed transition table for this POSIX TZ string
+    // instead of newlib's localtime_r. Falls back to libc if it fails to parse.
+    bool setTimeZone(const char* tz) {
+        bool parsed = timeZone.parse(tz);
+        localTime.setTimeZone(parsed ? &timeZone : nullptr);
+        return parsed;
+    }
+
+    // Call after the TZ rules change (configTzTime)
+    void invalidateLocalTime() { localTime.invalidate(); }
+
+private:
+    PosixTimeZone timeZone;
+    LocalTimeCache localTime;
+
+    // Same validity rule as getLocalTime(): clock is set once the year is past 2016,
+    // but without its up-to-5s polling wait before sync
+    bool toLocal(time_t epoch, struct tm* timeinfo) {
+        localTime.toLocal(epoch, timeinfo);
+        return timeinfo->tm_year > (2016 - 1900);
+    }
 };
 
 #endif
@@ -1,11 +1,16 @@
 // src/NVSStateStorage.cpp
 #include "NVSStateStorage.h"
+#include "StateRecord.h"
 
-// NVS namespace and keys
+// NVS namespace and keys (lastMist/hasEverMist/enabled are legacy, read for migration only)
 const char* NVSStateStorage::NVS_NAMESPACE = "misting";
 const char* NVSStateStorage::KEY_LAST_MIST_TIME = "lastMist";
 const char* NVSStateStorage::KEY_HAS_EVER_MISTED = "hasEverMist";
 const char* NVSStateStorage::KEY_ENABLED = "enabled";
+const char* NVSStateStorage::KEY_STATE = "state";
+const char* NVSStateStorage::KEY_NETWORK_CACHE = "netCache";
+const char* NVSStateStorage::KEY_ZONE_STATE = "zoneState";
+const char* NVSStateStorage::KEY_SCHEDULE_CONFIG = "schedConfig";
 
 NVSStateStorage::NVSStateStorage(LogCallback logger)
     : logger(logger) {
@@ -17,75 +22,173 @@ NVSStateStorage::~NVSStateStorage() {
 }
 
 unsigned long NVSStateStorage::getLastMistTime() {
+    unsigned long lastMistTime;
+    bool hasEverMisted, enabled;
+    load(&lastMistTime, &hasEverMisted, &enabled);
+    return lastMistTime;
+}
+
+bool NVSStateStorage::getHasEverMisted() {
+    unsigned long lastMistTime;
+    bool hasEverMisted, enabled;
+    load(&lastMistTime, &hasEverMisted, &enabled);
+    return hasEverMisted;
+}
+
+bool NVSStateStorage::getEnabled() {
+    unsigned long lastMistTime;
+    bool hasEverMisted, enabled;
+    load(&lastMistTime, &hasEverMisted, &enabled);
+    return enabled;
+}
+
+bool NVSStateStorage::load(unsigned long* lastMistTime, bool* hasEverMisted, bool* enabled) {
+    // Defaults if nothing (valid) is stored
+    *lastMistTime = 0;
+    *hasEverMisted = false;
+    *enabled = true;
+
     if (!preferences.begin(NVS_NAMESPACE, true)) {  // read-only mode
-        log("NVS: Failed to open namespace for reading lastMistTime");
-        return 0;
+        log("NVS: Failed to open namespace for reading state");
+        return false;
     }
 
-    unsigned long value = preferences.getULong(KEY_LAST_MIST_TIME, 0);
+    bool loaded = false;
+    size_t length = preferences.getBytesLength(KEY_STATE);
+    if (length > 0) {
+        StateRecord record;
+        if (length == sizeof(record) &&
+            preferences.getBytes(KEY_STATE, &record, sizeof(record)) == sizeof(record) &&
+            record.decode(lastMistTime, hasEverMisted, enabled)) {
+            loaded = true;
+        } else {
+            log("NVS: State record corrupt or wrong version, using defaults");
+        }
+    } else if (preferences.isKey(KEY_LAST_MIST_TIME)) {
+        // Firmware before the packed record: read the legacy keys once,
+        // the next save() migrates them
+        *lastMistTime = preferences.getULong(KEY_LAST_MIST_TIME, 0);
+        *hasEverMisted = preferences.getBool(KEY_HAS_EVER_MISTED, false);
+        *enabled = preferences.getBool(KEY_ENABLED, true);
+        loaded = true;
+        log("NVS: Loaded legacy state keys");
+    }
     preferences.end();
 
-    return value;
+    return loaded;
 }
 
-bool NVSStateStorage::getHasEverMisted() {
-    if (!preferences.begin(NVS_NAMESPACE, true)) {  // read-only mode
-        log("NVS: Failed to open namespace for reading hasEverMisted");
+bool NVSStateStorage::save(unsigned long lastMistTime, bool hasEverMisted, bool enabled) {
+    if (!preferences.begin(NVS_NAMESPACE, false)) {  // read-write mode
+        log("NVS: Failed to open namespace for writing");
         return false;
     }
 
-    bool value = preferences.getBool(KEY_HAS_EVER_MISTED, false);
+    // Single entry write: the record commits atomically or fails its CRC
+    StateRecord record;
+    record.encode(lastMistTime, hasEverMisted, enabled);
+    bool success = preferences.putBytes(KEY_STATE, &record, sizeof(record)) == sizeof(record);
+
+    // Drop the legacy keys once the packed record is committed
+    if (success && preferences.isKey(KEY_LAST_MIST_TIME)) {
+        preferences.remove(KEY_LAST_MIST_TIME);
+        preferences.remove(KEY_HAS_EVER_MISTED);
+        preferences.remove(KEY_ENABLED);
+        log("NVS: Migrated legacy state keys");
+    }
+
     preferences.end();
 
-    return value;
+    if (success) {
+        log("NVS: State saved successfully");
+    } else {
+        log("NVS: State save failed");
+    }
+
+    return success;
 }
 
-bool NVSStateStorage::getEnabled() {
+bool NVSStateStorage::loadNetworkCache(NetworkCache* cache) {
     if (!preferences.begin(NVS_NAMESPACE, true)) {  // read-only mode
-        log("NVS: Failed to open namespace for reading enabled");
-        return true;  // Default to enabled if NVS fails
+        log("NVS: Failed to open namespace for reading network cache");
+        return false;
     }
 
-    bool value = preferences.getBool(KEY_ENABLED, true);
+    bool loaded = false;
+    if (preferences.getBytesLength(KEY_NETWORK_CACHE) == sizeof(NetworkCache)) {
+        loaded = preferences.getBytes(KEY_NETWORK_CACHE, cache, sizeof(NetworkCache)) == sizeof(NetworkCache);
+    }
     preferences.end();
 
-    return value;
+    return loaded && cache->valid;
 }
 
-bool NVSStateStorage::save(unsigned long lastMistTime, bool hasEverMisted, bool enabled) {
+bool NVSStateStorage::saveNetworkCache(const NetworkCache& cache) {
     if (!preferences.begin(NVS_NAMESPACE, false)) {  // read-write mode
         log("NVS: Failed to open namespace for writing");
         return false;
     }
 
-    bool success = true;
+    bool success = preferences.putBytes(KEY_NETWORK_CACHE, &cache, sizeof(cache)) == sizeof(cache);
+    preferences.end();
+
+    log(success ? "NVS: Network cache saved" : "NVS: Network cache save failed");
+    return success;
+}
 
-    // Save lastMistTime
-    if (preferences.putULong(KEY_LAST_MIST_TIME, lastMistTime) == 0) {
-        log("NVS: Failed to write lastMistTime");
-        success = false;
+bool NVSStateStorage::loadZoneState(void* record, size_t length) {
+    if (!preferences.begin(NVS_NAMESPACE, true)) {  // read-only mode
+        log("NVS: Failed to open namespace for reading zone state");
+        return false;
     }
 
-    // Save hasEverMisted
-    if (preferences.putBool(KEY_HAS_EVER_MISTED, hasEverMisted) == 0) {
-        log("NVS: Failed to write hasEverMisted");
-        success = false;
+    bool loaded = false;
+    if (preferences.getBytesLength(KEY_ZONE_STATE) == length) {
+        loaded = preferences.getBytes(KEY_ZONE_STATE, record, length) == length;
     }
+    preferences.end();
+
+    return loaded;
+}
 
-    // Save enabled
-    if (preferences.putBool(KEY_ENABLED, enabled) == 0) {
-        log("NVS: Failed to write enabled");
-        success = false;
+bool NVSStateStorage::saveZoneState(const void* record, size_t length) {
+    if (!preferences.begin(NVS_NAMESPACE, false)) {  // read-write mode
+        log("NVS: Failed to open namespace for writing");
+        return false;
     }
 
+    bool success = preferences.putBytes(KEY_ZONE_STATE, record, length) == length;
     preferences.end();
 
-    if (success) {
-        log("NVS: State saved successfully");
-    } else {
-        log("NVS: State save failed");
+    log(success ? "NVS: Zone state saved" : "NVS: Zone state save failed");
+    return success;
+}
+
+bool NVSStateStorage::loadScheduleConfig(void* record, size_t length) {
+    if (!preferences.begin(NVS_NAMESPACE, true)) {  // read-only mode
+        log("NVS: Failed to open namespace for reading schedule config");
+        return false;
+    }
+
+    bool loaded = false;
+    if (preferences.getBytesLength(KEY_SCHEDULE_CONFIG) == length) {
+        loaded = preferences.getBytes(KEY_SCHEDULE_CONFIG, record, length) == length;
     }
+    preferences.end();
+
+    return loaded;
+}
+
+bool NVSStateStorage::saveScheduleConfig(const void* record, size_t length) {
+    if (!preferences.begin(NVS_NAMESPACE, false)) {  // read-write mode
+        log("NVS: Failed to open namespace for writing");
+        return false;
+    }
+
+    bool success = preferences.putBytes(KEY_SCHEDULE_CONFIG, record, length) == length;
+    preferences.end();
 
+    log(success ? "NVS: Schedule config saved" : "NVS: Schedule config save failed");
     return success;
 }
 
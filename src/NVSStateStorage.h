@@ -11,7 +11,9 @@ typedef void (*LogCallback)(const char* message);
 /**
  * ESP32 Non-Volatile Storage (NVS) implementation of IStateStorage.
  * Uses the Preferences library to store state data in flash memory
- * that persists across power cycles and reboots.
+ * that persists across power cycles and reboots. Scheduler state is kept
+ * as one CRC-protected StateRecord blob: one entry write per save and one
+ * namespace open per load.
  */
 class NVSStateStorage : public IStateStorage {
 public:
@@ -31,6 +33,13 @@ public:
     bool getHasEverMisted() override;
     bool getEnabled() override;
     bool save(unsigned long lastMistTime, bool hasEverMisted, bool enabled) override;
+    bool load(unsigned long* lastMistTime, bool* hasEverMisted, bool* enabled) override;
+    bool loadNetworkCache(NetworkCache* cache) override;
+    bool saveNetworkCache(const NetworkCache& cache) override;
+    bool loadZoneState(void* record, size_t length) override;
+    bool saveZoneState(const void* record, size_t length) override;
+    bool loadScheduleConfig(void* record, size_t length) override;
+    bool saveScheduleConfig(const void* record, size_t length) override;
 
 private:
     Preferences preferences;
@@ -40,9 +49,13 @@ private:
 
     // NVS keys
     static const char* NVS_NAMESPACE;
+    static const char* KEY_STATE;
     static const char* KEY_LAST_MIST_TIME;
     static const char* KEY_HAS_EVER_MISTED;
     static const char* KEY_ENABLED;
+    static const char* KEY_NETWORK_CACHE;
+    static const char* KEY_ZONE_STATE;
+    static const char* KEY_SCHEDULE_CONFIG;
 };
 
 #endif
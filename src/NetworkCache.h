@@ -0,0 +1,35 @@
+// src/NetworkCache.h
+#ifndef NETWORK_CACHE_H
+#define NETWORK_CACHE_H
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Parameters of the last successful WiFi association, persisted next to the
+ * scheduler state so reconnects can skip the channel scan (and optionally DHCP).
+ * IPv4 addresses are stored in network byte order as returned by IPAddress;
+ * ip == 0 means no lease is cached and DHCP is used.
+ */
+struct NetworkCache {
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t valid;
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+
+    NetworkCache() { clear(); }
+
+    void clear() { memset(this, 0, sizeof(*this)); }
+
+    bool hasIpLease() const { return ip != 0 && gateway != 0 && subnet != 0; }
+
+    bool operator==(const NetworkCache& other) const {
+        return memcmp(this, &other, sizeof(*this)) == 0;
+    }
+    bool operator!=(const NetworkCache& other) const { return !(*this == other); }
+};
+
+#endif
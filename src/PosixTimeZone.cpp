@@ -0,0 +1,300 @@
+// src/PosixTimeZone.cpp
+#include "PosixTimeZone.h"
+
+static const int64_t SECONDS_PER_DAY = 86400;
+
+// Floor division/modulo so pre-1970 and negative local times work
+static int64_t floorDiv(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    if ((a % b != 0) && ((a < 0) != (b < 0))) q--;
+    return q;
+}
+
+PosixTimeZone::PosixTimeZone()
+    : valid(false), dstEnabled(false), stdOffset(0), dstOffset(0),
+      tableCount(0), tableFrom(0), tableTo(0) {
+}
+
+bool PosixTimeZone::parse(const char* tz) {
+    valid = false;
+    dstEnabled = false;
+    stdOffset = dstOffset = 0;
+    tableCount = 0;
+    tableFrom = tableTo = 0;
+
+    if (!tz) return false;
+    const char* p = tz;
+
+    int32_t offset;
+    if (!parseName(p) || !parseOffset(p, &offset)) return false;
+    int32_t newStd = offset;
+    int32_t newDst = offset;
+    bool newDstEnabled = false;
+    Rule newStart = {};
+    Rule newEnd = {};
+
+    if (*p != '\0') {
+        if (!parseName(p)) return false;
+        newDstEnabled = true;
+        newDst = newStd + 3600;  // Default: one hour ahead of standard time
+        if (*p != ',' && *p != '\0') {
+            if (!parseOffset(p, &newDst)) return false;
+        }
+
+        if (*p == ',') {
+            p++;
+            if (!parseRule(p, &newStart) || *p != ',') return false;
+            p++;
+            if (!parseRule(p, &newEnd)) return false;
+        } else {
+            // US rules, the libc default when none are given
+            const char* defaultRules = "M3.2.0,M11.1.0";
+            const char* q = defaultRules;
+            parseRule(q, &newStart);
+            q++;
+            parseRule(q, &newEnd);
+        }
+    }
+
+    if (*p != '\0') return false;
+
+    stdOffset = newStd;
+    dstOffset = newDst;
+    dstEnabled = newDstEnabled;
+    startRule = newStart;
+    endRule = newEnd;
+    valid = true;
+    return true;
+}
+
+int32_t PosixTimeZone::utcOffsetAt(time_t epoch, bool* isDst) {
+    bool dst = false;
+    if (dstEnabled) {
+        int64_t t = (int64_t)epoch;
+        if (tableCount == 0 || t < tableFrom || t >= tableTo) {
+            buildTable(t);
+        }
+
+        // Last transition at or before t decides; before the first one the
+        // opposite of its direction is in effect
+        dst = !table[0].toDst;
+        for (int i = 0; i < tableCount && table[i].utc <= t; i++) {
+            dst = table[i].toDst;
+        }
+    }
+
+    if (isDst) *isDst = dst;
+    return dst ? dstOffset : stdOffset;
+}
+
+void PosixTimeZone::toLocal(time_t epoch, struct tm* out) {
+    bool dst;
+    int64_t local = (int64_t)epoch + utcOffsetAt(epoch, &dst);
+    int64_t days = floorDiv(local, SECONDS_PER_DAY);
+    int32_t secondOfDay = (int32_t)(local - days * SECONDS_PER_DAY);
+
+    int year, month, day;
+    civilFromDays(days, &year, &month, &day);
+
+    out->tm_sec = secondOfDay % 60;
+    out->tm_min = (secondOfDay / 60) % 60;
+    out->tm_hour = secondOfDay / 3600;
+    out->tm_mday = day;
+    out->tm_mon = month - 1;
+    out->tm_year = year - 1900;
+    out->tm_wday = (int)(((days % 7) + 11) % 7);  // 1970-01-01 was a Thursday
+    out->tm_yday = (int)(days - daysFromCivil(year, 1, 1));
+    out->tm_isdst = dst ? 1 : 0;
+}
+
+void PosixTimeZone::buildTable(int64_t epoch) {
+    int year, month, day;
+    civilFromDays(floorDiv(epoch, SECONDS_PER_DAY), &year, &month, &day);
+
+    // Neighbouring years cover transitions near New Year in any offset
+    tableCount = 0;
+    for (int y = year - 1; y <= year + 1; y++) {
+        table[tableCount].utc = ruleInstant(y, startRule, stdOffset);
+        table[tableCount].toDst = true;
+        tableCount++;
+        table[tableCount].utc = ruleInstant(y, endRule, dstOffset);
+        table[tableCount].toDst = false;
+        tableCount++;
+    }
+
+    // Insertion sort (southern hemisphere zones end DST before starting it)
+    for (int i = 1; i < tableCount; i++) {
+        Transition t = table[i];
+        int j = i - 1;
+        while (j >= 0 && table[j].utc > t.utc) {
+            table[j + 1] = table[j];
+            j--;
+        }
+        table[j + 1] = t;
+    }
+
+    tableFrom = daysFromCivil(year, 1, 1) * SECONDS_PER_DAY;
+    tableTo = daysFromCivil(year + 1, 1, 1) * SECONDS_PER_DAY;
+}
+
+int64_t PosixTimeZone::ruleInstant(int year, const Rule& rule, int32_t offsetBefore) const {
+    int64_t yearStart = daysFromCivil(year, 1, 1);
+    int64_t dayIndex = 0;  // Days after January 1st
+
+    switch (rule.type) {
+        case RULE_JULIAN1:
+            // Jn: 1-365, February 29th is never counted
+            dayIndex = rule.day - 1;
+            if (isLeapYear(year) && rule.day >= 60) dayIndex++;
+            break;
+
+        case RULE_JULIAN0:
+            dayIndex = rule.day;
+            break;
+
+        case RULE_MONTH: {
+            int64_t monthStart = daysFromCivil(year, rule.month, 1);
+            int firstWeekday = (int)(((monthStart % 7) + 11) % 7);
+            int64_t d = monthStart + (rule.weekday - firstWeekday + 7) % 7 + (rule.week - 1) * 7;
+
+            // Week 5 means the last such weekday of the month
+            int nextMonth = (rule.month == 12) ? 1 : rule.month + 1;
+            int nextYear = (rule.month == 12) ? year + 1 : year;
+            int64_t monthEnd = daysFromCivil(nextYear, nextMonth, 1);
+            while (d >= monthEnd) d -= 7;
+
+            dayIndex = d - yearStart;
+            break;
+        }
+    }
+
+    // Rule times are local wall-clock time in the offset before the change
+    return (yearStart + dayIndex) * SECONDS_PER_DAY + rule.time - offsetBefore;
+}
+
+bool PosixTimeZone::parseName(const char*& p) {
+    if (*p == '<') {
+        // Quoted form, e.g. <+0330>
+        p++;
+        int length = 0;
+        while (*p && *p != '>') {
+            p++;
+            length++;
+        }
+        if (*p != '>' || length < 3) return false;
+        p++;
+        return true;
+    }
+
+    int length = 0;
+    while ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')) {
+        p++;
+        length++;
+    }
+    return length >= 3;
+}
+
+bool PosixTimeZone::parseTime(const char*& p, int32_t* seconds) {
+    int sign = 1;
+    if (*p == '+' || *p == '-') {
+        if (*p == '-') sign = -1;
+        p++;
+    }
+
+    int hours, minutes = 0, secs = 0;
+    if (!parseNumber(p, 0, 167, &hours)) return false;
+    if (*p == ':') {
+        p++;
+        if (!parseNumber(p, 0, 59, &minutes)) return false;
+        if (*p == ':') {
+            p++;
+            if (!parseNumber(p, 0, 59, &secs)) return false;
+        }
+    }
+
+    *seconds = sign * (hours * 3600 + minutes * 60 + secs);
+    return true;
+}
+
+bool PosixTimeZone::parseOffset(const char*& p, int32_t* secondsEast) {
+    int32_t west;
+    if (!parseTime(p, &west)) return false;
+    if (west > 24 * 3600 || west < -24 * 3600) return false;
+    *secondsEast = -west;  // POSIX offsets are positive west of Greenwich
+    return true;
+}
+
+bool PosixTimeZone::parseRule(const char*& p, Rule* rule) {
+    int value;
+    if (*p == 'M') {
+        p++;
+        int month, week, weekday;
+        if (!parseNumber(p, 1, 12, &month) || *p != '.') return false;
+        p++;
+        if (!parseNumber(p, 1, 5, &week) || *p != '.') return false;
+        p++;
+        if (!parseNumber(p, 0, 6, &weekday)) return false;
+        rule->type = RULE_MONTH;
+        rule->month = (uint8_t)month;
+        rule->week = (uint8_t)week;
+        rule->weekday = (uint8_t)weekday;
+        rule->day = 0;
+    } else if (*p == 'J') {
+        p++;
+        if (!parseNumber(p, 1, 365, &value)) return false;
+        rule->type = RULE_JULIAN1;
+        rule->day = (int16_t)value;
+    } else {
+        if (!parseNumber(p, 0, 365, &value)) return false;
+        rule->type = RULE_JULIAN0;
+        rule->day = (int16_t)value;
+    }
+
+    rule->time = 2 * 3600;  // Default 02:00:00
+    if (*p == '/') {
+        p++;
+        if (!parseTime(p, &rule->time)) return false;
+    }
+    return true;
+}
+
+bool PosixTimeZone::parseNumber(const char*& p, int minValue, int maxValue, int* value) {
+    if (*p < '0' || *p > '9') return false;
+    int v = 0;
+    while (*p >= '0' && *p <= '9') {
+        v = v * 10 + (*p - '0');
+        if (v > maxValue) return false;
+        p++;
+    }
+    if (v < minValue) return false;
+    *value = v;
+    return true;
+}
+
+// Howard Hinnant's days_from_civil / civil_from_days algorithms
+int64_t PosixTimeZone::daysFromCivil(int year, int month, int day) {
+    int64_t y = (int64_t)year - (month <= 2 ? 1 : 0);
+    int64_t era = floorDiv(y, 400);
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+void PosixTimeZone::civilFromDays(int64_t days, int* year, int* month, int* day) {
+    int64_t z = days + 719468;
+    int64_t era = floorDiv(z, 146097);
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    int d = (int)(doy - (153 * mp + 2) / 5 + 1);
+    int m = (int)(mp < 10 ? mp + 3 : mp - 9);
+    *year = (int)(yoe + era * 400 + (m <= 2 ? 1 : 0));
+    *month = m;
+    *day = d;
+}
+
+bool PosixTimeZone::isLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+}
@@ -0,0 +1,83 @@
+// src/PosixTimeZone.h
+#ifndef POSIX_TIME_ZONE_H
+#define POSIX_TIME_ZONE_H
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * Allocation-free epoch -> local time conversion for a POSIX TZ string
+ * such as "PST8PDT,M3.2.0,M11.1.0" (the TIMEZONE_STRING in secrets.h).
+ *
+ * The string is parsed once. The UTC instants of the DST transitions for the
+ * current year and its neighbours are precomputed into a small sorted table,
+ * rebuilt only when the epoch moves into another year. A conversion is then
+ * a table lookup plus integer civil-date arithmetic, with no TZ parsing.
+ *
+ * Supported rule forms: Mm.w.d, Jn and n, each with an optional /time.
+ * A DST name without rules uses the US default (M3.2.0,M11.1.0).
+ */
+class PosixTimeZone {
+public:
+    PosixTimeZone();
+
+    // Parse a POSIX TZ string. Returns false (and stays UTC) on syntax error.
+    bool parse(const char* tz);
+
+    // Equivalent of localtime_r() for the parsed zone
+    void toLocal(time_t epoch, struct tm* out);
+
+    // UTC offset in seconds east of Greenwich in effect at epoch
+    int32_t utcOffsetAt(time_t epoch, bool* isDst = nullptr);
+
+    bool isValid() const { return valid; }
+    bool hasDst() const { return dstEnabled; }
+
+    // Civil calendar helpers (proleptic Gregorian, days since 1970-01-01)
+    static int64_t daysFromCivil(int year, int month, int day);
+    static void civilFromDays(int64_t days, int* year, int* month, int* day);
+    static bool isLeapYear(int year);
+
+    // Transitions precomputed per table (previous, current and next year)
+    static const int MAX_TRANSITIONS = 6;
+
+private:
+    enum RuleType { RULE_JULIAN1, RULE_JULIAN0, RULE_MONTH };
+
+    struct Rule {
+        uint8_t type;     // RuleType
+        uint8_t month;    // 1-12 (RULE_MONTH)
+        uint8_t week;     // 1-5, 5 = last (RULE_MONTH)
+        uint8_t weekday;  // 0 = Sunday (RULE_MONTH)
+        int16_t day;      // Jn: 1-365, n: 0-365
+        int32_t time;     // Seconds after local midnight (may be negative or > 24h)
+    };
+
+    struct Transition {
+        int64_t utc;      // Instant of the change
+        bool toDst;       // true: DST starts, false: DST ends
+    };
+
+    bool valid;
+    bool dstEnabled;
+    int32_t stdOffset;    // Seconds east of UTC
+    int32_t dstOffset;
+    Rule startRule;
+    Rule endRule;
+
+    Transition table[MAX_TRANSITIONS];
+    int tableCount;
+    int64_t tableFrom;    // Table covers epochs in [tableFrom, tableTo)
+    int64_t tableTo;
+
+    void buildTable(int64_t epoch);
+    int64_t ruleInstant(int year, const Rule& rule, int32_t offsetBefore) const;
+
+    static bool parseName(const char*& p);
+    static bool parseTime(const char*& p, int32_t* seconds);
+    static bool parseOffset(const char*& p, int32_t* secondsEast);
+    static bool parseRule(const char*& p, Rule* rule);
+    static bool parseNumber(const char*& p, int minValue, int maxValue, int* value);
+};
+
+#endif
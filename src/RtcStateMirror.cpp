@@ -0,0 +1,282 @@
+// src/RtcStateMirror.cpp
+#include "RtcStateMirror.h"
+#include "Crc32.h"
+#include <stdio.h>
+#include <string.h>
+
+RtcStateMirror::RtcStateMirror(RtcStateBlock* block, IStateStorage* backing, LogCallback logger)
+    : block(block), backing(backing), logger(logger), journal(nullptr), journalWorker(nullptr),
+      flashIntervalSeconds(DEFAULT_FLASH_INTERVAL_SECONDS), initialized(false),
+      restoredFromRtc(false), flashWriteCount(0), firstEventSlot(0), recordedEvents(0),
+      journaledEvents(0), droppedEvents(0) {
+}
+
+RtcStateMirror::~RtcStateMirror() {
+    if (journalWorker) {
+        journalWorker->stop();
+    }
+}
+
+void RtcStateMirror::setJournal(IEventJournal* eventJournal, IWorkerTask* worker) {
+    journal = eventJournal;
+    if (worker && !worker->start(&RtcStateMirror::journalWorkerBody, this)) {
+        log("RTC: Journal worker start failed, appending inline");
+        worker = nullptr;
+    }
+    journalWorker = worker;
+}
+
+unsigned long RtcStateMirror::getLastMistTime() {
+    ensureInitialized();
+    return block->lastMistTime;
+}
+
+bool RtcStateMirror::getHasEverMisted() {
+    ensureInitialized();
+    return (block->flags & FLAG_HAS_EVER_MISTED) != 0;
+}
+
+bool RtcStateMirror::getEnabled() {
+    ensureInitialized();
+    return (block->flags & FLAG_ENABLED) != 0;
+}
+
+bool RtcStateMirror::load(unsigned long* lastMistTime, bool* hasEverMisted, bool* enabled) {
+    if (isBlockValid()) {
+        if (!initialized) {
+            restoredFromRtc = true;
+            startEventNumbering();
+            log("RTC: Restored state from RTC memory (warm boot)");
+        }
+        initialized = true;
+        *lastMistTime = block->lastMistTime;
+        *hasEverMisted = (block->flags & FLAG_HAS_EVER_MISTED) != 0;
+        *enabled = (block->flags & FLAG_ENABLED) != 0;
+        return true;
+    }
+
+    // Cold boot or corrupt block: flash is authoritative, and now mirrored
+    bool found = backing->load(lastMistTime, hasEverMisted, enabled);
+    resetBlock(*lastMistTime, *hasEverMisted, *enabled, found);
+
+    // Flash lastMistTime can lag by up to flashIntervalSeconds; the journal
+    // holds every completed mist. Nothing is pending yet, so the journal
+    // worker is idle while it is read here.
+    uint32_t newestStart;
+    if (found && journal && journal->getNewestStartEpoch(&newestStart) && newestStart > *lastMistTime) {
+        *lastMistTime = newestStart;
+        *hasEverMisted = true;
+        block->lastMistTime = newestStart;
+        block->flags |= FLAG_HAS_EVER_MISTED;
+        seal();
+        log("RTC: Last mist time taken from the journal (cold boot)");
+    }
+
+    startEventNumbering();
+    initialized = true;
+    return found;
+}
+
+bool RtcStateMirror::save(unsigned long lastMistTime, bool hasEverMisted, bool enabled) {
+    ensureInitialized();
+
+    block->lastMistTime = (uint32_t)lastMistTime;
+    block->flags = (hasEverMisted ? FLAG_HAS_EVER_MISTED : 0) | (enabled ? FLAG_ENABLED : 0);
+    seal();
+
+    if (needsFlash()) {
+        return flushToFlash();
+    }
+    return true;
+}
+
+bool RtcStateMirror::recordMist(uint32_t startEpoch, uint32_t durationMs, MistTrigger trigger, MistOutcome outcome) {
+    ensureInitialized();
+
+    // Never overwrite an event the journal has not received yet
+    if (journal && getPendingEventCount() >= RtcStateBlock::EVENT_RING_SIZE) {
+        if (!journalWorker) {
+            appendPendingEvents();
+        }
+        if (getPendingEventCount() >= RtcStateBlock::EVENT_RING_SIZE) {
+            droppedEvents++;
+            log("RTC: Journal behind, mist event dropped");
+            return false;
+        }
+    }
+
+    RtcEvent& event = block->events[block->eventHead];
+    memset(&event, 0, sizeof(event));
+    event.startEpoch = startEpoch;
+    event.durationMs = durationMs;
+    event.trigger = (uint8_t)trigger;
+    event.outcome = (uint8_t)outcome;
+
+    block->eventHead = (block->eventHead + 1) % RtcStateBlock::EVENT_RING_SIZE;
+    if (block->eventCount < RtcStateBlock::EVENT_RING_SIZE) {
+        block->eventCount++;
+    }
+    if (journal) {
+        recordedEvents.fetch_add(1, std::memory_order_release);
+        if (journalWorker) {
+            journalWorker->wake();
+        }
+    }
+    seal();
+    return true;
+}
+
+bool RtcStateMirror::flushToFlash() {
+    ensureInitialized();
+
+    if (journal) {
+        if (journalWorker) {
+            journalWorker->wake();
+        } else {
+            appendPendingEvents();
+        }
+    }
+
+    bool success = backing->save(block->lastMistTime,
+                                 (block->flags & FLAG_HAS_EVER_MISTED) != 0,
+                                 (block->flags & FLAG_ENABLED) != 0);
+    flashWriteCount++;
+    if (!success) {
+        seal();
+        log("RTC: Flash write-through failed");
+        return false;
+    }
+
+    block->flashedLastMistTime = block->lastMistTime;
+    block->flashedFlags = block->flags | FLAG_FLASHED_VALID;
+    seal();
+    return true;
+}
+
+bool RtcStateMirror::waitForJournal(unsigned long timeoutMs) {
+    ensureInitialized();
+    if (!journal) {
+        return true;
+    }
+    if (!journalWorker) {
+        appendPendingEvents();
+    } else {
+        journalWorker->wake();
+        unsigned long waited = 0;
+        while (getPendingEventCount() > 0 && waited < timeoutMs) {
+            journalWorker->sleepMs(1);
+            waited++;
+            if (waited % 100 == 0) {
+                journalWorker->wake();  // Retry a failed append
+            }
+        }
+    }
+    seal();  // Record the progress in RTC memory
+    return getPendingEventCount() == 0;
+}
+
+size_t RtcStateMirror::readRecentEvents(RtcEvent* out, size_t maxEvents) const {
+    if (!isBlockValid()) {
+        return 0;
+    }
+
+    size_t count = 0;
+    uint8_t index = block->eventHead;
+    while (count < block->eventCount && count < maxEvents) {
+        index = (index + RtcStateBlock::EVENT_RING_SIZE - 1) % RtcStateBlock::EVENT_RING_SIZE;
+        out[count++] = block->events[index];
+    }
+    return count;
+}
+
+bool RtcStateMirror::isBlockValid() const {
+    return block->magic == RtcStateBlock::MAGIC &&
+           block->version == RtcStateBlock::VERSION &&
+           block->eventHead < RtcStateBlock::EVENT_RING_SIZE &&
+           block->crc == crc32(block, offsetof(RtcStateBlock, crc));
+}
+
+void RtcStateMirror::resetBlock(unsigned long lastMistTime, bool hasEverMisted, bool enabled, bool flashed) {
+    memset(block, 0, sizeof(*block));
+    recordedEvents.store(0);
+    journaledEvents.store(0);
+    block->magic = RtcStateBlock::MAGIC;
+    block->version = RtcStateBlock::VERSION;
+    block->lastMistTime = (uint32_t)lastMistTime;
+    block->flags = (hasEverMisted ? FLAG_HAS_EVER_MISTED : 0) | (enabled ? FLAG_ENABLED : 0);
+    if (flashed) {
+        block->flashedLastMistTime = block->lastMistTime;
+        block->flashedFlags = block->flags | FLAG_FLASHED_VALID;
+    }
+    seal();
+}
+
+void RtcStateMirror::seal() {
+    block->pendingEvents = (uint8_t)getPendingEventCount();
+    block->crc = crc32(block, offsetof(RtcStateBlock, crc));
+}
+
+void RtcStateMirror::ensureInitialized() {
+    if (!initialized) {
+        unsigned long lastMistTime;
+        bool hasEverMisted, enabled;
+        load(&lastMistTime, &hasEverMisted, &enabled);
+    }
+}
+
+// Number the events still pending in the block from 0, oldest first
+void RtcStateMirror::startEventNumbering() {
+    uint8_t pending = block->pendingEvents;
+    if (pending > RtcStateBlock::EVENT_RING_SIZE) {
+        pending = RtcStateBlock::EVENT_RING_SIZE;
+    }
+    firstEventSlot = (block->eventHead + RtcStateBlock::EVENT_RING_SIZE - pending) % RtcStateBlock::EVENT_RING_SIZE;
+    recordedEvents.store(pending);
+    journaledEvents.store(0);
+}
+
+// Journal worker (or inline): append pending events oldest first, stopping
+// at the first failure so the journal stays in order. The slots read here
+// are not written by recordMist() until they have been appended.
+bool RtcStateMirror::appendPendingEvents() {
+    uint32_t appended = journaledEvents.load(std::memory_order_relaxed);
+    while (appended < recordedEvents.load(std::memory_order_acquire)) {
+        const RtcEvent& event = block->events[(firstEventSlot + appended) % RtcStateBlock::EVENT_RING_SIZE];
+        if (!journal->recordMist(event.startEpoch, event.durationMs,
+                                 (MistTrigger)event.trigger, (MistOutcome)event.outcome)) {
+            log("RTC: Journal append failed, event kept pending");
+            return false;
+        }
+        appended++;
+        journaledEvents.store(appended, std::memory_order_release);
+    }
+    return true;
+}
+
+void RtcStateMirror::journalWorkerBody(void* arg) {
+    static_cast<RtcStateMirror*>(arg)->appendPendingEvents();
+}
+
+bool RtcStateMirror::needsFlash() const {
+    if (!(block->flashedFlags & FLAG_FLASHED_VALID)) {
+        return true;
+    }
+
+    // Configuration-like flags are always made durable immediately
+    uint8_t stateFlags = FLAG_HAS_EVER_MISTED | FLAG_ENABLED;
+    if ((block->flags & stateFlags) != (block->flashedFlags & stateFlags)) {
+        return true;
+    }
+
+    // Timestamps go to flash periodically (or immediately if time went back)
+    if (block->lastMistTime < block->flashedLastMistTime) {
+        return true;
+    }
+    return block->lastMistTime - block->flashedLastMistTime >= flashIntervalSeconds;
+}
+
+void RtcStateMirror::log(const char* message) {
+    if (logger) {
+        logger(message);
+    }
+}
@@ -0,0 +1,162 @@
+// src/RtcStateMirror.h
+#ifndef RTC_STATE_MIRROR_H
+#define RTC_STATE_MIRROR_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include "IStateStorage.h"
+#include "IEventJournal.h"
+#include "IWorkerTask.h"
+
+// Logging callback type
+typedef void (*LogCallback)(const char* message);
+
+// One mist cycle held in RTC memory until it is drained to the flash journal
+struct RtcEvent {
+    uint32_t startEpoch;
+    uint32_t durationMs;
+    uint8_t trigger;      // MistTrigger
+    uint8_t outcome;      // MistOutcome
+    uint8_t reserved[2];
+};
+
+/**
+ * Layout of the state kept in RTC slow memory. On the ESP32 this is a
+ * RTC_NOINIT_ATTR global: it survives software/watchdog resets and deep
+ * sleep but holds garbage after power-on, which the magic/version/CRC
+ * check rejects.
+ */
+struct RtcStateBlock {
+    static const uint32_t MAGIC = 0x4D495354;  // "MIST"
+    static const uint16_t VERSION = 1;
+    static const uint8_t EVENT_RING_SIZE = 8;
+
+    uint32_t magic;
+    uint16_t version;
+    uint8_t flags;                // RtcStateMirror::FLAG_* (current state)
+    uint8_t flashedFlags;         // Flags as last written to flash
+    uint32_t lastMistTime;
+    uint32_t flashedLastMistTime; // lastMistTime as last written to flash
+    uint8_t eventHead;            // Next ring slot to write
+    uint8_t eventCount;           // Valid events in the ring
+    uint8_t pendingEvents;        // Newest events not yet in the flash journal
+    uint8_t reserved;
+    RtcEvent events[EVENT_RING_SIZE];
+    uint32_t crc;                 // CRC-32 of everything above
+};
+
+/**
+ * Fast state tier in RTC slow memory in front of a flash-backed
+ * IStateStorage.
+ *
+ * Every save() lands in the RTC block (no flash write). The backing storage
+ * is only written when the enabled/hasEverMisted flags change, when
+ * lastMistTime has moved flashIntervalSeconds past the flashed value, when
+ * the event ring is about to overflow, or on an explicit flushToFlash().
+ * On a warm boot a valid RTC block is preferred over the (possibly older)
+ * flash copy; after power loss it falls back to flash, moved forward to the
+ * newest mist in the journal, which every cycle reaches long before the
+ * next periodic flash write.
+ *
+ * Mist events are held in a small ring and appended to the next
+ * IEventJournal (the flash journal) by a journal worker, so a sector erase
+ * never stalls the caller. An event stays pending in the RTC block until
+ * its append succeeds; a reset in between may append it twice, never zero
+ * times. If the journal falls a whole ring behind, new events are dropped
+ * (counted) rather than overwriting one not yet appended. Without a worker
+ * the events are appended inline, when the ring is full or on
+ * flushToFlash().
+ */
+class RtcStateMirror : public IStateStorage, public IEventJournal {
+public:
+    static const uint8_t FLAG_HAS_EVER_MISTED = 0x01;
+    static const uint8_t FLAG_ENABLED = 0x02;
+    static const uint8_t FLAG_FLASHED_VALID = 0x80;  // flashed* fields are meaningful
+    static const unsigned long DEFAULT_FLASH_INTERVAL_SECONDS = 21600;  // 6 hours
+
+    static const unsigned long DEFAULT_JOURNAL_TIMEOUT_MS = 2000;
+
+    RtcStateMirror(RtcStateBlock* block, IStateStorage* backing, LogCallback logger = nullptr);
+    ~RtcStateMirror();
+
+    void setFlashIntervalSeconds(unsigned long seconds) { flashIntervalSeconds = seconds; }
+
+    /**
+     * Send events to a journal, appended on the given worker (started here)
+     * or, without one, inline on the caller. Call before load(), so a cold
+     * boot can read the newest mist back, and before the first recordMist().
+     */
+    void setJournal(IEventJournal* eventJournal, IWorkerTask* worker = nullptr);
+
+    // IStateStorage interface implementation
+    unsigned long getLastMistTime() override;
+    bool getHasEverMisted() override;
+    bool getEnabled() override;
+    bool save(unsigned long lastMistTime, bool hasEverMisted, bool enabled) override;
+    bool load(unsigned long* lastMistTime, bool* hasEverMisted, bool* enabled) override;
+    bool loadNetworkCache(NetworkCache* cache) override { return backing->loadNetworkCache(cache); }
+    bool saveNetworkCache(const NetworkCache& cache) override { return backing->saveNetworkCache(cache); }
+    bool loadZoneState(void* record, size_t length) override { return backing->loadZoneState(record, length); }
+    bool saveZoneState(const void* record, size_t length) override { return backing->saveZoneState(record, length); }
+    bool loadScheduleConfig(void* record, size_t length) override { return backing->loadScheduleConfig(record, length); }
+    bool saveScheduleConfig(const void* record, size_t length) override { return backing->saveScheduleConfig(record, length); }
+
+    // IEventJournal
+    bool recordMist(uint32_t startEpoch, uint32_t durationMs, MistTrigger trigger, MistOutcome outcome) override;
+
+    /**
+     * Write the current state to the backing storage now and start
+     * appending pending events (shutdown paths, brownout risk).
+     * @return true if the backing storage accepted the state
+     */
+    bool flushToFlash();
+
+    /**
+     * Barrier: wait until every pending event is in the journal, so it can
+     * be read (HISTORY) or the device restarted.
+     * @return false if events are still pending after timeoutMs
+     */
+    bool waitForJournal(unsigned long timeoutMs = DEFAULT_JOURNAL_TIMEOUT_MS);
+
+    /**
+     * Copy up to maxEvents events from the RTC ring, newest first.
+     */
+    size_t readRecentEvents(RtcEvent* out, size_t maxEvents) const;
+
+    bool wasRestoredFromRtc() const { return restoredFromRtc; }
+    unsigned long getFlashWriteCount() const { return flashWriteCount; }
+    uint32_t getPendingEventCount() const { return recordedEvents.load() - journaledEvents.load(); }
+    uint32_t getDroppedEventCount() const { return droppedEvents; }
+
+private:
+    RtcStateBlock* block;
+    IStateStorage* backing;
+    LogCallback logger;
+    IEventJournal* journal;
+    IWorkerTask* journalWorker;
+    unsigned long flashIntervalSeconds;
+    bool initialized;
+    bool restoredFromRtc;
+    unsigned long flashWriteCount;
+
+    // Events numbered from load(): event n lives in ring slot
+    // (firstEventSlot + n) % EVENT_RING_SIZE. The caller publishes
+    // recordedEvents, the journal worker journaledEvents.
+    uint8_t firstEventSlot;
+    std::atomic<uint32_t> recordedEvents;
+    std::atomic<uint32_t> journaledEvents;
+    uint32_t droppedEvents;
+
+    bool isBlockValid() const;
+    void resetBlock(unsigned long lastMistTime, bool hasEverMisted, bool enabled, bool flashed);
+    void seal();
+    void ensureInitialized();
+    bool needsFlash() const;
+    void startEventNumbering();
+    bool appendPendingEvents();
+    static void journalWorkerBody(void* arg);
+    void log(const char* message);
+};
+
+#endif
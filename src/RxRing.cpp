@@ -0,0 +1,34 @@
+// src/RxRing.cpp
+#include "RxRing.h"
+
+RxRing::RxRing() : head(0), tail(0), overflowCount(0) {
+}
+
+size_t RxRing::write(const uint8_t* data, size_t length, uint32_t timestampUs) {
+    size_t writePos = head.load(std::memory_order_relaxed);
+    size_t free = CAPACITY - (writePos - tail.load(std::memory_order_acquire));
+    size_t accepted = (length < free) ? length : free;
+
+    for (size_t i = 0; i < accepted; i++) {
+        bytes[(writePos + i) & MASK] = data[i];
+        timestamps[(writePos + i) & MASK] = timestampUs;
+    }
+    head.store(writePos + accepted, std::memory_order_release);
+
+    if (accepted < length) {
+        overflowCount.fetch_add((uint32_t)(length - accepted), std::memory_order_relaxed);
+    }
+    return accepted;
+}
+
+bool RxRing::read(uint8_t* byte, uint32_t* timestampUs) {
+    size_t readPos = tail.load(std::memory_order_relaxed);
+    if (readPos == head.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    *byte = bytes[readPos & MASK];
+    *timestampUs = timestamps[readPos & MASK];
+    tail.store(readPos + 1, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,42 @@
+// src/RxRing.h
+#ifndef RX_RING_H
+#define RX_RING_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Single-producer / single-consumer byte queue between the UART receive
+ * callback and the main loop. Each byte carries the micros() timestamp of
+ * its arrival, so command latency can be measured from the moment the
+ * terminator was received.
+ *
+ * write() never blocks; bytes that do not fit are dropped and counted.
+ */
+class RxRing {
+public:
+    static const size_t CAPACITY = 128;  // Power of two
+
+    RxRing();
+
+    // Producer (UART event task)
+    size_t write(const uint8_t* data, size_t length, uint32_t timestampUs);
+
+    // Consumer (main loop)
+    bool read(uint8_t* byte, uint32_t* timestampUs);
+
+    bool isEmpty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_relaxed); }
+    uint32_t getOverflowCount() const { return overflowCount.load(std::memory_order_relaxed); }
+
+private:
+    static const size_t MASK = CAPACITY - 1;
+
+    uint8_t bytes[CAPACITY];
+    uint32_t timestamps[CAPACITY];
+    std::atomic<size_t> head;  // Next write position (producer)
+    std::atomic<size_t> tail;  // Next read position (consumer)
+    std::atomic<uint32_t> overflowCount;
+};
+
+#endif
@@ -0,0 +1,18 @@
+// src/SampleStats.cpp
+#include "SampleStats.h"
+#include <algorithm>
+
+SampleSummary summarizeSamples(uint32_t* samples, size_t count) {
+    SampleSummary summary = { 0, 0, 0, 0, 0 };
+    if (count == 0) {
+        return summary;
+    }
+
+    std::sort(samples, samples + count);
+    summary.count = (uint32_t)count;
+    summary.min = samples[0];
+    summary.median = samples[(count - 1) / 2];
+    summary.p99 = samples[(count * 99 + 99) / 100 - 1];  // ceil(0.99 * count)-th
+    summary.max = samples[count - 1];
+    return summary;
+}
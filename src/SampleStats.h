@@ -0,0 +1,24 @@
+// src/SampleStats.h
+#ifndef SAMPLE_STATS_H
+#define SAMPLE_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Order statistics of a batch of timing samples (cycles, microseconds...).
+ * The median and p99 are nearest-rank values, so they are always one of
+ * the measured samples; with fewer than 100 samples p99 is the maximum.
+ */
+struct SampleSummary {
+    uint32_t count;
+    uint32_t min;
+    uint32_t median;
+    uint32_t p99;
+    uint32_t max;
+};
+
+// Sorts samples in place; all fields are zero for an empty batch
+SampleSummary summarizeSamples(uint32_t* samples, size_t count);
+
+#endif
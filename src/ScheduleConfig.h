@@ -0,0 +1,157 @@
+// src/ScheduleConfig.h
+#ifndef SCHEDULE_CONFIG_H
+#define SCHEDULE_CONFIG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include "Crc32.h"
+#include "ScheduleExpression.h"
+
+/**
+ * Schedule parameters that can be changed at runtime (serial commands) and
+ * persist across reboots.
+ */
+struct ScheduleConfig {
+    // Limits enforced by isValid()
+    static const unsigned long MIN_MIST_DURATION_MS = 1000;
+    static const unsigned long MAX_MIST_DURATION_MS = 120000;
+    static const unsigned long MIN_INTERVAL_SECONDS = 60;
+    static const unsigned long MAX_INTERVAL_SECONDS = 86400;
+
+    unsigned long mistDurationMs;   // Length of a scheduled mist
+    unsigned long intervalSeconds;  // Minimum time between mist starts
+    ScheduleExpression activeWindow; // When scheduled mists may start, local time
+
+    ScheduleConfig() : mistDurationMs(0), intervalSeconds(0) {}
+
+    ScheduleConfig(unsigned long mistDurationMs, unsigned long intervalSeconds,
+                   const ScheduleExpression& activeWindow)
+        : mistDurationMs(mistDurationMs), intervalSeconds(intervalSeconds), activeWindow(activeWindow) {
+    }
+
+    // Window of whole hours [start, end), wrapping past midnight if start > end
+    ScheduleConfig(unsigned long mistDurationMs, unsigned long intervalSeconds,
+                   uint8_t windowStartHour, uint8_t windowEndHour)
+        : mistDurationMs(mistDurationMs), intervalSeconds(intervalSeconds),
+          activeWindow(ScheduleExpression::hours(windowStartHour, windowEndHour)) {
+    }
+
+    /**
+     * Check every field and their combination: a mist must end before the
+     * next one is due, and the window must not be empty.
+     */
+    bool isValid() const {
+        return mistDurationMs >= MIN_MIST_DURATION_MS && mistDurationMs <= MAX_MIST_DURATION_MS &&
+               intervalSeconds >= MIN_INTERVAL_SECONDS && intervalSeconds <= MAX_INTERVAL_SECONDS &&
+               intervalSeconds * 1000 > mistDurationMs &&
+               !activeWindow.isEmpty();
+    }
+
+    bool operator==(const ScheduleConfig& other) const {
+        return mistDurationMs == other.mistDurationMs && intervalSeconds == other.intervalSeconds &&
+               activeWindow == other.activeWindow;
+    }
+    bool operator!=(const ScheduleConfig& other) const { return !(*this == other); }
+};
+
+/**
+ * Packed, versioned ScheduleConfig as written to storage in one blob, with
+ * the same CRC protection as StateRecord.
+ *
+ * Layout (120 bytes, little-endian on ESP32):
+ *   version(1) ruleCount(1) reserved(6) mistDurationMs(4) intervalSeconds(4)
+ *   rules(4 x 24, compiled ScheduleRule bitsets) crc(4) padding(4)
+ *
+ * The window is stored compiled, so loading needs no parser and a stored
+ * schedule means the same thing to every build.
+ */
+struct ScheduleConfigRecord {
+    static const uint8_t VERSION = 2;  // 1: hour window (never released)
+
+    uint8_t version;
+    uint8_t ruleCount;
+    uint8_t reserved[6];
+    uint32_t mistDurationMs;
+    uint32_t intervalSeconds;
+    ScheduleRule rules[ScheduleExpression::MAX_RULES];
+    uint32_t crc;
+
+    ScheduleConfigRecord() { memset(this, 0, sizeof(*this)); }
+
+    void encode(const ScheduleConfig& config) {
+        memset(this, 0, sizeof(*this));
+        version = VERSION;
+        ruleCount = config.activeWindow.getRuleCount();
+        mistDurationMs = (uint32_t)config.mistDurationMs;
+        intervalSeconds = (uint32_t)config.intervalSeconds;
+        for (uint8_t i = 0; i < ruleCount; i++) {
+            rules[i] = config.activeWindow.getRule(i);
+        }
+        crc = computeCrc();
+    }
+
+    /**
+     * Validate version, CRC and the values themselves.
+     * @return false (config untouched) if the record is corrupt, from
+     *         another version, or holds an invalid schedule
+     */
+    bool decode(ScheduleConfig* config) const {
+        if (version != VERSION || crc != computeCrc()) {
+            return false;
+        }
+        ScheduleExpression window;
+        if (!window.setRules(rules, ruleCount)) {
+            return false;
+        }
+        ScheduleConfig decoded(mistDurationMs, intervalSeconds, window);
+        if (!decoded.isValid()) {
+            return false;
+        }
+        *config = decoded;
+        return true;
+    }
+
+    uint32_t computeCrc() const { return crc32(this, offsetof(ScheduleConfigRecord, crc)); }
+};
+
+/**
+ * Two ScheduleConfig buffers and an atomic index of the live one. A change
+ * is written to the inactive buffer and published with one atomic store, so
+ * readers see either the old or the new config in full, never a mix
+ * (e.g. a window with some of its rules replaced).
+ *
+ * Single writer. A reader must copy the config (or finish with it) before
+ * the next-but-one publish, which reuses its buffer; the scheduler copies
+ * it once per update().
+ */
+class ScheduleConfigBuffer {
+public:
+    explicit ScheduleConfigBuffer(const ScheduleConfig& initial) : active(0) {
+        slots[0] = initial;
+        slots[1] = initial;
+    }
+
+    const ScheduleConfig& current() const { return slots[active.load(std::memory_order_acquire)]; }
+
+    /**
+     * Validate and publish a new config.
+     * @return false (live config unchanged) if the config is invalid
+     */
+    bool publish(const ScheduleConfig& config) {
+        if (!config.isValid()) {
+            return false;
+        }
+        uint8_t next = active.load(std::memory_order_relaxed) ^ 1;
+        slots[next] = config;
+        active.store(next, std::memory_order_release);
+        return true;
+    }
+
+private:
+    ScheduleConfig slots[2];
+    std::atomic<uint8_t> active;
+};
+
+#endif
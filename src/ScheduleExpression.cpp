@@ -0,0 +1,397 @@
+// src/ScheduleExpression.cpp
+#include "ScheduleExpression.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+static const uint64_t ALL_MINUTES = (1ULL << 60) - 1;
+static const uint32_t ALL_HOURS = (1UL << 24) - 1;
+static const uint32_t ALL_DAYS_OF_MONTH = 0xFFFFFFFEUL;  // Bits 1-31
+static const uint16_t ALL_MONTHS = 0x1FFE;               // Bits 1-12
+static const uint8_t ALL_DAYS_OF_WEEK = 0x7F;
+
+static const char* const MONTH_NAMES[] = {
+    "JAN", "FEB", "MAR", "APR", "MAY", "JUN", "JUL", "AUG", "SEP", "OCT", "NOV", "DEC", nullptr
+};
+static const char* const DAY_NAMES[] = {
+    "SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT", nullptr
+};
+
+// Value range and optional names of one cron field
+struct CronField {
+    int minValue;
+    int maxValue;
+    const char* const* names;  // names[i] is minValue + i
+};
+
+static const CronField MINUTE_FIELD = { 0, 59, nullptr };
+static const CronField HOUR_FIELD = { 0, 23, nullptr };
+static const CronField DAY_OF_MONTH_FIELD = { 1, 31, nullptr };
+static const CronField MONTH_FIELD = { 1, 12, MONTH_NAMES };
+static const CronField DAY_OF_WEEK_FIELD = { 0, 7, DAY_NAMES };  // 7 = Sunday again
+
+static bool isSeparator(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static int daysInMonth(int year, int month) {
+    static const uint8_t DAYS[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (month == 1 && (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0))) {
+        return 29;
+    }
+    return DAYS[month];
+}
+
+// Number or name at p (advanced past it)
+static bool parseValue(const char** p, const char* end, const CronField& field, int* value) {
+    const char* s = *p;
+    if (s < end && isdigit((unsigned char)*s)) {
+        int parsed = 0;
+        while (s < end && isdigit((unsigned char)*s) && parsed <= field.maxValue) {
+            parsed = parsed * 10 + (*s++ - '0');
+        }
+        if (parsed < field.minValue || parsed > field.maxValue) {
+            return false;
+        }
+        *value = parsed;
+        *p = s;
+        return true;
+    }
+    if (field.names && end - s >= 3) {
+        for (int i = 0; field.names[i]; i++) {
+            if (toupper((unsigned char)s[0]) == field.names[i][0] &&
+                toupper((unsigned char)s[1]) == field.names[i][1] &&
+                toupper((unsigned char)s[2]) == field.names[i][2]) {
+                *value = field.minValue + i;
+                *p = s + 3;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// One field: '*' or a comma list of N, N-M, with optional /STEP
+static bool parseField(const char* p, const char* end, const CronField& field, uint64_t* bits, bool* any) {
+    *bits = 0;
+    *any = (end - p == 1 && *p == '*');
+    int span = field.maxValue - field.minValue + 1;
+
+    while (p < end) {
+        int first = field.minValue;
+        int last = field.maxValue;
+        bool single = false;
+        if (*p == '*') {
+            p++;
+        } else {
+            if (!parseValue(&p, end, field, &first)) {
+                return false;
+            }
+            last = first;
+            single = true;
+            if (p < end && *p == '-') {
+                p++;
+                if (!parseValue(&p, end, field, &last)) {
+                    return false;
+                }
+                single = false;
+            }
+        }
+
+        int step = 1;
+        if (p < end && *p == '/') {
+            p++;
+            if (p == end || !isdigit((unsigned char)*p)) {
+                return false;
+            }
+            step = 0;
+            while (p < end && isdigit((unsigned char)*p) && step <= span) {
+                step = step * 10 + (*p++ - '0');
+            }
+            if (step == 0 || step > span) {
+                return false;
+            }
+            // N/STEP runs to the end of the field, as in cron
+            if (single) {
+                last = field.maxValue;
+            }
+        }
+
+        // Walk first..last in steps, wrapping past maxValue when last < first
+        int length = (last - first + span) % span;
+        for (int offset = 0; offset <= length; offset += step) {
+            *bits |= 1ULL << (field.minValue + (first - field.minValue + offset) % span);
+        }
+
+        if (p < end) {
+            if (*p != ',' || p + 1 == end) {
+                return false;
+            }
+            p++;
+        }
+    }
+    return *bits != 0;
+}
+
+// One rule: exactly five whitespace-separated fields
+static bool parseRule(const char* p, const char* end, ScheduleRule* rule) {
+    const CronField* fields[] = { &MINUTE_FIELD, &HOUR_FIELD, &DAY_OF_MONTH_FIELD, &MONTH_FIELD, &DAY_OF_WEEK_FIELD };
+    uint64_t bits[5];
+    bool any[5];
+
+    for (int i = 0; i < 5; i++) {
+        while (p < end && isSeparator(*p)) {
+            p++;
+        }
+        const char* fieldEnd = p;
+        while (fieldEnd < end && !isSeparator(*fieldEnd)) {
+            fieldEnd++;
+        }
+        if (fieldEnd == p || !parseField(p, fieldEnd, *fields[i], &bits[i], &any[i])) {
+            return false;
+        }
+        p = fieldEnd;
+    }
+    while (p < end && isSeparator(*p)) {
+        p++;
+    }
+    if (p != end) {
+        return false;  // More than five fields
+    }
+
+    memset(rule, 0, sizeof(*rule));
+    rule->minutes = bits[0];
+    rule->hours = (uint32_t)bits[1];
+    rule->daysOfMonth = (uint32_t)bits[2];
+    rule->months = (uint16_t)bits[3];
+    rule->daysOfWeek = (uint8_t)((bits[4] | (bits[4] >> 7)) & ALL_DAYS_OF_WEEK);  // 7 -> Sunday
+    rule->flags = (any[2] ? ScheduleRule::FLAG_ANY_DAY_OF_MONTH : 0) |
+                  (any[4] ? ScheduleRule::FLAG_ANY_DAY_OF_WEEK : 0);
+    return true;
+}
+
+ScheduleExpression::ScheduleExpression() : ruleCount(0) {
+    memset(rules, 0, sizeof(rules));
+}
+
+ScheduleExpression ScheduleExpression::hours(uint8_t startHour, uint8_t endHour) {
+    ScheduleExpression expression;
+    uint32_t hourBits = 0;
+    for (int hour = startHour; hour < 24 && (hour < endHour || startHour > endHour); hour++) {
+        hourBits |= 1UL << hour;
+    }
+    for (int hour = 0; startHour > endHour && hour < endHour; hour++) {
+        hourBits |= 1UL << hour;
+    }
+    if (hourBits == 0) {
+        return expression;
+    }
+
+    ScheduleRule& rule = expression.rules[0];
+    rule.minutes = ALL_MINUTES;
+    rule.hours = hourBits;
+    rule.daysOfMonth = ALL_DAYS_OF_MONTH;
+    rule.months = ALL_MONTHS;
+    rule.daysOfWeek = ALL_DAYS_OF_WEEK;
+    rule.flags = ScheduleRule::FLAG_ANY_DAY_OF_MONTH | ScheduleRule::FLAG_ANY_DAY_OF_WEEK;
+    expression.ruleCount = 1;
+    return expression;
+}
+
+bool ScheduleExpression::compile(const char* text) {
+    ScheduleRule parsed[MAX_RULES];
+    uint8_t count = 0;
+
+    const char* p = text;
+    while (true) {
+        const char* end = strchr(p, ';');
+        if (!end) {
+            end = p + strlen(p);
+        }
+        if (count == MAX_RULES || !parseRule(p, end, &parsed[count])) {
+            return false;
+        }
+        count++;
+        if (*end == '\0') {
+            break;
+        }
+        p = end + 1;
+    }
+
+    return setRules(parsed, count);
+}
+
+bool ScheduleExpression::setRules(const ScheduleRule* source, uint8_t count) {
+    if (count > MAX_RULES) {
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        const ScheduleRule& rule = source[i];
+        if ((rule.minutes & ALL_MINUTES) == 0 || (rule.hours & ALL_HOURS) == 0 ||
+            (rule.daysOfMonth & ALL_DAYS_OF_MONTH) == 0 || (rule.months & ALL_MONTHS) == 0 ||
+            (rule.daysOfWeek & ALL_DAYS_OF_WEEK) == 0) {
+            return false;
+        }
+    }
+
+    memset(rules, 0, sizeof(rules));
+    for (uint8_t i = 0; i < count; i++) {
+        rules[i] = source[i];
+        // Only defined bits, so equal schedules compare equal
+        rules[i].minutes &= ALL_MINUTES;
+        rules[i].hours &= ALL_HOURS;
+        rules[i].daysOfMonth &= ALL_DAYS_OF_MONTH;
+        rules[i].months &= ALL_MONTHS;
+        rules[i].daysOfWeek &= ALL_DAYS_OF_WEEK;
+        rules[i].flags &= ScheduleRule::FLAG_ANY_DAY_OF_MONTH | ScheduleRule::FLAG_ANY_DAY_OF_WEEK;
+        memset(rules[i].reserved, 0, sizeof(rules[i].reserved));
+    }
+    ruleCount = count;
+    return true;
+}
+
+bool ScheduleExpression::matches(const struct tm& local) const {
+    for (uint8_t i = 0; i < ruleCount; i++) {
+        const ScheduleRule& rule = rules[i];
+        if (((rule.minutes >> local.tm_min) & 1) && ((rule.hours >> local.tm_hour) & 1) &&
+            rule.matchesDay(local.tm_mday, local.tm_mon, local.tm_wday)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t ScheduleExpression::activeMinutes(int hour, int dayOfMonth, int month, int dayOfWeek) const {
+    uint64_t minutes = 0;
+    for (uint8_t i = 0; i < ruleCount; i++) {
+        if (((rules[i].hours >> hour) & 1) && rules[i].matchesDay(dayOfMonth, month, dayOfWeek)) {
+            minutes |= rules[i].minutes;
+        }
+    }
+    return minutes;
+}
+
+long ScheduleExpression::minutesUntil(const struct tm& local, bool active, long limitMinutes) const {
+    int year = local.tm_year + 1900;
+    int month = local.tm_mon;
+    int dayOfMonth = local.tm_mday;
+    int dayOfWeek = local.tm_wday;
+    int hour = local.tm_hour;
+    int minute = local.tm_min;
+    long elapsed = 0;  // Minutes from now to (hour, minute)
+
+    while (elapsed <= limitMinutes) {
+        // Hours of this day with any active minute: looking for an active
+        // minute, the others are skipped in one step
+        uint32_t dayHours = ALL_HOURS;
+        if (active) {
+            dayHours = 0;
+            for (uint8_t i = 0; i < ruleCount; i++) {
+                if (rules[i].matchesDay(dayOfMonth, month, dayOfWeek)) {
+                    dayHours |= rules[i].hours;
+                }
+            }
+        }
+
+        uint32_t candidates = dayHours & (ALL_HOURS << hour);
+        while (candidates) {
+            int next = __builtin_ctz(candidates);
+            if (next != hour) {
+                elapsed += (next - hour) * 60L - minute;
+                hour = next;
+                minute = 0;
+            }
+
+            uint64_t mask = activeMinutes(hour, dayOfMonth, month, dayOfWeek);
+            if (!active) {
+                mask = ~mask & ALL_MINUTES;
+            }
+            mask &= ALL_MINUTES << minute;
+            if (mask) {
+                long result = elapsed + (__builtin_ctzll(mask) - minute);
+                return result <= limitMinutes ? result : -1;
+            }
+            candidates &= candidates - 1;
+        }
+
+        // Nothing left today: continue at midnight
+        elapsed += (24 - hour) * 60L - minute;
+        hour = 0;
+        minute = 0;
+        dayOfWeek = (dayOfWeek + 1) % 7;
+        if (++dayOfMonth > daysInMonth(year, month)) {
+            dayOfMonth = 1;
+            if (++month == 12) {
+                month = 0;
+                year++;
+            }
+        }
+    }
+    return -1;
+}
+
+// Append to out as snprintf would, tracking the untruncated length
+static void append(char* out, size_t size, size_t* length, const char* text) {
+    size_t textLength = strlen(text);
+    if (*length < size) {
+        size_t room = size - *length - 1;
+        size_t copy = textLength < room ? textLength : room;
+        memcpy(out + *length, text, copy);
+        out[*length + copy] = '\0';
+    }
+    *length += textLength;
+}
+
+// Bitset as '*' or merged runs: "0-5,22-23"
+static void appendField(char* out, size_t size, size_t* length, uint64_t bits, int minValue, int maxValue, bool any) {
+    if (any) {
+        append(out, size, length, "*");
+        return;
+    }
+    bool first = true;
+    for (int value = minValue; value <= maxValue; value++) {
+        if (!((bits >> value) & 1)) {
+            continue;
+        }
+        int last = value;
+        while (last < maxValue && ((bits >> (last + 1)) & 1)) {
+            last++;
+        }
+        char run[16];
+        if (last == value) {
+            snprintf(run, sizeof(run), "%s%d", first ? "" : ",", value);
+        } else {
+            snprintf(run, sizeof(run), "%s%d-%d", first ? "" : ",", value, last);
+        }
+        append(out, size, length, run);
+        first = false;
+        value = last;
+    }
+}
+
+size_t ScheduleExpression::format(char* out, size_t size) const {
+    size_t length = 0;
+    if (size > 0) {
+        out[0] = '\0';
+    }
+    for (uint8_t i = 0; i < ruleCount; i++) {
+        const ScheduleRule& rule = rules[i];
+        if (i > 0) {
+            append(out, size, &length, "; ");
+        }
+        appendField(out, size, &length, rule.minutes, 0, 59, rule.minutes == ALL_MINUTES);
+        append(out, size, &length, " ");
+        appendField(out, size, &length, rule.hours, 0, 23, rule.hours == ALL_HOURS);
+        append(out, size, &length, " ");
+        appendField(out, size, &length, rule.daysOfMonth, 1, 31, (rule.flags & ScheduleRule::FLAG_ANY_DAY_OF_MONTH) != 0);
+        append(out, size, &length, " ");
+        appendField(out, size, &length, rule.months, 1, 12, rule.months == ALL_MONTHS);
+        append(out, size, &length, " ");
+        appendField(out, size, &length, rule.daysOfWeek, 0, 6, (rule.flags & ScheduleRule::FLAG_ANY_DAY_OF_WEEK) != 0);
+    }
+    return length;
+}
+
+bool ScheduleExpression::operator==(const ScheduleExpression& other) const {
+    return ruleCount == other.ruleCount && memcmp(rules, other.rules, ruleCount * sizeof(ScheduleRule)) == 0;
+}
@@ -0,0 +1,121 @@
+// src/ScheduleExpression.h
+#ifndef SCHEDULE_EXPRESSION_H
+#define SCHEDULE_EXPRESSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * One cron rule compiled to bitsets: bit n set = value n allowed.
+ * Fixed layout (24 bytes): it is stored as-is in ScheduleConfigRecord.
+ */
+struct ScheduleRule {
+    static const uint8_t FLAG_ANY_DAY_OF_MONTH = 0x01;  // Day-of-month field was '*'
+    static const uint8_t FLAG_ANY_DAY_OF_WEEK = 0x02;   // Day-of-week field was '*'
+
+    uint64_t minutes;      // Bits 0-59
+    uint32_t hours;        // Bits 0-23
+    uint32_t daysOfMonth;  // Bits 1-31
+    uint16_t months;       // Bits 1-12
+    uint8_t daysOfWeek;    // Bits 0-6, Sunday = 0
+    uint8_t flags;
+    uint8_t reserved[4];
+
+    /**
+     * Cron day matching: when both day fields are restricted, either may
+     * match; otherwise both must. Arguments as in struct tm (tm_mday,
+     * tm_mon 0-11, tm_wday).
+     */
+    bool matchesDay(int dayOfMonth, int month, int dayOfWeek) const {
+        if (!((months >> (month + 1)) & 1)) {
+            return false;
+        }
+        bool dom = (daysOfMonth >> dayOfMonth) & 1;
+        bool dow = (daysOfWeek >> dayOfWeek) & 1;
+        if ((flags & (FLAG_ANY_DAY_OF_MONTH | FLAG_ANY_DAY_OF_WEEK)) == 0) {
+            return dom || dow;
+        }
+        return dom && dow;
+    }
+};
+
+/**
+ * Active-time schedule written as cron-style rules and compiled to bitsets,
+ * so membership and "next change" queries are a few shifts and masks
+ * instead of branching on the fields.
+ *
+ * Rules are separated by ';'. Each has the five cron fields
+ *   minute(0-59) hour(0-23) day-of-month(1-31) month(1-12) day-of-week(0-7)
+ * and each field is '*' or a comma list of N, N-M or either with /STEP.
+ * Months take JAN-DEC and days of week SUN-SAT (0 and 7 are Sunday).
+ * A range whose end is below its start wraps (22-5 in the hour field spans
+ * midnight). Names and numbers are case-insensitive.
+ *
+ *   "* 9-17 * * *"                    9:00-17:59 every day (the default window)
+ *   "30-59 6 * * *; * 7-8 * * *"      6:30-8:59
+ *   "* 8-11,15-18 * * MON-FRI"        Two windows on weekdays
+ *   "* 20-5 * * *"                    Overnight, wrapping past midnight
+ *
+ * A minute is active when any rule matches it.
+ */
+class ScheduleExpression {
+public:
+    static const uint8_t MAX_RULES = 4;
+
+    // Empty: matches nothing
+    ScheduleExpression();
+
+    /**
+     * Hour window [startHour, endHour), wrapping past midnight when
+     * startHour > endHour. Equal hours give an empty schedule.
+     */
+    static ScheduleExpression hours(uint8_t startHour, uint8_t endHour);
+
+    /**
+     * Parse and compile an expression.
+     * @return false (expression unchanged) on a syntax or range error, or
+     *         more than MAX_RULES rules
+     */
+    bool compile(const char* text);
+
+    bool isEmpty() const { return ruleCount == 0; }
+    uint8_t getRuleCount() const { return ruleCount; }
+    const ScheduleRule& getRule(uint8_t index) const { return rules[index]; }
+
+    /**
+     * Restore compiled rules (e.g. from storage).
+     * @return false if count exceeds MAX_RULES or a rule has an empty field
+     */
+    bool setRules(const ScheduleRule* source, uint8_t count);
+
+    // Whether the minute containing local time is active
+    bool matches(const struct tm& local) const;
+
+    /**
+     * Whole minutes from the minute containing local until the first minute
+     * whose membership equals active (0 if the current minute already does).
+     * Wall-clock minutes: DST changes are not accounted for.
+     * @return -1 if there is no such minute within limitMinutes
+     */
+    long minutesUntil(const struct tm& local, bool active, long limitMinutes) const;
+
+    /**
+     * Canonical cron text of the compiled rules (ranges merged, names as
+     * numbers), truncated to size.
+     * @return Length of the full text, like snprintf
+     */
+    size_t format(char* out, size_t size) const;
+
+    bool operator==(const ScheduleExpression& other) const;
+    bool operator!=(const ScheduleExpression& other) const { return !(*this == other); }
+
+private:
+    ScheduleRule rules[MAX_RULES];
+    uint8_t ruleCount;
+
+    // Minutes of one hour active on a given day (bit n = minute n)
+    uint64_t activeMinutes(int hour, int dayOfMonth, int month, int dayOfWeek) const;
+};
+
+#endif
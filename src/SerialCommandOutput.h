@@ -0,0 +1,15 @@
+// src/SerialCommandOutput.h
+#ifndef SERIAL_COMMAND_OUTPUT_H
+#define SERIAL_COMMAND_OUTPUT_H
+
+#include "ICommandOutput.h"
+#include <Arduino.h>
+
+class SerialCommandOutput : public ICommandOutput {
+public:
+    void println(const char* line) override {
+        Serial.println(line);
+    }
+};
+
+#endif
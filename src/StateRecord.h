@@ -0,0 +1,61 @@
+// src/StateRecord.h
+#ifndef STATE_RECORD_H
+#define STATE_RECORD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "Crc32.h"
+
+/**
+ * Packed, versioned scheduler state as written to flash in a single blob.
+ * The CRC covers every byte before it, so a torn write (power lost mid
+ * commit) or bit rot is detected on load instead of restoring garbage.
+ *
+ * Layout (12 bytes, little-endian on ESP32):
+ *   version(1) flags(1) reserved(2) lastMistTime(4) crc(4)
+ */
+struct StateRecord {
+    static const uint8_t VERSION = 1;
+    static const uint8_t FLAG_HAS_EVER_MISTED = 0x01;
+    static const uint8_t FLAG_ENABLED = 0x02;
+
+    uint8_t version;
+    uint8_t flags;
+    uint8_t reserved[2];
+    uint32_t lastMistTime;
+    uint32_t crc;
+
+    StateRecord() { memset(this, 0, sizeof(*this)); }
+
+    /**
+     * Fill the record from scheduler state and seal it with a CRC.
+     */
+    void encode(unsigned long lastMistTime, bool hasEverMisted, bool enabled) {
+        memset(this, 0, sizeof(*this));
+        version = VERSION;
+        flags = (hasEverMisted ? FLAG_HAS_EVER_MISTED : 0) | (enabled ? FLAG_ENABLED : 0);
+        this->lastMistTime = (uint32_t)lastMistTime;
+        crc = computeCrc();
+    }
+
+    /**
+     * Validate version and CRC and unpack the state.
+     * @return false (outputs untouched) if the record is corrupt or from another version
+     */
+    bool decode(unsigned long* lastMistTime, bool* hasEverMisted, bool* enabled) const {
+        if (!isValid()) {
+            return false;
+        }
+        *lastMistTime = this->lastMistTime;
+        *hasEverMisted = (flags & FLAG_HAS_EVER_MISTED) != 0;
+        *enabled = (flags & FLAG_ENABLED) != 0;
+        return true;
+    }
+
+    bool isValid() const { return version == VERSION && crc == computeCrc(); }
+
+    uint32_t computeCrc() const { return crc32(this, offsetof(StateRecord, crc)); }
+};
+
+#endif
@@ -0,0 +1,83 @@
+// src/ThreadWorkerTask.h
+#ifndef THREAD_WORKER_TASK_H
+#define THREAD_WORKER_TASK_H
+
+#include "IWorkerTask.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+ * IWorkerTask backed by std::thread, for native builds and tests.
+ * Mirrors FreeRTOSWorkerTask: pending wakes coalesce into one run.
+ */
+class ThreadWorkerTask : public IWorkerTask {
+public:
+    ThreadWorkerTask() : running(false), pending(false), body(nullptr), arg(nullptr) {}
+
+    ~ThreadWorkerTask() {
+        stop();
+    }
+
+    bool start(WorkFunction workBody, void* workArg) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) {
+            return true;
+        }
+        body = workBody;
+        arg = workArg;
+        running = true;
+        thread = std::thread(&ThreadWorkerTask::run, this);
+        return true;
+    }
+
+    void wake() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending = true;
+        }
+        wakeup.notify_one();
+    }
+
+    void stop() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running) {
+                return;
+            }
+            running = false;
+        }
+        wakeup.notify_one();
+        thread.join();
+    }
+
+    void sleepMs(unsigned long ms) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+
+private:
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool running;
+    bool pending;
+    WorkFunction body;
+    void* arg;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wakeup.wait(lock, [this] { return pending || !running; });
+            if (!running) {
+                return;
+            }
+            pending = false;
+            lock.unlock();
+            body(arg);
+            lock.lock();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,128 @@
+// src/WiFiConnectionManager.cpp
+#include "WiFiConnectionManager.h"
+
+WiFiConnectionManager::WiFiConnectionManager(INetworkDriver* driver, IStateStorage* cacheStorage, LogCallback logger)
+    : driver(driver), cacheStorage(cacheStorage), logger(logger), eventLogger(nullptr),
+      state(WIFI_CONNECTED), stateStartMs(0), backoffMs(INITIAL_BACKOFF_MS), failedAttempts(0),
+      reuseIpLease(false), fastPathFailed(false), attemptFast(false),
+      connectStartMs(0), lastConnectMs(0), lastConnectFast(false) {
+}
+
+void WiFiConnectionManager::start(unsigned long nowMs) {
+    backoffMs = INITIAL_BACKOFF_MS;
+    failedAttempts = 0;
+    fastPathFailed = false;
+    connectStartMs = nowMs;
+
+    if (cacheStorage && !cacheStorage->loadNetworkCache(&cache)) {
+        cache.clear();
+    }
+
+    enterState(WIFI_BEGIN, nowMs);
+}
+
+void WiFiConnectionManager::step(unsigned long nowMs) {
+    switch (state) {
+        case WIFI_CONNECTED:
+            if (!driver->isConnected()) {
+                logEvent(LOG_MSG_WIFI_DISCONNECTED);
+                connectStartMs = nowMs;
+                enterState(WIFI_BEGIN, nowMs);
+            }
+            break;
+
+        case WIFI_BEGIN:
+            attemptFast = cache.valid && !fastPathFailed;
+            if (attemptFast) {
+                NetworkCache fast = cache;
+                if (!reuseIpLease) {
+                    fast.ip = fast.gateway = fast.subnet = fast.dns = 0;
+                }
+                driver->beginConnectFast(fast);
+            } else {
+                driver->beginConnect();
+            }
+            enterState(WIFI_WAITING, nowMs);
+            break;
+
+        case WIFI_WAITING:
+            if (driver->isConnected()) {
+                onConnected(nowMs, attemptFast ? LOG_STR_CACHED_BSSID : LOG_STR_FULL_SCAN);
+                enterState(WIFI_NTP_RESYNC, nowMs);
+            } else if (attemptFast && nowMs - stateStartMs >= FAST_CONNECT_TIMEOUT_MS) {
+                // Cached AP moved or gone; retry immediately with a full scan
+                logEvent(LOG_MSG_WIFI_FAST_CONNECT_FAILED);
+                fastPathFailed = true;
+                enterState(WIFI_BEGIN, nowMs);
+            } else if (nowMs - stateStartMs >= CONNECT_TIMEOUT_MS) {
+                failedAttempts++;
+                logEvent(LOG_MSG_WIFI_RETRY, (int32_t)(backoffMs / 1000));
+                enterState(WIFI_BACKOFF, nowMs);
+            }
+            break;
+
+        case WIFI_BACKOFF:
+            if (driver->isConnected()) {
+                // Link came back on its own (driver auto-reconnect)
+                onConnected(nowMs, LOG_STR_AUTO_RECONNECT);
+                enterState(WIFI_NTP_RESYNC, nowMs);
+            } else if (nowMs - stateStartMs >= backoffMs) {
+                backoffMs = (backoffMs * 2 < MAX_BACKOFF_MS) ? backoffMs * 2 : MAX_BACKOFF_MS;
+                enterState(WIFI_BEGIN, nowMs);
+            }
+            break;
+
+        case WIFI_NTP_RESYNC:
+            // Force NTP resync after reconnection
+            driver->startTimeSync();
+            backoffMs = INITIAL_BACKOFF_MS;
+            failedAttempts = 0;
+            enterState(WIFI_CONNECTED, nowMs);
+            break;
+    }
+}
+
+unsigned long WiFiConnectionManager::getNextStepMillis(unsigned long nowMs) const {
+    switch (state) {
+        case WIFI_CONNECTED:
+            return nowMs + CHECK_INTERVAL_MS;
+        case WIFI_WAITING:
+            return nowMs + CONNECT_POLL_MS;
+        case WIFI_BACKOFF:
+            return stateStartMs + backoffMs;
+        case WIFI_BEGIN:
+        case WIFI_NTP_RESYNC:
+            break;
+    }
+    return nowMs;
+}
+
+void WiFiConnectionManager::onConnected(unsigned long nowMs, uint8_t method) {
+    lastConnectMs = nowMs - connectStartMs;
+    lastConnectFast = attemptFast && state == WIFI_WAITING;
+    fastPathFailed = false;
+
+    logEvent(LOG_MSG_WIFI_CONNECTED, (int32_t)lastConnectMs, method);
+
+    // Refresh the cache; only write when the association actually changed
+    NetworkCache current;
+    if (cacheStorage && driver->getConnectionInfo(&current)) {
+        current.valid = 1;
+        if (!reuseIpLease) {
+            current.ip = current.gateway = current.subnet = current.dns = 0;
+        }
+        if (current != cache) {
+            cache = current;
+            cacheStorage->saveNetworkCache(cache);
+        }
+    }
+}
+
+void WiFiConnectionManager::enterState(WiFiConnState newState, unsigned long nowMs) {
+    state = newState;
+    stateStartMs = nowMs;
+}
+
+void WiFiConnectionManager::logEvent(uint8_t id, int32_t arg0, int32_t arg1, int32_t arg2, int32_t arg3) {
+    emitLogEvent(eventLogger, logger, id, arg0, arg1, arg2, arg3);
+}
@@ -0,0 +1,89 @@
+// src/WiFiConnectionManager.h
+#ifndef WIFI_CONNECTION_MANAGER_H
+#define WIFI_CONNECTION_MANAGER_H
+
+#include "INetworkDriver.h"
+#include "IStateStorage.h"
+#include "NetworkCache.h"
+#include "LogEvent.h"
+
+// Logging callback type (same as MistingScheduler)
+typedef void (*LogCallback)(const char* message);
+
+enum WiFiConnState {
+    WIFI_CONNECTED,     // Link up, monitoring for disconnects
+    WIFI_BEGIN,         // Start a connection attempt
+    WIFI_WAITING,       // Attempt in progress, waiting for link
+    WIFI_BACKOFF,       // Attempt failed, waiting before the next one
+    WIFI_NTP_RESYNC     // Link restored, restart time sync
+};
+
+/**
+ * Non-blocking WiFi reconnect state machine.
+ * step() advances at most one transition and never waits, so loop()
+ * keeps running serial commands and the scheduler while the AP is down.
+ * Failed attempts back off exponentially up to MAX_BACKOFF_MS.
+ *
+ * When a cached BSSID/channel is available (persisted via IStateStorage)
+ * each attempt first connects to it directly, skipping the channel scan,
+ * and falls back to a full scan only if that fails.
+ */
+class WiFiConnectionManager {
+public:
+    WiFiConnectionManager(INetworkDriver* driver, IStateStorage* cacheStorage = nullptr, LogCallback logger = nullptr);
+
+    // Reuse the cached IP lease as static config on fast connects (skips DHCP).
+    // Off by default: the lease may have expired and been handed out again.
+    void setReuseIpLease(bool reuse) { reuseIpLease = reuse; }
+
+    // Optional structured logging (see MistingScheduler::setEventLogger)
+    void setEventLogger(LogEventCallback callback) { eventLogger = callback; }
+
+    // Start the initial connection (boot); later drops are detected by step()
+    void start(unsigned long nowMs);
+
+    // Call from main loop with the current millis()
+    void step(unsigned long nowMs);
+
+    // Absolute millis() when step() next has work to do (for the tickless loop)
+    unsigned long getNextStepMillis(unsigned long nowMs) const;
+
+    WiFiConnState getState() const { return state; }
+    unsigned long getBackoffMs() const { return backoffMs; }
+    unsigned long getFailedAttempts() const { return failedAttempts; }
+    unsigned long getLastConnectMs() const { return lastConnectMs; }
+    bool lastConnectUsedCache() const { return lastConnectFast; }
+
+    // Configuration
+    static const unsigned long CONNECT_TIMEOUT_MS = 10000;   // Give up on an attempt after 10s
+    static const unsigned long FAST_CONNECT_TIMEOUT_MS = 3000; // Give up on the cached BSSID after 3s
+    static const unsigned long CONNECT_POLL_MS = 250;        // Link check period while waiting
+    static const unsigned long CHECK_INTERVAL_MS = 60000;    // Link check period when connected
+    static const unsigned long INITIAL_BACKOFF_MS = 5000;    // First retry delay
+    static const unsigned long MAX_BACKOFF_MS = 300000;      // Retry at least every 5 minutes
+
+private:
+    INetworkDriver* driver;
+    IStateStorage* cacheStorage;
+    LogCallback logger;
+    LogEventCallback eventLogger;
+
+    WiFiConnState state;
+    unsigned long stateStartMs;    // millis() when the current state was entered
+    unsigned long backoffMs;       // Delay before the next attempt
+    unsigned long failedAttempts;  // Consecutive failed attempts
+
+    NetworkCache cache;            // Last successful association
+    bool reuseIpLease;
+    bool fastPathFailed;           // Cached BSSID failed; full scan until next success
+    bool attemptFast;              // Current attempt uses the cached BSSID
+    unsigned long connectStartMs;  // millis() when the link was lost / start() called
+    unsigned long lastConnectMs;   // Duration of the last successful (re)connect
+    bool lastConnectFast;
+
+    void onConnected(unsigned long nowMs, uint8_t method);
+    void enterState(WiFiConnState newState, unsigned long nowMs);
+    void logEvent(uint8_t id, int32_t arg0 = 0, int32_t arg1 = 0, int32_t arg2 = 0, int32_t arg3 = 0);
+};
+
+#endif
@@ -6,27 +6,142 @@
 #include "NTPTimeProvider.h"
 #include "GPIORelayController.h"
 #include "NVSStateStorage.h"
+#include "EspCutoffTimer.h"
+#include "ArduinoWiFiDriver.h"
+#include "WiFiConnectionManager.h"
+#include "BootOrchestrator.h"
+#include "EspPartitionFlashRegion.h"
+#include "MistJournal.h"
+#include "FreeRTOSWorkerTask.h"
+#include "AsyncStateStorage.h"
+#include "RtcStateMirror.h"
+#include "LogRing.h"
+#include "BinaryLogEncoder.h"
+#include "RxRing.h"
+#include "LineAssembler.h"
+#include "LatencyStats.h"
+#include "SampleStats.h"
+#include "LoopTelemetry.h"
+#include "CommandRegistry.h"
+#include "SerialCommandOutput.h"
 #include <esp_task_wdt.h>
 
 #define RELAY_PIN 13
 
+// Tickless loop: sleep until the scheduler's next event or serial/network input
+// instead of polling every 100ms. Set to 0 to restore the fixed polling loop.
+#ifndef TICKLESS_LOOP
+#define TICKLESS_LOOP 1
+#endif
+
+// Quiet period before a state change is committed to flash, so bursts of
+// ENABLE/DISABLE commands become one write. 0 writes every change immediately.
+#ifndef STATE_SAVE_COALESCE_MS
+#define STATE_SAVE_COALESCE_MS 2000
+#endif
+
+// Task watchdog timeout: a loop pass (sleep included) longer than this resets
+const uint32_t WATCHDOG_TIMEOUT_S = 10;
+
 // NTP server configuration
 const char* ntpServer = "pool.ntp.org";
 
+#if TICKLESS_LOOP
+// Longest single sleep; keeps watchdog feeding well inside its 10 second timeout
+const unsigned long LOOP_MAX_SLEEP_MS = 5000;
+
+// Sleep while log lines wait for UART room (115200 baud drains ~115 bytes/10ms)
+const unsigned long LOG_DRAIN_POLL_MS = 10;
+
+// Loop task handle, notified by serial RX and WiFi events to end a sleep early
+TaskHandle_t loopTaskHandle = nullptr;
+
+void wakeLoop() {
+    if (loopTaskHandle) {
+        xTaskNotifyGive(loopTaskHandle);
+    }
+}
+#endif
+
+// Log messages are queued and written to Serial from loop() as the UART has
+// room, so logging never blocks the caller (any task may log)
+LogRing logRing;
+
+#if BINARY_LOG
+// Log output is binary records; decode with tools/decode_log.py
+BinaryLogEncoder logEncoder;
+#endif
+
+// Messages from other tasks: wake the loop so they are drained promptly
+void wakeLoopForLog() {
+#if TICKLESS_LOOP
+    if (xTaskGetCurrentTaskHandle() != loopTaskHandle) {
+        wakeLoop();
+    }
+#endif
+}
+
 // Logging function with timestamp
 void logWithTimestamp(const char* message) {
-    struct tm timeinfo;
-    if (getLocalTime(&timeinfo)) {
-        Serial.printf("%04d-%02d-%02d %02d:%02d:%02d | %s\n",
-                      timeinfo.tm_year + 1900,
-                      timeinfo.tm_mon + 1,
-                      timeinfo.tm_mday,
-                      timeinfo.tm_hour,
-                      timeinfo.tm_min,
-                      timeinfo.tm_sec,
-                      message);
-    } else {
-        Serial.printf("----/--/-- --:--:-- | %s\n", message);
+    logRing.push(message, millis(), time(nullptr));
+    wakeLoopForLog();
+}
+
+// Structured logging: catalog events are queued unformatted
+void logEventWithTimestamp(const LogEvent& event) {
+    logRing.push(event, millis(), time(nullptr));
+    wakeLoopForLog();
+}
+
+// Format and write queued log lines. Non-blocking mode stops as soon as the
+// UART TX buffer cannot take the next line; blocking mode writes everything
+// (boot, before a restart).
+void drainLog(bool blocking) {
+    LogEntry entry;
+#if BINARY_LOG
+    uint8_t record[BinaryLogEncoder::MAX_OUTPUT];
+#else
+    char message[LogEntry::MESSAGE_MAX];
+    char line[LogEntry::MESSAGE_MAX + 32];
+#endif
+    while (logRing.peek(&entry)) {
+#if BINARY_LOG
+        // Room for the worst case, so the encoder's time base stays in step
+        if (!blocking && Serial.availableForWrite() < (int)BinaryLogEncoder::MAX_OUTPUT) {
+            return;
+        }
+        Serial.write(record, logEncoder.encode(entry, record, sizeof(record)));
+#else
+        const char* text = entry.text;
+        if (entry.event.id != LOG_MSG_TEXT) {
+            formatLogEvent(entry.event, message, sizeof(message));
+            text = message;
+        }
+
+        struct tm timeinfo;
+        int length;
+        if (entry.epoch >= LogEntry::MIN_VALID_EPOCH && localtime_r(&entry.epoch, &timeinfo)) {
+            length = snprintf(line, sizeof(line), "%04d-%02d-%02d %02d:%02d:%02d | %s\n",
+                              timeinfo.tm_year + 1900,
+                              timeinfo.tm_mon + 1,
+                              timeinfo.tm_mday,
+                              timeinfo.tm_hour,
+                              timeinfo.tm_min,
+                              timeinfo.tm_sec,
+                              text);
+        } else {
+            length = snprintf(line, sizeof(line), "----/--/-- --:--:-- | %s\n", text);
+        }
+        if (length >= (int)sizeof(line)) {
+            length = sizeof(line) - 1;
+        }
+
+        if (!blocking && Serial.availableForWrite() < length) {
+            return;  // UART busy, continue on the next loop pass
+        }
+        Serial.write((const uint8_t*)line, length);
+#endif
+        logRing.pop();
     }
 }
 
@@ -34,11 +149,75 @@ void logWithTimestamp(const char* message) {
 NTPTimeProvider timeProvider;
 GPIORelayController relayController(RELAY_PIN);
 NVSStateStorage stateStorage(logWithTimestamp);
-MistingScheduler scheduler(&timeProvider, &relayController, &stateStorage, logWithTimestamp);
+// NVS writes (and their page erases) run on a background task, never in loop()
+FreeRTOSWorkerTask storageTask("state_io", tskIDLE_PRIORITY + 1, 4096);
+AsyncStateStorage asyncStorage(&stateStorage, &storageTask, logWithTimestamp);
+EspCutoffTimer cutoffTimer(&relayController);
+// State tier in RTC slow memory: survives watchdog/soft resets, flash is
+// written only when flags change or every few hours
+RTC_NOINIT_ATTR RtcStateBlock rtcStateBlock;
+RtcStateMirror rtcMirror(&rtcStateBlock, &asyncStorage, logWithTimestamp);
+MistingScheduler scheduler(&timeProvider, &relayController, &rtcMirror, logWithTimestamp, &cutoffTimer);
+ArduinoWiFiDriver wifiDriver(WIFI_SSID, WIFI_PASSWORD, ntpServer);
+WiFiConnectionManager wifiManager(&wifiDriver, &asyncStorage, logWithTimestamp);
+BootOrchestrator boot(&timeProvider, &wifiDriver, logWithTimestamp);
+EspPartitionFlashRegion journalFlash("mistlog");
+MistJournal journal(&journalFlash, logWithTimestamp);
+// Journal appends (and their sector erases) also stay off the loop
+FreeRTOSWorkerTask journalTask("journal_io", tskIDLE_PRIORITY + 1, 4096);
+
+// Serial commands: received bytes are queued by the UART event task and
+// assembled into lines by the main loop
+RxRing serialRx;
+LineAssembler commandLine;
+LatencyStats commandLatency;  // Terminator received -> command handled
+
+// Loop period, update() duration, watchdog feed gaps, slowest loop step
+LoopTelemetry loopTelemetry;
+
+// Feed the watchdog and record the gap since the previous feed
+void feedWatchdog() {
+    esp_task_wdt_reset();
+    loopTelemetry.watchdogFed(micros());
+}
+
+// UART event task: move received bytes into the ring with their arrival time
+void onSerialReceive() {
+    uint8_t chunk[32];
+    uint32_t nowUs = micros();
+    int available;
+    while ((available = Serial.available()) > 0) {
+        size_t count = Serial.read(chunk, ((size_t)available < sizeof(chunk)) ? (size_t)available : sizeof(chunk));
+        if (count == 0) {
+            break;
+        }
+        serialRx.write(chunk, count, nowUs);
+    }
+#if TICKLESS_LOOP
+    wakeLoop();
+#endif
+}
+
+// Runs from esp_restart() (e.g. after OTA): make flash current so a power cut
+// after the restart loses nothing held only in RTC memory or still waiting
+// out the save coalescing period
+void flushStateOnShutdown() {
+    scheduler.flushPendingSave();
+    rtcMirror.flushToFlash();
+    rtcMirror.waitForJournal();
+    asyncStorage.flush();
+    drainLog(true);
+}
 
 void setup() {
     Serial.begin(115200);
 
+    // Catalog messages are formatted (or binary-encoded) only when drained
+    scheduler.setEventLogger(logEventWithTimestamp);
+    wifiManager.setEventLogger(logEventWithTimestamp);
+    boot.setEventLogger(logEventWithTimestamp);
+    journal.setEventLogger(logEventWithTimestamp);
+
     // Relay safety check FIRST: ensure relay is OFF on boot (before watchdog init)
     pinMode(RELAY_PIN, OUTPUT);
     digitalWrite(RELAY_PIN, LOW);
@@ -54,92 +233,47 @@ void setup() {
 
     Serial.println("Relay initialized and verified OFF");
 
-    // WiFi setup (BEFORE watchdog init to avoid timeout during slow WiFi)
+    // Timezone first so a clock retained across a soft reset reads local time
+#ifdef TIMEZONE_STRING
+    setenv("TZ", TIMEZONE_STRING, 1);
+    tzset();
+    if (!timeProvider.setTimeZone(TIMEZONE_STRING)) {
+        Serial.println("WARNING: TIMEZONE_STRING not understood, using libc conversion");
+    }
+#endif
+
+    // Stage 1: restore state unconditionally, before anything can mist
+    boot.beginStage(BOOT_STATE_LOAD, millis());
+    scheduler.setSaveCoalesceMs(STATE_SAVE_COALESCE_MS);
+    if (journal.begin()) {
+        rtcMirror.setJournal(&journal, &journalTask);  // Before loading: a cold boot reads the newest mist
+    }
+    scheduler.loadState();
+    scheduler.setJournal(&rtcMirror);
+    asyncStorage.begin();
+    esp_register_shutdown_handler(flushStateOnShutdown);
+    boot.endStage(BOOT_STATE_LOAD, millis());
+
+    // Stages 2-3: network bring-up and time sync continue in the background.
+    // The scheduler stays in WAITING_SYNC until trustworthy time is available.
     WiFi.mode(WIFI_STA);
-    WiFi.disconnect();
-    delay(100);
-  
+
 	// Old esp32 stuff
 	WiFi.setMinSecurity(WIFI_AUTH_WEP);
 	WiFi.setScanMethod(WIFI_ALL_CHANNEL_SCAN);
 	WiFi.setSortMethod(WIFI_CONNECT_AP_BY_SIGNAL);
 
-	int n = WiFi.scanNetworks();
-    Serial.print("WiFi AP scan done...");
-    if (n == 0) {
-      Serial.println("no networks found");
-    } else {
-      Serial.print(n);
-      Serial.println(" networks found");
-      for (int i = 0; i < n; ++i) {
-        // Print SSID and RSSI for each network found
-        Serial.print(i + 1);
-        Serial.print(": ");
-        Serial.print(WiFi.SSID(i));
-        Serial.print(" (");
-        Serial.print(WiFi.RSSI(i));
-        Serial.print(")");
-        Serial.println((WiFi.encryptionType(i) == WIFI_AUTH_OPEN) ? " " : "*");
-        delay(10);
-      }
-    }
-    Serial.println("");
-
-    // Connect to WiFi
     Serial.print("Connecting to WiFi: ");
     Serial.println(WIFI_SSID);
-    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-
-
-    // Wait for connection (no watchdog yet, so safe to block)
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-        delay(500);
-        Serial.print(".");
-        attempts++;
-    }
-
-    if (WiFi.status() == WL_CONNECTED) {
-        Serial.println("\nWiFi connected!");
-        Serial.print("IP address: ");
-        Serial.println(WiFi.localIP());
-
-        // Initialize NTP time synchronization with timezone support
-        Serial.println("Synchronizing time with NTP server...");
-#ifdef TIMEZONE_STRING
-        // Use POSIX timezone string (handles DST automatically)
-        configTzTime(TIMEZONE_STRING, ntpServer);
-#else
-        // Fallback to legacy GMT offset method
-        configTime(GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC, ntpServer);
+#ifdef WIFI_REUSE_IP_LEASE
+    wifiManager.setReuseIpLease(true);
 #endif
+    wifiManager.start(millis());
+    boot.startBackground(millis());
 
-        // Wait for time to be set (still no watchdog, safe to block)
-        struct tm timeinfo;
-        int ntpAttempts = 0;
-        while (!getLocalTime(&timeinfo) && ntpAttempts < 10) {
-            Serial.print(".");
-            delay(500);
-            ntpAttempts++;
-        }
-
-        if (getLocalTime(&timeinfo)) {
-            Serial.println("\nTime synchronized!");
-            Serial.print("Current time: ");
-            Serial.println(&timeinfo, "%A, %B %d %Y %H:%M:%S");
-
-            // Load state from NVS after time is synchronized
-            scheduler.loadState();
-        } else {
-            Serial.println("\nFailed to synchronize time!");
-        }
-    } else {
-        Serial.println("\nWiFi connection failed!");
-    }
-
-    // NOW initialize watchdog timer AFTER all blocking operations
+    // Initialize watchdog timer (setup no longer blocks on network)
     // (10 second timeout, trigger panic/reset)
-    esp_task_wdt_init(10, true);
+    esp_task_wdt_init(WATCHDOG_TIMEOUT_S, true);
     esp_task_wdt_add(NULL);  // Add current task to watchdog
 
     // Check if system was reset by watchdog
@@ -148,117 +282,378 @@ void setup() {
         logWithTimestamp("WARNING: System restarted due to watchdog timeout");
     }
 
+    Serial.onReceive(onSerialReceive);
+
+#if TICKLESS_LOOP
+    loopTaskHandle = xTaskGetCurrentTaskHandle();
+    WiFi.onEvent([](arduino_event_id_t event, arduino_event_info_t info) {
+        wakeLoop();
+    });
+#endif
+
     logWithTimestamp("Setup complete, entering main loop");
+    drainLog(true);
 }
 
-void processSerialCommands() {
-    // Non-blocking: only process if data is available
-    if (!Serial.available()) {
+// Print the most recent mist cycles from the flash journal, newest first
+void printHistory(ICommandOutput* out) {
+    const size_t HISTORY_COUNT = 10;
+    MistRecord records[HISTORY_COUNT];
+
+    // Wait for events still staged in RTC memory, so the journal is complete
+    // and the journal task is not writing while it is read
+    if (!rtcMirror.waitForJournal()) {
+        out->println("ERROR: Journal busy, try HISTORY again");
         return;
     }
-
-    // Use fixed buffer instead of String to avoid heap fragmentation
-    const size_t MAX_CMD_LEN = 32;
-    char cmdBuffer[MAX_CMD_LEN];
-    size_t idx = 0;
-
-    // Read command with bounds checking
-    while (Serial.available() && idx < MAX_CMD_LEN - 1) {
-        int c = Serial.read();
-        if (c == -1) break;  // No data
-        if (c == '\n' || c == '\r') break;  // End of command
-        cmdBuffer[idx++] = (char)c;
+    size_t count = journal.readRecent(records, HISTORY_COUNT);
+    if (count == 0) {
+        out->println("HISTORY: no records");
+        return;
     }
-    cmdBuffer[idx] = '\0';
 
-    // Flush any remaining characters if command was too long
-    if (idx == MAX_CMD_LEN - 1) {
-        while (Serial.available() && Serial.read() != '\n');
-        Serial.println("ERROR: Command too long (max 31 chars)");
-        return;
+    char line[96];
+    for (size_t i = 0; i < count; i++) {
+        struct tm timeinfo;
+        time_t start = (time_t)records[i].startEpoch;
+        localtime_r(&start, &timeinfo);
+        snprintf(line, sizeof(line), "HISTORY: #%lu %04d-%02d-%02d %02d:%02d:%02d %lums %s %s",
+                 (unsigned long)records[i].sequence,
+                 timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
+                 timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec,
+                 (unsigned long)records[i].durationMs,
+                 records[i].trigger == MIST_TRIGGER_FORCE ? "force" : "schedule",
+                 records[i].outcome == MIST_OUTCOME_FAILSAFE ? "FAILSAFE" : "ok");
+        out->println(line);
     }
+}
 
-    // Trim trailing whitespace
-    while (idx > 0 && (cmdBuffer[idx-1] == ' ' || cmdBuffer[idx-1] == '\t')) {
-        cmdBuffer[--idx] = '\0';
+// On-device microbenchmarks (BENCH): CPU cycles per call, so the numbers
+// include flash wait states, the soft-float ABI and the real NVS driver
+const size_t BENCH_MAX_SAMPLES = 200;
+uint32_t benchSamples[BENCH_MAX_SAMPLES];
+const char* BENCH_LOG_MESSAGE = "BENCH: log sample";
+
+void printBenchResult(ICommandOutput* out, const char* op, size_t count) {
+    SampleSummary summary = summarizeSamples(benchSamples, count);
+    uint32_t mhz = getCpuFrequencyMhz();
+    char line[128];
+    snprintf(line, sizeof(line), "BENCH: op=%s n=%lu min=%lu median=%lu p99=%lu max=%lu cycles medianNs=%lu",
+             op, (unsigned long)summary.count, (unsigned long)summary.min,
+             (unsigned long)summary.median, (unsigned long)summary.p99, (unsigned long)summary.max,
+             (unsigned long)(mhz ? (uint64_t)summary.median * 1000 / mhz : 0));
+    out->println(line);
+}
+
+// BENCH times update() on a copy of the scheduler whose relay is not wired
+// to the pin, so a mist falling due mid-run never energises the pump
+class DetachedRelay : public IRelayController {
+public:
+    void turnOn() override {}
+    void turnOff() override {}
+};
+
+DetachedRelay benchRelay;
+MistingScheduler benchScheduler(&timeProvider, &benchRelay);
+
+size_t benchUpdate() {
+    for (size_t i = 0; i < BENCH_MAX_SAMPLES; i++) {
+        scheduler.copyStateTo(&benchScheduler);  // Outside the timed region
+        uint32_t start = ESP.getCycleCount();
+        benchScheduler.update();
+        benchSamples[i] = ESP.getCycleCount() - start;
     }
+    return BENCH_MAX_SAMPLES;
+}
 
-    // Trim leading whitespace
-    char* cmd = cmdBuffer;
-    while (*cmd == ' ' || *cmd == '\t') {
-        cmd++;
+// Alternates the stored lastMistTime with a value one second later so every
+// save is a real flash write (NVS skips a blob identical to the stored one),
+// then reads it back. The even sample count leaves the original record in
+// place; on a failed write the original is saved again before returning 0.
+size_t benchStorageRoundTrip(bool* writeFailed) {
+    const size_t SAMPLES = 20;
+    unsigned long lastMistTime;
+    bool hasEverMisted;
+    bool enabled;
+    *writeFailed = false;
+    if (!stateStorage.load(&lastMistTime, &hasEverMisted, &enabled)) {
+        return 0;
+    }
+    for (size_t i = 0; i < SAMPLES; i++) {
+        unsigned long value = (i % 2 == 0) ? lastMistTime + 1 : lastMistTime;
+        unsigned long readBack;
+        bool readHasEverMisted;
+        bool readEnabled;
+        uint32_t start = ESP.getCycleCount();
+        bool saved = stateStorage.save(value, hasEverMisted, enabled);
+        stateStorage.load(&readBack, &readHasEverMisted, &readEnabled);
+        benchSamples[i] = ESP.getCycleCount() - start;
+        drainLog(true);  // NVS progress lines, outside the timed region
+        if (!saved) {
+            stateStorage.save(lastMistTime, hasEverMisted, enabled);
+            *writeFailed = true;
+            return 0;
+        }
     }
+    return SAMPLES;
+}
 
-    // Convert to uppercase in-place
-    for (char* p = cmd; *p; p++) {
-        if (*p >= 'a' && *p <= 'z') {
-            *p = *p - 32;
+// Each push lands in an empty ring, as in steady state; the sample line is
+// dropped unless another task logged in between
+size_t benchLog() {
+    const size_t SAMPLES = 100;
+    LogEntry entry;
+    for (size_t i = 0; i < SAMPLES; i++) {
+        drainLog(true);
+        uint32_t start = ESP.getCycleCount();
+        logWithTimestamp(BENCH_LOG_MESSAGE);
+        benchSamples[i] = ESP.getCycleCount() - start;
+        if (logRing.getDepth() == 1 && logRing.peek(&entry) && strcmp(entry.text, BENCH_LOG_MESSAGE) == 0) {
+            logRing.pop();
         }
     }
+    return SAMPLES;
+}
 
-    // Skip empty commands
-    if (*cmd == '\0') {
+// Arduino's getLocalTime() with no wait: time() plus localtime_r()
+size_t benchLocalTime() {
+    struct tm timeinfo;
+    for (size_t i = 0; i < BENCH_MAX_SAMPLES; i++) {
+        uint32_t start = ESP.getCycleCount();
+        getLocalTime(&timeinfo, 0);
+        benchSamples[i] = ESP.getCycleCount() - start;
+    }
+    return BENCH_MAX_SAMPLES;
+}
+
+// Command handlers (see COMMANDS below)
+void cmdBench(const CommandArgs& args, ICommandOutput* out, void* context) {
+    if (scheduler.getState() == MISTING) {
+        out->println("ERROR: Mist in progress, try BENCH again when idle");
         return;
     }
+    drainLog(true);  // Keep earlier log lines ahead of the results
+
+    printBenchResult(out, "update", benchUpdate());
+    feedWatchdog();
+
+    // The storage task must be idle: NVSStateStorage is not shared safely
+    size_t count;
+    bool writeFailed;
+    if (!asyncStorage.flush()) {
+        out->println("ERROR: Storage busy, skipped nvs_write_read");
+    } else if ((count = benchStorageRoundTrip(&writeFailed)) > 0) {
+        printBenchResult(out, "nvs_write_read", count);
+    } else if (writeFailed) {
+        out->println("ERROR: NVS write failed, skipped nvs_write_read");
+    } else {
+        out->println("ERROR: No saved state, skipped nvs_write_read");
+    }
+    feedWatchdog();
 
-    // Process commands using strcmp for safety
-    if (strcmp(cmd, "ENABLE") == 0) {
-        scheduler.setEnabled(true);
-        Serial.println("OK: Scheduler enabled");
-    } else if (strcmp(cmd, "DISABLE") == 0) {
-        scheduler.setEnabled(false);
-        Serial.println("OK: Scheduler disabled");
-    } else if (strcmp(cmd, "FORCE_MIST") == 0) {
-        scheduler.forceMist();
-        Serial.println("OK: Force mist command sent");
-    } else if (strcmp(cmd, "STATUS") == 0) {
-        scheduler.printStatus();
+    printBenchResult(out, "log", benchLog());
+    printBenchResult(out, "local_time", benchLocalTime());
+}
+
+void cmdDisable(const CommandArgs& args, ICommandOutput* out, void* context) {
+    scheduler.setEnabled(false);
+    out->println("OK: Scheduler disabled");
+}
+
+void cmdEnable(const CommandArgs& args, ICommandOutput* out, void* context) {
+    scheduler.setEnabled(true);
+    out->println("OK: Scheduler enabled");
+}
+
+void cmdForceMist(const CommandArgs& args, ICommandOutput* out, void* context) {
+    if (args.has(0)) {
+        scheduler.forceMist((unsigned long)args.values[0] * 1000);
     } else {
-        Serial.print("ERROR: Unknown command: ");
-        Serial.println(cmd);
+        scheduler.forceMist();
     }
+    out->println("OK: Force mist command sent");
 }
 
-// WiFi monitoring
-unsigned long lastWiFiCheck = 0;
-const unsigned long WIFI_CHECK_INTERVAL = 60000;  // Check every 1 minute
+void cmdHelp(const CommandArgs& args, ICommandOutput* out, void* context);
 
-void checkWiFiConnection() {
-    if (WiFi.status() != WL_CONNECTED) {
-        logWithTimestamp("WARNING: WiFi disconnected, attempting reconnect");
-        WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+void cmdHistory(const CommandArgs& args, ICommandOutput* out, void* context) {
+    printHistory(out);
+}
 
-        int attempts = 0;
-        while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-            delay(500);
-            esp_task_wdt_reset();  // Feed watchdog during reconnection
-            attempts++;
+// Apply an edited copy of the live config: validated and swapped as a whole
+void applyConfig(const ScheduleConfig& config, ICommandOutput* out) {
+    if (!scheduler.setConfig(config)) {
+        out->println("ERROR: Invalid schedule (mist must be shorter than the interval, window not empty)");
+        return;
+    }
+    char window[96];
+    char line[160];
+    config.activeWindow.format(window, sizeof(window));
+    snprintf(line, sizeof(line), "OK: interval=%lus mist=%lums window=\"%s\" (saved)",
+             config.intervalSeconds, config.mistDurationMs, window);
+    out->println(line);
+}
+
+void cmdSetDuration(const CommandArgs& args, ICommandOutput* out, void* context) {
+    ScheduleConfig config = scheduler.getConfig();
+    config.mistDurationMs = (unsigned long)args.values[0] * 1000;
+    applyConfig(config, out);
+}
+
+void cmdSetInterval(const CommandArgs& args, ICommandOutput* out, void* context) {
+    ScheduleConfig config = scheduler.getConfig();
+    config.intervalSeconds = (unsigned long)args.values[0];
+    applyConfig(config, out);
+}
+
+void cmdSetSchedule(const CommandArgs& args, ICommandOutput* out, void* context) {
+    ScheduleConfig config = scheduler.getConfig();
+    if (!config.activeWindow.compile(args.words[0])) {
+        out->println("ERROR: Invalid expression (MIN HOUR DAY MONTH WEEKDAY, rules separated by ;)");
+        return;
+    }
+    applyConfig(config, out);
+}
+
+void cmdSetWindow(const CommandArgs& args, ICommandOutput* out, void* context) {
+    ScheduleConfig config = scheduler.getConfig();
+    config.activeWindow = ScheduleExpression::hours((uint8_t)args.values[0], (uint8_t)args.values[1]);
+    applyConfig(config, out);
+}
+
+void cmdStatus(const CommandArgs& args, ICommandOutput* out, void* context) {
+    drainLog(true);  // Keep earlier log lines ahead of the report
+    scheduler.printStatus();
+    drainLog(true);
+
+    char window[96];
+    char line[128];
+    scheduler.getConfig().activeWindow.format(window, sizeof(window));
+    snprintf(line, sizeof(line), "STATUS: window=\"%s\"", window);
+    out->println(line);
+    snprintf(line, sizeof(line), "LOG: pushed=%lu dropped=%lu maxDepth=%u",
+             (unsigned long)logRing.getPushedCount(),
+             (unsigned long)logRing.getDroppedCount(),
+             (unsigned)logRing.getMaxDepth());
+    out->println(line);
+    snprintf(line, sizeof(line), "CMD: count=%lu last=%luus max=%luus mean=%luus rxDropped=%lu",
+             (unsigned long)commandLatency.count,
+             (unsigned long)commandLatency.lastUs,
+             (unsigned long)commandLatency.maxUs,
+             (unsigned long)commandLatency.getMeanUs(),
+             (unsigned long)serialRx.getOverflowCount());
+    out->println(line);
+}
+
+void cmdStats(const CommandArgs& args, ICommandOutput* out, void* context) {
+    if (args.has(0)) {
+        if (strcasecmp(args.words[0], "RESET") != 0) {
+            out->println("ERROR: Usage: STATS [RESET]");
+            return;
         }
+        loopTelemetry.reset();
+        out->println("OK: Loop statistics cleared");
+        return;
+    }
+    loopTelemetry.print(out, WATCHDOG_TIMEOUT_S * 1000);
+}
 
-        if (WiFi.status() == WL_CONNECTED) {
-            logWithTimestamp("WiFi reconnected");
-            // Force NTP resync after reconnection
-#ifdef TIMEZONE_STRING
-            configTzTime(TIMEZONE_STRING, ntpServer);
-#else
-            configTime(GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC, ntpServer);
-#endif
-        } else {
-            logWithTimestamp("ERROR: WiFi reconnection failed");
+// Serial command table: sorted by name (checked at compile time)
+constexpr CommandSpec COMMANDS[] = {
+    { "BENCH",        "",   0,  0,     "",          "Time update, NVS, log and clock calls",    cmdBench },
+    { "DISABLE",      "",   0,  0,     "",          "Stop automatic misting (saved)",           cmdDisable },
+    { "ENABLE",       "",   0,  0,     "",          "Resume automatic misting (saved)",         cmdEnable },
+    { "FORCE_MIST",   "U",  1,  120,   "[seconds]", "Mist now, optionally for 1-120 seconds",   cmdForceMist },
+    { "HELP",         "W",  0,  0,     "[command]", "List commands, or describe one",           cmdHelp },
+    { "HISTORY",      "",   0,  0,     "",          "Show the last 10 mist cycles",             cmdHistory },
+    { "SET_DURATION", "u",  1,  120,   "seconds",   "Set the scheduled mist length (saved)",    cmdSetDuration },
+    { "SET_INTERVAL", "u",  60, 86400, "seconds",   "Set the time between mists (saved)",       cmdSetInterval },
+    { "SET_SCHEDULE", "t",  0,  0,     "cron",      "Set the active window as cron rules",      cmdSetSchedule },
+    { "SET_WINDOW",   "uu", 0,  24,    "start end", "Set the active hours [start, end)",        cmdSetWindow },
+    { "STATS",        "W",  0,  0,     "[RESET]",   "Show loop timing and watchdog margin",     cmdStats },
+    { "STATUS",       "",   0,  0,     "",          "Show scheduler, log and command status",   cmdStatus },
+};
+static_assert(commandTableSorted(COMMANDS, sizeof(COMMANDS) / sizeof(COMMANDS[0])),
+              "COMMANDS must be sorted by name");
+
+CommandRegistry commands(COMMANDS, sizeof(COMMANDS) / sizeof(COMMANDS[0]));
+SerialCommandOutput serialOutput;
+
+void cmdHelp(const CommandArgs& args, ICommandOutput* out, void* context) {
+    commands.printHelp(out, args.has(0) ? args.words[0] : nullptr);
+}
+
+void processSerialCommands() {
+    // Dispatch every line completed by the bytes received so far; a partial
+    // command stays in the assembler until its terminator arrives
+    uint8_t c;
+    uint32_t receivedUs;
+    while (serialRx.read(&c, &receivedUs)) {
+        LineStatus status = commandLine.push((char)c);
+        if (status == LINE_TOO_LONG) {
+            Serial.println("ERROR: Command too long (max 63 chars)");
+        } else if (status == LINE_READY) {
+            char line[LineAssembler::MAX_LINE];
+            strcpy(line, commandLine.getLine());
+            commands.execute(line, &serialOutput);
+            commandLatency.record(micros() - receivedUs);
         }
     }
 }
 
+#if TICKLESS_LOOP
+// Block until the next scheduler event, WiFi step, or input notification
+void waitForNextEvent() {
+    // More received bytes pending - handle them before sleeping
+    if (!serialRx.isEmpty()) {
+        return;
+    }
+
+    unsigned long now = millis();
+    long waitMs = (long)(scheduler.getNextEventMillis() - now);
+    long untilWiFiStep = (long)(wifiManager.getNextStepMillis(now) - now);
+    if (untilWiFiStep < waitMs) {
+        waitMs = untilWiFiStep;
+    }
+    if (waitMs > (long)LOOP_MAX_SLEEP_MS) {
+        waitMs = LOOP_MAX_SLEEP_MS;
+    }
+    if (!logRing.isEmpty() && waitMs > (long)LOG_DRAIN_POLL_MS) {
+        waitMs = LOG_DRAIN_POLL_MS;
+    }
+    if (waitMs <= 0) {
+        return;
+    }
+
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+}
+#endif
+
 void loop() {
-    esp_task_wdt_reset();  // Feed the watchdog to prove system is alive
+    feedWatchdog();  // Feed the watchdog to prove system is alive
+    loopTelemetry.beginIteration(micros());
+
+    // Advance WiFi reconnect state machine (never blocks)
+    wifiManager.step(millis());
+    loopTelemetry.mark(LOOP_WIFI, micros());
 
-    // Periodic WiFi connection check
-    if (millis() - lastWiFiCheck >= WIFI_CHECK_INTERVAL) {
-        checkWiFiConnection();
-        lastWiFiCheck = millis();
+    // Complete background boot stages (network, time sync); the network
+    // stage can finish after the system is ready
+    if (!boot.isComplete()) {
+        boot.step(millis());
     }
+    loopTelemetry.mark(LOOP_BOOT, micros());
 
     processSerialCommands();
+    loopTelemetry.mark(LOOP_COMMANDS, micros());
     scheduler.update();
+    loopTelemetry.mark(LOOP_SCHEDULER, micros());
+    drainLog(false);
+    loopTelemetry.mark(LOOP_LOG, micros());
+#if TICKLESS_LOOP
+    waitForNextEvent();
+#else
     delay(100);
+#endif
+    loopTelemetry.mark(LOOP_IDLE, micros());
 }
@@ -0,0 +1,37 @@
+// test/native/mocks/MockCommandOutput.h
+#ifndef MOCK_COMMAND_OUTPUT_H
+#define MOCK_COMMAND_OUTPUT_H
+
+#include "ICommandOutput.h"
+#include <string.h>
+
+class MockCommandOutput : public ICommandOutput {
+public:
+    static const int MAX_LINES = 32;
+    static const int MAX_LINE_LENGTH = 128;
+
+    MockCommandOutput() { reset(); }
+
+    void println(const char* line) override {
+        if (lineCount < MAX_LINES) {
+            strncpy(lines[lineCount], line, MAX_LINE_LENGTH - 1);
+            lines[lineCount][MAX_LINE_LENGTH - 1] = '\0';
+            lineCount++;
+        }
+    }
+
+    // Test helpers
+    int getLineCount() const { return lineCount; }
+    const char* getLine(int index) const { return (index < lineCount) ? lines[index] : ""; }
+    const char* getLastLine() const { return lineCount ? lines[lineCount - 1] : ""; }
+    void reset() {
+        lineCount = 0;
+        memset(lines, 0, sizeof(lines));
+    }
+
+private:
+    char lines[MAX_LINES][MAX_LINE_LENGTH];
+    int lineCount;
+};
+
+#endif
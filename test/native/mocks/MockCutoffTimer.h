@@ -0,0 +1,57 @@
+// test/native/mocks/MockCutoffTimer.h
+#ifndef MOCK_CUTOFF_TIMER_H
+#define MOCK_CUTOFF_TIMER_H
+
+#include "ICutoffTimer.h"
+#include "IRelayController.h"
+
+/**
+ * Simulated one-shot cut-off timer for native tests.
+ * Tests call fire() to emulate the hardware timer expiring, which turns
+ * the relay off exactly like the esp_timer callback does on target.
+ */
+class MockCutoffTimer : public ICutoffTimer {
+public:
+    MockCutoffTimer(IRelayController* relayController)
+        : relayController(relayController), armed(false), fired(false),
+          armedDurationMs(0), armCount(0), cancelCount(0) {}
+
+    bool arm(unsigned long durationMs) override {
+        armed = true;
+        fired = false;
+        armedDurationMs = durationMs;
+        armCount++;
+        return true;
+    }
+
+    void cancel() override {
+        armed = false;
+        cancelCount++;
+    }
+
+    bool hasFired() const override { return fired; }
+
+    // Test control methods
+    void fire() {
+        if (!armed) return;
+        armed = false;
+        relayController->turnOff();
+        fired = true;
+    }
+
+    // Test inspection methods
+    bool isArmed() const { return armed; }
+    unsigned long getArmedDurationMs() const { return armedDurationMs; }
+    int getArmCount() const { return armCount; }
+    int getCancelCount() const { return cancelCount; }
+
+private:
+    IRelayController* relayController;
+    bool armed;
+    bool fired;
+    unsigned long armedDurationMs;
+    int armCount;
+    int cancelCount;
+};
+
+#endif
@@ -0,0 +1,71 @@
+// test/native/mocks/MockFlashRegion.h
+#ifndef MOCK_FLASH_REGION_H
+#define MOCK_FLASH_REGION_H
+
+#include "IFlashRegion.h"
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+/**
+ * RAM image of a NOR flash region for native tests.
+ * Writes can only clear bits (like real flash), and a power cut can be
+ * scheduled to land in the middle of a write or erase.
+ */
+class MockFlashRegion : public IFlashRegion {
+public:
+    MockFlashRegion(size_t sectorCount, size_t sectorSize = 4096)
+        : image(sectorCount * sectorSize, 0xFF), sectorSize(sectorSize),
+          powerBudget(-1), readCount(0), writeCount(0), eraseCount(sectorCount, 0) {
+    }
+
+    size_t getSize() const override { return image.size(); }
+    size_t getSectorSize() const override { return sectorSize; }
+
+    bool read(size_t offset, void* data, size_t length) override {
+        if (offset + length > image.size()) return false;
+        memcpy(data, &image[offset], length);
+        readCount++;
+        return true;
+    }
+
+    bool write(size_t offset, const void* data, size_t length) override {
+        if (offset + length > image.size() || powerBudget == 0) return false;
+        const uint8_t* bytes = (const uint8_t*)data;
+        for (size_t i = 0; i < length; i++) {
+            if (powerBudget == 0) return false;  // Power lost mid-write
+            image[offset + i] &= bytes[i];
+            if (powerBudget > 0) powerBudget--;
+        }
+        writeCount++;
+        return true;
+    }
+
+    bool eraseSector(size_t sector) override {
+        if ((sector + 1) * sectorSize > image.size() || powerBudget == 0) return false;
+        memset(&image[sector * sectorSize], 0xFF, sectorSize);
+        eraseCount[sector]++;
+        return true;
+    }
+
+    // Test control: lose power after programming this many more bytes
+    void cutPowerAfterBytes(long bytes) { powerBudget = bytes; }
+    void restorePower() { powerBudget = -1; }
+
+    // Test inspection
+    uint8_t* getImage() { return &image[0]; }
+    int getReadCount() const { return readCount; }
+    void resetReadCount() { readCount = 0; }
+    int getWriteCount() const { return writeCount; }
+    int getEraseCount(size_t sector) const { return eraseCount[sector]; }
+
+private:
+    std::vector<uint8_t> image;
+    size_t sectorSize;
+    long powerBudget;  // Bytes left before power loss, -1 = unlimited
+    int readCount;
+    int writeCount;
+    std::vector<int> eraseCount;
+};
+
+#endif
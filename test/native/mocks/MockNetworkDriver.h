@@ -0,0 +1,43 @@
+// test/native/mocks/MockNetworkDriver.h
+#ifndef MOCK_NETWORK_DRIVER_H
+#define MOCK_NETWORK_DRIVER_H
+
+#include "INetworkDriver.h"
+
+class MockNetworkDriver : public INetworkDriver {
+public:
+    MockNetworkDriver() : connected(true), beginCount(0), fastBeginCount(0), timeSyncCount(0) {}
+
+    void beginConnect() override { beginCount++; }
+    void beginConnectFast(const NetworkCache& cache) override {
+        fastBeginCount++;
+        lastFastCache = cache;
+    }
+    bool getConnectionInfo(NetworkCache* cache) override {
+        if (!connected) return false;
+        *cache = connectionInfo;
+        return true;
+    }
+    bool isConnected() override { return connected; }
+    void startTimeSync() override { timeSyncCount++; }
+
+    // Test control methods
+    void setConnected(bool value) { connected = value; }
+    void setConnectionInfo(const NetworkCache& info) { connectionInfo = info; }
+
+    // Test inspection methods
+    int getBeginCount() const { return beginCount; }
+    int getFastBeginCount() const { return fastBeginCount; }
+    const NetworkCache& getLastFastCache() const { return lastFastCache; }
+    int getTimeSyncCount() const { return timeSyncCount; }
+
+private:
+    bool connected;
+    int beginCount;
+    int fastBeginCount;
+    int timeSyncCount;
+    NetworkCache connectionInfo;
+    NetworkCache lastFastCache;
+};
+
+#endif
@@ -3,6 +3,8 @@
 #define MOCK_STATE_STORAGE_H
 
 #include "IStateStorage.h"
+#include <stdint.h>
+#include <string.h>
 
 /**
  * Mock implementation of IStateStorage for native unit tests.
@@ -15,7 +17,14 @@ public:
         : lastMistTime(0),
           hasEverMisted(false),
           enabled(true),
-          saveCallCount(0) {
+          saveCallCount(0),
+          failSaves(false),
+          loadCallCount(0),
+          networkCacheSaveCount(0),
+          zoneStateLength(0),
+          zoneStateSaveCount(0),
+          scheduleConfigLength(0),
+          scheduleConfigSaveCount(0) {
     }
 
     // IStateStorage interface implementation
@@ -32,6 +41,7 @@ public:
     }
 
     bool save(unsigned long lastMistTime, bool hasEverMisted, bool enabled) override {
+        if (failSaves) return false;
         this->lastMistTime = lastMistTime;
         this->hasEverMisted = hasEverMisted;
         this->enabled = enabled;
@@ -39,18 +49,83 @@ public:
         return true;
     }
 
+    bool load(unsigned long* lastMistTime, bool* hasEverMisted, bool* enabled) override {
+        loadCallCount++;
+        return IStateStorage::load(lastMistTime, hasEverMisted, enabled);
+    }
+
+    bool loadNetworkCache(NetworkCache* cache) override {
+        if (!networkCache.valid) return false;
+        *cache = networkCache;
+        return true;
+    }
+
+    bool saveNetworkCache(const NetworkCache& cache) override {
+        networkCache = cache;
+        networkCacheSaveCount++;
+        return true;
+    }
+
+    bool loadZoneState(void* record, size_t length) override {
+        if (zoneStateLength == 0 || zoneStateLength != length) return false;
+        memcpy(record, zoneState, length);
+        return true;
+    }
+
+    bool saveZoneState(const void* record, size_t length) override {
+        if (length > sizeof(zoneState)) return false;
+        memcpy(zoneState, record, length);
+        zoneStateLength = length;
+        zoneStateSaveCount++;
+        return true;
+    }
+
+    bool loadScheduleConfig(void* record, size_t length) override {
+        if (scheduleConfigLength == 0 || scheduleConfigLength != length) return false;
+        memcpy(record, scheduleConfig, length);
+        return true;
+    }
+
+    bool saveScheduleConfig(const void* record, size_t length) override {
+        if (failSaves || length > sizeof(scheduleConfig)) return false;
+        memcpy(scheduleConfig, record, length);
+        scheduleConfigLength = length;
+        scheduleConfigSaveCount++;
+        return true;
+    }
+
     // Test helper methods
     void setLastMistTime(unsigned long time) { lastMistTime = time; }
     void setHasEverMisted(bool value) { hasEverMisted = value; }
     void setEnabled(bool value) { enabled = value; }
     int getSaveCallCount() const { return saveCallCount; }
     void resetSaveCallCount() { saveCallCount = 0; }
+    int getLoadCallCount() const { return loadCallCount; }
+    void setSaveFails(bool fails) { failSaves = fails; }
+    void setNetworkCache(const NetworkCache& cache) { networkCache = cache; }
+    const NetworkCache& getNetworkCache() const { return networkCache; }
+    int getNetworkCacheSaveCount() const { return networkCacheSaveCount; }
+    int getZoneStateSaveCount() const { return zoneStateSaveCount; }
+    size_t getZoneStateLength() const { return zoneStateLength; }
+    uint8_t* getZoneStateBytes() { return zoneState; }
+    int getScheduleConfigSaveCount() const { return scheduleConfigSaveCount; }
+    uint8_t* getScheduleConfigBytes() { return scheduleConfig; }
 
 private:
     unsigned long lastMistTime;
     bool hasEverMisted;
     bool enabled;
     int saveCallCount;  // Track number of times save() was called
+    bool failSaves;     // Simulate a storage write error
+    int loadCallCount;  // Track number of batch load() calls
+    NetworkCache networkCache;
+    int networkCacheSaveCount;
+    uint8_t zoneState[256];
+    size_t zoneStateLength;
+    int zoneStateSaveCount;
+    uint8_t scheduleConfig[128];
+    size_t scheduleConfigLength;
+    int scheduleConfigSaveCount;
 };
 
 #endif
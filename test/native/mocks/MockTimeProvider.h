@@ -35,6 +35,11 @@ public:
 
     // Test control methods
     void setHour(int hour) { mockTime.tm_hour = hour; }
+    void setTime(int hour, int minute, int second) {
+        mockTime.tm_hour = hour;
+        mockTime.tm_min = minute;
+        mockTime.tm_sec = second;
+    }
     void setTimeAvailable(bool available) { timeAvailable = available; }
     void advanceMillis(unsigned long ms) { currentMillis += ms; }
     void setMillis(unsigned long ms) { currentMillis = ms; }
@@ -0,0 +1,218 @@
+// test/test_async_storage/test_async_storage.cpp
+// Tests for the write-behind storage decorator (triple buffer + worker)
+
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <string.h>
+#include <vector>
+#include "AsyncStateStorage.h"
+#include "ThreadWorkerTask.h"
+#include "native/mocks/MockStateStorage.h"
+
+// Backing storage that takes as long as an NVS page erase and records
+// every state it persisted, in order
+class SlowStorage : public MockStateStorage {
+public:
+    SlowStorage(unsigned long delayMs) : delayMs(delayMs) {}
+
+    bool save(unsigned long lastMistTime, bool hasEverMisted, bool enabled) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+        std::lock_guard<std::mutex> lock(mutex);
+        history.push_back(lastMistTime);
+        return MockStateStorage::save(lastMistTime, hasEverMisted, enabled);
+    }
+
+    std::vector<unsigned long> getHistory() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return history;
+    }
+
+private:
+    unsigned long delayMs;
+    std::mutex mutex;
+    std::vector<unsigned long> history;
+};
+
+void test_save_does_not_touch_backing_storage() {
+    MockStateStorage backing;
+    AsyncStateStorage storage(&backing);
+
+    TEST_ASSERT_TRUE(storage.save(1706000000, true, true));
+    TEST_ASSERT_EQUAL(0, backing.getSaveCallCount());
+
+    TEST_ASSERT_TRUE(storage.persistPending());
+    TEST_ASSERT_EQUAL(1, backing.getSaveCallCount());
+    TEST_ASSERT_EQUAL(1706000000, backing.getLastMistTime());
+    TEST_ASSERT_FALSE(storage.persistPending());  // Nothing new
+}
+
+void test_superseded_snapshots_collapse() {
+    MockStateStorage backing;
+    AsyncStateStorage storage(&backing);
+
+    for (unsigned long i = 1; i <= 5; i++) {
+        storage.save(1706000000 + i, true, (i % 2) == 0);
+    }
+    storage.persistPending();
+
+    TEST_ASSERT_EQUAL(1, backing.getSaveCallCount());
+    TEST_ASSERT_EQUAL(1706000005, backing.getLastMistTime());
+    TEST_ASSERT_FALSE(backing.getEnabled());
+    TEST_ASSERT_EQUAL(5, storage.getAcceptedCount());
+    TEST_ASSERT_EQUAL(1, storage.getWrittenCount());
+    TEST_ASSERT_EQUAL(4, storage.getCollapsedCount());
+}
+
+void test_reads_see_accepted_snapshot() {
+    MockStateStorage backing;
+    backing.setLastMistTime(1705990000);
+    backing.setHasEverMisted(true);
+    AsyncStateStorage storage(&backing);
+
+    // Before any save: straight from the backing storage
+    TEST_ASSERT_EQUAL(1705990000, storage.getLastMistTime());
+
+    // After a save: the accepted value, even though it is not persisted yet
+    storage.save(1706000000, true, false);
+    TEST_ASSERT_EQUAL(1706000000, storage.getLastMistTime());
+    TEST_ASSERT_FALSE(storage.getEnabled());
+    TEST_ASSERT_EQUAL(1705990000, backing.getLastMistTime());
+}
+
+void test_failed_write_is_retried_until_flushed() {
+    MockStateStorage backing;
+    AsyncStateStorage storage(&backing);
+    backing.setSaveFails(true);
+
+    storage.save(1706000000, true, true);
+    TEST_ASSERT_FALSE(storage.flush());
+    TEST_ASSERT_EQUAL(1, storage.getFailedCount());
+
+    backing.setSaveFails(false);
+    TEST_ASSERT_TRUE(storage.flush());
+    TEST_ASSERT_EQUAL(1706000000, backing.getLastMistTime());
+}
+
+void test_worker_keeps_save_off_the_caller() {
+    SlowStorage backing(50);
+    ThreadWorkerTask worker;
+    AsyncStateStorage storage(&backing, &worker);
+    TEST_ASSERT_TRUE(storage.begin());
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    storage.save(1706000000, true, true);
+    long elapsedMs = (long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_TRUE(elapsedMs < 10);
+
+    TEST_ASSERT_TRUE(storage.flush());
+    TEST_ASSERT_EQUAL(1706000000, backing.getLastMistTime());
+}
+
+void test_concurrent_saves_persist_in_order() {
+    SlowStorage backing(1);
+    ThreadWorkerTask worker;
+    AsyncStateStorage storage(&backing, &worker);
+    storage.begin();
+
+    const unsigned long SAVES = 2000;
+    for (unsigned long i = 1; i <= SAVES; i++) {
+        storage.save(i, true, true);
+        if (i % 50 == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+    }
+    TEST_ASSERT_TRUE(storage.flush());
+
+    // Only whole snapshots, strictly moving forward, ending at the last one
+    std::vector<unsigned long> history = backing.getHistory();
+    TEST_ASSERT_TRUE(history.size() >= 1);
+    TEST_ASSERT_TRUE(history.size() < SAVES);
+    for (size_t i = 1; i < history.size(); i++) {
+        TEST_ASSERT_TRUE(history[i] > history[i - 1]);
+    }
+    TEST_ASSERT_EQUAL(SAVES, history.back());
+    TEST_ASSERT_EQUAL(SAVES, storage.getAcceptedCount());
+    TEST_ASSERT_EQUAL(SAVES, storage.getWrittenCount() + storage.getCollapsedCount());
+}
+
+void test_records_are_written_by_the_worker() {
+    SlowStorage backing(50);
+    ThreadWorkerTask worker;
+    AsyncStateStorage storage(&backing, &worker);
+    storage.begin();
+
+    // A state write is in flight when the network cache and config arrive
+    storage.save(1706000000, true, true);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    NetworkCache cache;
+    cache.valid = 1;
+    cache.channel = 6;
+    TEST_ASSERT_TRUE(storage.saveNetworkCache(cache));
+    uint8_t config[120];
+    memset(config, 0xA5, sizeof(config));
+    TEST_ASSERT_TRUE(storage.saveScheduleConfig(config, sizeof(config)));
+    long elapsedMs = (long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_TRUE(elapsedMs < 10);
+
+    // Read-your-writes before they are persisted
+    NetworkCache loaded;
+    TEST_ASSERT_TRUE(storage.loadNetworkCache(&loaded));
+    TEST_ASSERT_EQUAL(6, loaded.channel);
+    uint8_t loadedConfig[120];
+    TEST_ASSERT_TRUE(storage.loadScheduleConfig(loadedConfig, sizeof(loadedConfig)));
+    TEST_ASSERT_EQUAL_MEMORY(config, loadedConfig, sizeof(config));
+    TEST_ASSERT_FALSE(storage.loadScheduleConfig(loadedConfig, 100));  // Wrong record size
+
+    TEST_ASSERT_TRUE(storage.flush());
+    TEST_ASSERT_EQUAL(1, backing.getSaveCallCount());
+    TEST_ASSERT_EQUAL(1, backing.getNetworkCacheSaveCount());
+    TEST_ASSERT_EQUAL(1, backing.getScheduleConfigSaveCount());
+    TEST_ASSERT_EQUAL_MEMORY(config, backing.getScheduleConfigBytes(), sizeof(config));
+    TEST_ASSERT_EQUAL(0, backing.getZoneStateSaveCount());  // Never saved, never written
+}
+
+void test_backing_read_is_refused_while_writes_are_pending() {
+    MockStateStorage backing;
+    backing.setLastMistTime(1705990000);
+    AsyncStateStorage storage(&backing);
+    uint8_t config[120] = { 0 };
+
+    // The config write keeps failing, so the worker still owns the backing
+    backing.setSaveFails(true);
+    storage.saveScheduleConfig(config, sizeof(config));
+    unsigned long lastMistTime = 0;
+    bool hasEverMisted, enabled;
+    TEST_ASSERT_FALSE(storage.load(&lastMistTime, &hasEverMisted, &enabled));
+    TEST_ASSERT_EQUAL(0, backing.getLoadCallCount());
+
+    // Once written, records not saved here come from the backing storage
+    backing.setSaveFails(false);
+    TEST_ASSERT_TRUE(storage.load(&lastMistTime, &hasEverMisted, &enabled));
+    TEST_ASSERT_EQUAL(1705990000, lastMistTime);
+    TEST_ASSERT_EQUAL(1, backing.getScheduleConfigSaveCount());
+
+    uint8_t oversized[AsyncStateStorage::MAX_RECORD_SIZE + 1] = { 0 };
+    TEST_ASSERT_FALSE(storage.saveZoneState(oversized, sizeof(oversized)));
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_save_does_not_touch_backing_storage);
+    RUN_TEST(test_superseded_snapshots_collapse);
+    RUN_TEST(test_reads_see_accepted_snapshot);
+    RUN_TEST(test_failed_write_is_retried_until_flushed);
+    RUN_TEST(test_worker_keeps_save_off_the_caller);
+    RUN_TEST(test_concurrent_saves_persist_in_order);
+    RUN_TEST(test_records_are_written_by_the_worker);
+    RUN_TEST(test_backing_read_is_refused_while_writes_are_pending);
+    return UNITY_END();
+}
@@ -0,0 +1,125 @@
+// test/test_boot_orchestrator/test_boot_orchestrator.cpp
+// Tests for the boot pipeline: state load first, network and time sync in background
+
+#include <unity.h>
+#include "BootOrchestrator.h"
+#include "MistingScheduler.h"
+#include "native/mocks/MockTimeProvider.h"
+#include "native/mocks/MockRelayController.h"
+#include "native/mocks/MockStateStorage.h"
+#include "native/mocks/MockNetworkDriver.h"
+
+void test_state_load_stage_is_measured() {
+    MockTimeProvider timeProvider;
+    MockNetworkDriver driver;
+    BootOrchestrator boot(&timeProvider, &driver);
+
+    boot.beginStage(BOOT_STATE_LOAD, 100);
+    boot.endStage(BOOT_STATE_LOAD, 112);
+
+    TEST_ASSERT_TRUE(boot.isStageDone(BOOT_STATE_LOAD));
+    TEST_ASSERT_EQUAL(12, boot.getStageDuration(BOOT_STATE_LOAD));
+    TEST_ASSERT_FALSE(boot.isReady());
+}
+
+void test_network_then_time_sync_stages() {
+    MockTimeProvider timeProvider;
+    MockNetworkDriver driver;
+    BootOrchestrator boot(&timeProvider, &driver);
+
+    timeProvider.setTimeAvailable(false);
+    driver.setConnected(false);
+    boot.startBackground(200);
+
+    boot.step(1000);
+    TEST_ASSERT_FALSE(boot.isStageDone(BOOT_NETWORK));
+
+    driver.setConnected(true);
+    boot.step(2200);
+    TEST_ASSERT_TRUE(boot.isStageDone(BOOT_NETWORK));
+    TEST_ASSERT_EQUAL(2000, boot.getStageDuration(BOOT_NETWORK));
+    TEST_ASSERT_FALSE(boot.isReady());
+
+    timeProvider.setTimeAvailable(true);
+    boot.step(2700);
+    TEST_ASSERT_TRUE(boot.isReady());
+    TEST_ASSERT_EQUAL(500, boot.getStageDuration(BOOT_TIME_SYNC));
+    TEST_ASSERT_EQUAL(2700, boot.getReadyMillis());
+}
+
+void test_ready_before_network_when_clock_retained() {
+    MockTimeProvider timeProvider;
+    MockNetworkDriver driver;
+    BootOrchestrator boot(&timeProvider, &driver);
+
+    // Soft reset: RTC clock still valid, WiFi not up yet
+    boot.beginStage(BOOT_STATE_LOAD, 0);
+    boot.endStage(BOOT_STATE_LOAD, 40);
+    driver.setConnected(false);
+    boot.startBackground(50);
+    boot.step(60);
+
+    TEST_ASSERT_TRUE(boot.isReady());
+    TEST_ASSERT_FALSE(boot.isStageDone(BOOT_NETWORK));
+    TEST_ASSERT_FALSE(boot.isComplete());
+
+    // Network completes later, stepped the way loop() does it, without
+    // affecting readiness or the time sync measurement
+    driver.setConnected(true);
+    for (unsigned long now = 100; now <= 3000; now += 100) {
+        if (!boot.isComplete()) {
+            boot.step(now);
+        }
+    }
+    TEST_ASSERT_TRUE(boot.isComplete());
+    TEST_ASSERT_TRUE(boot.isStageDone(BOOT_NETWORK));
+    TEST_ASSERT_EQUAL(50, boot.getStageDuration(BOOT_NETWORK));
+    TEST_ASSERT_EQUAL(0, boot.getStageDuration(BOOT_TIME_SYNC));
+    TEST_ASSERT_EQUAL(60, boot.getReadyMillis());
+}
+
+void test_state_loaded_before_sync_prevents_remist() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage storage;
+    MockNetworkDriver driver;
+
+    // Last mist 30 minutes ago, persisted before the reboot
+    storage.setLastMistTime(1706000000 - 1800);
+    storage.setHasEverMisted(true);
+
+    MistingScheduler scheduler(&timeProvider, &relay, &storage);
+    BootOrchestrator boot(&timeProvider, &driver);
+
+    // Boot: state loads unconditionally while time is not yet available
+    timeProvider.setTimeAvailable(false);
+    boot.beginStage(BOOT_STATE_LOAD, 0);
+    scheduler.loadState();
+    boot.endStage(BOOT_STATE_LOAD, 5);
+    boot.startBackground(5);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(WAITING_SYNC, scheduler.getState());
+
+    // Time sync arrives later, inside the active window
+    timeProvider.setTimeAvailable(true);
+    timeProvider.setHour(10);
+    timeProvider.setEpochTime(1706000000);
+    boot.step(4000);
+    scheduler.update();
+
+    TEST_ASSERT_TRUE(boot.isReady());
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getState());
+    TEST_ASSERT_FALSE(relay.getIsOn());
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_state_load_stage_is_measured);
+    RUN_TEST(test_network_then_time_sync_stages);
+    RUN_TEST(test_ready_before_network_when_clock_retained);
+    RUN_TEST(test_state_loaded_before_sync_prevents_remist);
+    return UNITY_END();
+}
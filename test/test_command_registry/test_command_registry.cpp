@@ -0,0 +1,223 @@
+// test/test_command_registry/test_command_registry.cpp
+// Tests for the table-driven command parser and dispatcher
+
+#include <unity.h>
+#include <string.h>
+#include "CommandRegistry.h"
+#include "MistingScheduler.h"
+#include "native/mocks/MockCommandOutput.h"
+#include "native/mocks/MockTimeProvider.h"
+#include "native/mocks/MockRelayController.h"
+
+// Last handler invocation
+static const char* calledName;
+static CommandArgs calledArgs;
+
+static void recordCall(const char* name, const CommandArgs& args) {
+    calledName = name;
+    calledArgs = args;
+}
+
+static void cmdDelay(const CommandArgs& args, ICommandOutput* out, void* context) { recordCall("DELAY", args); }
+static void cmdLed(const CommandArgs& args, ICommandOutput* out, void* context) { recordCall("LED", args); }
+static void cmdMode(const CommandArgs& args, ICommandOutput* out, void* context) { recordCall("MODE", args); }
+static void cmdOffset(const CommandArgs& args, ICommandOutput* out, void* context) { recordCall("OFFSET", args); }
+static void cmdSay(const CommandArgs& args, ICommandOutput* out, void* context) { recordCall("SAY", args); }
+static void cmdStatus(const CommandArgs& args, ICommandOutput* out, void* context) {
+    recordCall("STATUS", args);
+    out->println("STATUS: ok");
+}
+
+static constexpr CommandSpec COMMANDS[] = {
+    { "DELAY",  "uU", 1, 3600,  "seconds [repeat]", "Wait, optionally repeating", cmdDelay },
+    { "LED",    "b",  0, 0,     "on|off",           "Switch the LED",             cmdLed },
+    { "MODE",   "W",  0, 0,     "[name]",           "Show or set the mode",       cmdMode },
+    { "OFFSET", "i",  -60, 60,  "minutes",          "Shift the schedule",         cmdOffset },
+    { "SAY",    "uT", 0, 9,     "level [text]",     "Log a message",              cmdSay },
+    { "STATUS", "",   0, 0,     "",                 "Show status",                cmdStatus },
+};
+static const size_t COMMAND_COUNT = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+
+// Table order is verified by the compiler
+static_assert(commandTableSorted(COMMANDS, COMMAND_COUNT), "test table must be sorted");
+static constexpr CommandSpec UNSORTED[] = {
+    { "STATUS", "", 0, 0, "", "", cmdStatus },
+    { "DELAY",  "", 0, 0, "", "", cmdDelay },
+};
+static_assert(!commandTableSorted(UNSORTED, 2), "unsorted table must be detected");
+
+static CommandResult run(CommandRegistry& registry, const char* text, MockCommandOutput& out) {
+    char line[64];
+    strncpy(line, text, sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+    calledName = nullptr;
+    return registry.execute(line, &out);
+}
+
+void test_lookup_is_case_insensitive_and_trims_whitespace() {
+    CommandRegistry registry(COMMANDS, COMMAND_COUNT);
+    MockCommandOutput out;
+
+    TEST_ASSERT_EQUAL(CMD_OK, run(registry, "  status \t", out));
+    TEST_ASSERT_EQUAL_STRING("STATUS", calledName);
+    TEST_ASSERT_EQUAL_STRING("STATUS: ok", out.getLastLine());
+
+    // Every table entry is found by the binary search, nothing else is
+    for (size_t i = 0; i < COMMAND_COUNT; i++) {
+        TEST_ASSERT_TRUE(registry.find(COMMANDS[i].name) == &COMMANDS[i]);
+    }
+    TEST_ASSERT_NULL(registry.find("AAA"));
+    TEST_ASSERT_NULL(registry.find("MODEX"));
+    TEST_ASSERT_NULL(registry.find("ZZZ"));
+
+    out.reset();
+    TEST_ASSERT_EQUAL(CMD_UNKNOWN, run(registry, "reboot", out));
+    TEST_ASSERT_NULL(calledName);
+    TEST_ASSERT_EQUAL_STRING("ERROR: Unknown command: REBOOT", out.getLastLine());
+
+    out.reset();
+    TEST_ASSERT_EQUAL(CMD_EMPTY, run(registry, "   ", out));
+    TEST_ASSERT_EQUAL(0, out.getLineCount());
+}
+
+void test_typed_arguments_are_parsed() {
+    CommandRegistry registry(COMMANDS, COMMAND_COUNT);
+    MockCommandOutput out;
+
+    TEST_ASSERT_EQUAL(CMD_OK, run(registry, "DELAY 90 3", out));
+    TEST_ASSERT_EQUAL(2, calledArgs.count);
+    TEST_ASSERT_EQUAL(90, calledArgs.values[0]);
+    TEST_ASSERT_EQUAL(3, calledArgs.values[1]);
+
+    // Optional argument left out
+    TEST_ASSERT_EQUAL(CMD_OK, run(registry, "DELAY 90", out));
+    TEST_ASSERT_TRUE(calledArgs.has(0));
+    TEST_ASSERT_FALSE(calledArgs.has(1));
+
+    TEST_ASSERT_EQUAL(CMD_OK, run(registry, "offset -15", out));
+    TEST_ASSERT_EQUAL(-15, calledArgs.values[0]);
+
+    TEST_ASSERT_EQUAL(CMD_OK, run(registry, "led On", out));
+    TEST_ASSERT_EQUAL(1, calledArgs.values[0]);
+    TEST_ASSERT_EQUAL(CMD_OK, run(registry, "led 0", out));
+    TEST_ASSERT_EQUAL(0, calledArgs.values[0]);
+
+    TEST_ASSERT_EQUAL(CMD_OK, run(registry, "mode night", out));
+    TEST_ASSERT_EQUAL_STRING("NIGHT", calledArgs.words[0]);
+    TEST_ASSERT_EQUAL(CMD_OK, run(registry, "mode", out));
+    TEST_ASSERT_EQUAL(0, calledArgs.count);
+}
+
+void test_text_argument_takes_rest_of_line() {
+    CommandRegistry registry(COMMANDS, COMMAND_COUNT);
+    MockCommandOutput out;
+
+    TEST_ASSERT_EQUAL(CMD_OK, run(registry, "say 3  */5 9-17 * * mon-fri ; x y  ", out));
+    TEST_ASSERT_EQUAL(2, calledArgs.count);
+    TEST_ASSERT_EQUAL(3, calledArgs.values[0]);
+    TEST_ASSERT_EQUAL_STRING("*/5 9-17 * * MON-FRI ; X Y", calledArgs.words[1]);
+
+    // Optional, and still counted as one argument when it has many words
+    TEST_ASSERT_EQUAL(CMD_OK, run(registry, "SAY 3", out));
+    TEST_ASSERT_EQUAL(1, calledArgs.count);
+    TEST_ASSERT_EQUAL(CMD_OK, run(registry, "SAY 1 a b c d e f g", out));
+    TEST_ASSERT_EQUAL_STRING("A B C D E F G", calledArgs.words[1]);
+    TEST_ASSERT_EQUAL(CMD_BAD_ARGS, run(registry, "SAY loud words", out));
+}
+
+void test_invalid_arguments_are_rejected_with_usage() {
+    CommandRegistry registry(COMMANDS, COMMAND_COUNT);
+    MockCommandOutput out;
+
+    const char* rejected[] = {
+        "DELAY",            // Missing required argument
+        "DELAY 10 2 7",     // Too many
+        "DELAY ten",        // Not a number
+        "DELAY 10s",        // Trailing junk
+        "DELAY -5",         // Unsigned
+        "LED maybe",        // Not a boolean
+        "STATUS now",       // Takes no arguments
+        "MODE a b c d e f", // More tokens than any command accepts
+    };
+    for (size_t i = 0; i < sizeof(rejected) / sizeof(rejected[0]); i++) {
+        out.reset();
+        TEST_ASSERT_EQUAL_MESSAGE(CMD_BAD_ARGS, run(registry, rejected[i], out), rejected[i]);
+        TEST_ASSERT_TRUE_MESSAGE(calledName == nullptr, rejected[i]);
+        TEST_ASSERT_EQUAL_MESSAGE(0, strncmp(out.getLastLine(), "ERROR: Usage: ", 14), rejected[i]);
+    }
+
+    out.reset();
+    TEST_ASSERT_EQUAL(CMD_OK, run(registry, "DELAY 3600", out));
+    TEST_ASSERT_EQUAL(CMD_BAD_ARGS, run(registry, "DELAY 3601", out));
+    TEST_ASSERT_EQUAL_STRING("ERROR: DELAY: 3601 out of range (1-3600)", out.getLastLine());
+    TEST_ASSERT_EQUAL(CMD_BAD_ARGS, run(registry, "OFFSET -61", out));
+    TEST_ASSERT_EQUAL_STRING("ERROR: OFFSET: -61 out of range (-60-60)", out.getLastLine());
+}
+
+void test_help_lists_commands_with_usage() {
+    CommandRegistry registry(COMMANDS, COMMAND_COUNT);
+    MockCommandOutput out;
+
+    registry.printHelp(&out);
+    TEST_ASSERT_EQUAL(COMMAND_COUNT, out.getLineCount());
+    TEST_ASSERT_EQUAL_STRING("DELAY seconds [repeat] - Wait, optionally repeating", out.getLine(0));
+    TEST_ASSERT_EQUAL_STRING("STATUS - Show status", out.getLine(5));
+
+    out.reset();
+    registry.printHelp(&out, "LED");
+    TEST_ASSERT_EQUAL(1, out.getLineCount());
+    TEST_ASSERT_EQUAL_STRING("LED on|off - Switch the LED", out.getLine(0));
+
+    out.reset();
+    registry.printHelp(&out, "NOPE");
+    TEST_ASSERT_EQUAL_STRING("ERROR: Unknown command: NOPE", out.getLine(0));
+}
+
+// Same parser driving the scheduler, as the serial front end does
+static void cmdForceMist(const CommandArgs& args, ICommandOutput* out, void* context) {
+    MistingScheduler* scheduler = (MistingScheduler*)context;
+    scheduler->forceMist(args.has(0) ? (unsigned long)args.values[0] * 1000 : MistingScheduler::MIST_DURATION);
+    out->println("OK: Force mist command sent");
+}
+
+static constexpr CommandSpec SCHEDULER_COMMANDS[] = {
+    { "FORCE_MIST", "U", 1, 120, "[seconds]", "Mist now", cmdForceMist },
+};
+
+void test_force_mist_with_duration_argument() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MistingScheduler scheduler(&timeProvider, &relay);
+    CommandRegistry registry(SCHEDULER_COMMANDS, 1, &scheduler);
+    MockCommandOutput out;
+
+    timeProvider.setHour(20);
+    scheduler.update();
+
+    TEST_ASSERT_EQUAL(CMD_OK, run(registry, "force_mist 10", out));
+    TEST_ASSERT_EQUAL_STRING("OK: Force mist command sent", out.getLastLine());
+    TEST_ASSERT_TRUE(relay.getIsOn());
+    TEST_ASSERT_EQUAL(10000UL, scheduler.getMistDurationMs());
+
+    timeProvider.advanceMillis(10000);
+    scheduler.update();
+    TEST_ASSERT_FALSE(relay.getIsOn());
+
+    TEST_ASSERT_EQUAL(CMD_OK, run(registry, "FORCE_MIST", out));
+    TEST_ASSERT_EQUAL(MistingScheduler::MIST_DURATION, scheduler.getMistDurationMs());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_lookup_is_case_insensitive_and_trims_whitespace);
+    RUN_TEST(test_typed_arguments_are_parsed);
+    RUN_TEST(test_text_argument_takes_rest_of_line);
+    RUN_TEST(test_invalid_arguments_are_rejected_with_usage);
+    RUN_TEST(test_help_lists_commands_with_usage);
+    RUN_TEST(test_force_mist_with_duration_argument);
+    return UNITY_END();
+}
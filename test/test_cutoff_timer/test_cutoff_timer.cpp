@@ -0,0 +1,142 @@
+// test/test_cutoff_timer/test_cutoff_timer.cpp
+// Tests for the one-shot relay cut-off timer armed by startMisting()
+
+#include <unity.h>
+#include "MistingScheduler.h"
+#include "native/mocks/MockTimeProvider.h"
+#include "native/mocks/MockRelayController.h"
+#include "native/mocks/MockStateStorage.h"
+#include "native/mocks/MockCutoffTimer.h"
+
+// Helper class to capture log messages
+class LogCapture {
+public:
+    static void reset() {
+        lastMessage[0] = '\0';
+    }
+
+    static void captureLog(const char* message) {
+        strncpy(lastMessage, message, sizeof(lastMessage) - 1);
+        lastMessage[sizeof(lastMessage) - 1] = '\0';
+    }
+
+    static const char* getLastMessage() {
+        return lastMessage;
+    }
+
+private:
+    static char lastMessage[256];
+};
+
+char LogCapture::lastMessage[256] = "";
+
+void test_start_misting_arms_timer_for_mist_duration() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockCutoffTimer timer(&relay);
+    MistingScheduler scheduler(&timeProvider, &relay, nullptr, nullptr, &timer);
+
+    timeProvider.setHour(10);
+    scheduler.update();
+
+    TEST_ASSERT_EQUAL(MISTING, scheduler.getState());
+    TEST_ASSERT_TRUE(timer.isArmed());
+    TEST_ASSERT_EQUAL(MistingScheduler::MIST_DURATION, timer.getArmedDurationMs());
+}
+
+void test_timer_cuts_relay_without_update() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockCutoffTimer timer(&relay);
+    MistingScheduler scheduler(&timeProvider, &relay, nullptr, nullptr, &timer);
+
+    timeProvider.setHour(10);
+    scheduler.update();
+    TEST_ASSERT_TRUE(relay.getIsOn());
+
+    // Loop is blocked; the timer expires on its own
+    timer.fire();
+
+    TEST_ASSERT_FALSE(relay.getIsOn());
+    TEST_ASSERT_EQUAL(MISTING, scheduler.getState());  // Bookkeeping not done yet
+}
+
+void test_update_after_cutoff_completes_bookkeeping() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage storage;
+    MockCutoffTimer timer(&relay);
+    MistingScheduler scheduler(&timeProvider, &relay, &storage, nullptr, &timer);
+
+    timeProvider.setHour(10);
+    timeProvider.setEpochTime(1706000000);
+    scheduler.update();
+    storage.resetSaveCallCount();
+
+    // Loop was blocked for 10 seconds past the deadline
+    timer.fire();
+    timeProvider.advanceMillis(35000);
+    scheduler.update();
+
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getState());
+    TEST_ASSERT_EQUAL(1, storage.getSaveCallCount());
+    TEST_ASSERT_EQUAL(1706000000, storage.getLastMistTime());
+}
+
+void test_loop_stop_cancels_timer() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockCutoffTimer timer(&relay);
+    MistingScheduler scheduler(&timeProvider, &relay, nullptr, nullptr, &timer);
+
+    timeProvider.setHour(10);
+    scheduler.update();
+
+    // Loop reaches the deadline first
+    timeProvider.advanceMillis(MistingScheduler::MIST_DURATION);
+    scheduler.update();
+
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getState());
+    TEST_ASSERT_FALSE(timer.isArmed());
+    TEST_ASSERT_EQUAL(1, timer.getCancelCount());
+}
+
+void test_failsafe_reached_when_timer_never_fires() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage storage;
+    MockCutoffTimer timer(&relay);
+
+    LogCapture::reset();
+    MistingScheduler scheduler(&timeProvider, &relay, &storage, LogCapture::captureLog, &timer);
+
+    timeProvider.setHour(10);
+    scheduler.update();
+    storage.resetSaveCallCount();
+
+    // Timer failed and the loop only comes back after 3x the mist duration
+    timeProvider.advanceMillis(MistingScheduler::MIST_DURATION * 3);
+    scheduler.update();
+
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getState());
+    TEST_ASSERT_FALSE(relay.getIsOn());
+    TEST_ASSERT_EQUAL_STRING("CRITICAL: Mist duration exceeded safety limit, forcing stop",
+                             LogCapture::getLastMessage());
+    TEST_ASSERT_EQUAL(0, storage.getSaveCallCount());
+}
+
+void setUp(void) {
+    LogCapture::reset();
+}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_start_misting_arms_timer_for_mist_duration);
+    RUN_TEST(test_timer_cuts_relay_without_update);
+    RUN_TEST(test_update_after_cutoff_completes_bookkeeping);
+    RUN_TEST(test_loop_stop_cancels_timer);
+    RUN_TEST(test_failsafe_reached_when_timer_never_fires);
+    return UNITY_END();
+}
@@ -137,6 +137,28 @@ void test_forceMist_updates_lastMistEpoch() {
     TEST_ASSERT_TRUE(storage.getHasEverMisted());
 }
 
+void test_forceMist_custom_duration() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MistingScheduler scheduler(&timeProvider, &relay);
+
+    timeProvider.setHour(20);
+    scheduler.update();
+
+    scheduler.forceMist(10000);
+    TEST_ASSERT_EQUAL(10000UL, scheduler.getMistDurationMs());
+    TEST_ASSERT_EQUAL(timeProvider.getMillis() + 10000UL, scheduler.getNextEventMillis());
+
+    timeProvider.advanceMillis(9999);
+    scheduler.update();
+    TEST_ASSERT_TRUE(relay.getIsOn());
+
+    timeProvider.advanceMillis(1);
+    scheduler.update();
+    TEST_ASSERT_FALSE(relay.getIsOn());
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getState());
+}
+
 void setUp(void) {
     LogCapture::reset();
 }
@@ -149,5 +171,6 @@ int main(int argc, char **argv) {
     RUN_TEST(test_forceMist_blocked_when_already_misting);
     RUN_TEST(test_forceMist_blocked_when_scheduler_disabled);
     RUN_TEST(test_forceMist_updates_lastMistEpoch);
+    RUN_TEST(test_forceMist_custom_duration);
     return UNITY_END();
 }
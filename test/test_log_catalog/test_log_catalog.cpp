@@ -0,0 +1,215 @@
+// test/test_log_catalog/test_log_catalog.cpp
+// Tests for catalog log events, their text formatting and the binary encoding
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "LogEvent.h"
+#include "BinaryLogEncoder.h"
+#include "Crc32.h"
+#include "MistingScheduler.h"
+#include "native/mocks/MockTimeProvider.h"
+#include "native/mocks/MockRelayController.h"
+
+static const time_t EPOCH = 1706000000;  // 2024-01-23
+
+static std::vector<LogEvent> capturedEvents;
+static char lastText[128];
+
+static void captureEvent(const LogEvent& event) {
+    capturedEvents.push_back(event);
+}
+
+static void captureText(const char* message) {
+    strncpy(lastText, message, sizeof(lastText) - 1);
+    lastText[sizeof(lastText) - 1] = '\0';
+}
+
+static LogEvent makeEvent(uint8_t id, int32_t arg0 = 0, int32_t arg1 = 0, int32_t arg2 = 0, int32_t arg3 = 0) {
+    LogEvent event;
+    event.id = id;
+    event.args[0] = arg0;
+    event.args[1] = arg1;
+    event.args[2] = arg2;
+    event.args[3] = arg3;
+    return event;
+}
+
+static LogEntry makeEntry(const LogEvent& event, unsigned long millis, time_t epoch) {
+    LogEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.millis = millis;
+    entry.epoch = epoch;
+    entry.event = event;
+    return entry;
+}
+
+void test_events_format_as_the_original_lines() {
+    char text[128];
+
+    formatLogEvent(makeEvent(LOG_MSG_TIME_JUMP, -3600), text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("WARNING: Time jump detected: -3600 seconds", text);
+
+    formatLogEvent(makeEvent(LOG_MSG_STATUS_STATE, LOG_STR_IDLE, LOG_STR_TRUE, LOG_STR_FALSE), text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("STATUS: state=IDLE enabled=true hasEverMisted=false", text);
+
+    formatLogEvent(makeEvent(LOG_MSG_STATUS_SAVES, 7, 2, LOG_STR_PENDING), text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("STATUS: saves requested=7 written=2 (pending)", text);
+
+    formatLogEvent(makeEvent(LOG_MSG_JOURNAL_HEAD, 3, 17, 4000000000u, 12), text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("JOURNAL: Head at sector 3 slot 17, next seq 4000000000 (12 reads)", text);
+
+    // Truncated, still terminated
+    size_t length = formatLogEvent(makeEvent(LOG_MSG_MIST_START), text, 5);
+    TEST_ASSERT_EQUAL(4, length);
+    TEST_ASSERT_EQUAL_STRING("MIST", text);
+}
+
+void test_catalog_formats_match_argument_types() {
+    // Every conversion must line up with its declared type: the device
+    // formatter and the host decoder both rely on it
+    for (uint8_t id = 0; id < LOG_MSG_COUNT; id++) {
+        const char* types = logArgTypes(id);
+        const char* format = logFormat(id);
+        size_t arg = 0;
+        for (const char* p = format; *p; p++) {
+            if (*p != '%') {
+                continue;
+            }
+            p++;
+            if (*p == '%') {
+                continue;
+            }
+            char expected = types[arg++];
+            if (p[0] == 'l' && p[1] == 'd') {
+                TEST_ASSERT_EQUAL_MESSAGE('i', expected, format);
+            } else if (p[0] == 'l' && p[1] == 'u') {
+                TEST_ASSERT_EQUAL_MESSAGE('u', expected, format);
+            } else if (p[0] == 's') {
+                TEST_ASSERT_TRUE_MESSAGE(expected == 's' || expected == 't', format);
+            } else {
+                TEST_FAIL_MESSAGE(format);
+            }
+        }
+        TEST_ASSERT_EQUAL_MESSAGE(strlen(types), arg, format);
+        TEST_ASSERT_TRUE(strlen(types) <= LOG_EVENT_MAX_ARGS);
+    }
+}
+
+void test_event_logger_receives_unformatted_events() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MistingScheduler scheduler(&timeProvider, &relay, nullptr, captureText);
+    capturedEvents.clear();
+    lastText[0] = '\0';
+
+    // Text logger only: formatted as before
+    scheduler.forceMist();
+    TEST_ASSERT_EQUAL_STRING("MIST START", lastText);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(0, capturedEvents.size());
+
+    // Event logger installed: ID and raw arguments, no text
+    scheduler.setEventLogger(captureEvent);
+    lastText[0] = '\0';
+    timeProvider.setEpochTime(timeProvider.getEpochTime() + 7200);
+    scheduler.update();
+    TEST_ASSERT_EQUAL_STRING("", lastText);
+    TEST_ASSERT_EQUAL(1, capturedEvents.size());
+    TEST_ASSERT_EQUAL(LOG_MSG_TIME_JUMP, capturedEvents[0].id);
+    TEST_ASSERT_EQUAL(7200, capturedEvents[0].args[0]);
+}
+
+void test_time_base_sent_once_then_on_clock_jump() {
+    BinaryLogEncoder encoder;
+    uint8_t buffer[BinaryLogEncoder::MAX_OUTPUT];
+
+    // No wall clock yet: record only
+    size_t length = encoder.encode(makeEntry(makeEvent(LOG_MSG_MIST_START), 500, 0), buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(LOG_MSG_MIST_START, buffer[1]);
+    TEST_ASSERT_EQUAL(5, length);  // SYNC, id, varint(500), check
+
+    // Clock set: TIME_BASE precedes the record
+    length = encoder.encode(makeEntry(makeEvent(LOG_MSG_MIST_STOP), 25500, EPOCH), buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_UINT8(BinaryLogEncoder::SYNC, buffer[0]);
+    TEST_ASSERT_EQUAL(LOG_MSG_TIME_BASE, buffer[1]);
+    TEST_ASSERT_TRUE(length > 10);
+
+    // Clock consistent with millis: no new base
+    length = encoder.encode(makeEntry(makeEvent(LOG_MSG_MIST_START), 7225500, EPOCH + 7200), buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(LOG_MSG_MIST_START, buffer[1]);
+    TEST_ASSERT_EQUAL(7, length);  // Two hours of millis fit a 4-byte varint
+
+    // NTP step: new base
+    length = encoder.encode(makeEntry(makeEvent(LOG_MSG_MIST_STOP), 7250500, EPOCH + 9000), buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(LOG_MSG_TIME_BASE, buffer[1]);
+}
+
+void test_record_layout_and_check_byte() {
+    BinaryLogEncoder encoder;
+    uint8_t buffer[BinaryLogEncoder::MAX_OUTPUT];
+
+    size_t length = encoder.encode(makeEntry(makeEvent(LOG_MSG_TIME_JUMP, -2), 1, 0), buffer, sizeof(buffer));
+    uint8_t expected[] = { BinaryLogEncoder::SYNC, LOG_MSG_TIME_JUMP, 0x01, 0x03, 0x00 };
+    expected[4] = (uint8_t)crc32(expected + 1, 3);  // Zigzag: -2 -> 3
+    TEST_ASSERT_EQUAL(sizeof(expected), length);
+    TEST_ASSERT_EQUAL_MEMORY(expected, buffer, sizeof(expected));
+
+    // Plain text travels as a length-prefixed TEXT record
+    LogEntry entry = makeEntry(makeEvent(LOG_MSG_TEXT), 1, 0);
+    strcpy(entry.text, "hello");
+    length = encoder.encode(entry, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(LOG_MSG_TEXT, buffer[1]);
+    TEST_ASSERT_EQUAL(0, buffer[2]);  // Same millis as the previous record
+    TEST_ASSERT_EQUAL(5, buffer[3]);
+    TEST_ASSERT_EQUAL_MEMORY("hello", buffer + 4, 5);
+    TEST_ASSERT_EQUAL(10, length);
+
+    // Too small a buffer is refused rather than overrun
+    TEST_ASSERT_EQUAL(0, encoder.encode(entry, buffer, BinaryLogEncoder::MAX_OUTPUT - 1));
+}
+
+void test_binary_records_are_much_smaller_than_text() {
+    BinaryLogEncoder encoder;
+    uint8_t buffer[BinaryLogEncoder::MAX_OUTPUT];
+    char text[128];
+    char line[160];
+
+    // Steady state: clock already sent, events a minute apart
+    encoder.encode(makeEntry(makeEvent(LOG_MSG_MIST_START), 1000, EPOCH), buffer, sizeof(buffer));
+
+    const LogEvent events[] = {
+        makeEvent(LOG_MSG_MIST_STOP),
+        makeEvent(LOG_MSG_TIME_JUMP, 3600),
+        makeEvent(LOG_MSG_STATUS_STATE, LOG_STR_IDLE, LOG_STR_TRUE, LOG_STR_TRUE),
+        makeEvent(LOG_MSG_WIFI_CONNECTED, 850, LOG_STR_CACHED_BSSID),
+    };
+    size_t binaryBytes = 0;
+    size_t textBytes = 0;
+    unsigned long millis = 1000;
+    for (size_t i = 0; i < sizeof(events) / sizeof(events[0]); i++) {
+        millis += 60000;
+        binaryBytes += encoder.encode(makeEntry(events[i], millis, EPOCH + (millis - 1000) / 1000),
+                                      buffer, sizeof(buffer));
+        formatLogEvent(events[i], text, sizeof(text));
+        textBytes += snprintf(line, sizeof(line), "2024-01-23 09:53:20 | %s\n", text);
+    }
+
+    TEST_ASSERT_TRUE(binaryBytes * 5 <= textBytes);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_events_format_as_the_original_lines);
+    RUN_TEST(test_catalog_formats_match_argument_types);
+    RUN_TEST(test_event_logger_receives_unformatted_events);
+    RUN_TEST(test_time_base_sent_once_then_on_clock_jump);
+    RUN_TEST(test_record_layout_and_check_byte);
+    RUN_TEST(test_binary_records_are_much_smaller_than_text);
+    return UNITY_END();
+}
@@ -0,0 +1,179 @@
+// test/test_log_ring/test_log_ring.cpp
+// Tests for the lock-free log queue drained by the main loop
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "LogRing.h"
+
+void test_entries_come_out_in_order_with_timestamps() {
+    LogRing ring;
+    TEST_ASSERT_TRUE(ring.isEmpty());
+
+    TEST_ASSERT_TRUE(ring.push("first", 100, 1706000000));
+    TEST_ASSERT_TRUE(ring.push("second", 250, 0));
+    TEST_ASSERT_EQUAL(2, ring.getDepth());
+
+    LogEntry entry;
+    TEST_ASSERT_TRUE(ring.peek(&entry));
+    TEST_ASSERT_EQUAL_STRING("first", entry.text);
+    TEST_ASSERT_EQUAL(100UL, entry.millis);
+    TEST_ASSERT_EQUAL(1706000000, (long)entry.epoch);
+
+    // Peek does not consume: the UART may not have room yet
+    TEST_ASSERT_TRUE(ring.peek(&entry));
+    TEST_ASSERT_EQUAL_STRING("first", entry.text);
+    ring.pop();
+
+    TEST_ASSERT_TRUE(ring.peek(&entry));
+    TEST_ASSERT_EQUAL_STRING("second", entry.text);
+    TEST_ASSERT_EQUAL(250UL, entry.millis);
+    TEST_ASSERT_EQUAL(0, (long)entry.epoch);
+    ring.pop();
+
+    TEST_ASSERT_FALSE(ring.peek(&entry));
+    TEST_ASSERT_TRUE(ring.isEmpty());
+}
+
+void test_full_ring_drops_without_blocking() {
+    LogRing ring;
+    char message[16];
+    for (size_t i = 0; i < LogRing::CAPACITY; i++) {
+        snprintf(message, sizeof(message), "msg %u", (unsigned)i);
+        TEST_ASSERT_TRUE(ring.push(message, i, 0));
+    }
+
+    TEST_ASSERT_FALSE(ring.push("overflow", 999, 0));
+    TEST_ASSERT_FALSE(ring.push("overflow", 999, 0));
+    TEST_ASSERT_EQUAL(LogRing::CAPACITY, ring.getPushedCount());
+    TEST_ASSERT_EQUAL(2, ring.getDroppedCount());
+
+    // The oldest messages survive; the dropped ones never appear
+    LogEntry entry;
+    TEST_ASSERT_TRUE(ring.peek(&entry));
+    TEST_ASSERT_EQUAL_STRING("msg 0", entry.text);
+    ring.pop();
+
+    // One slot freed: logging resumes
+    TEST_ASSERT_TRUE(ring.push("after", 1000, 0));
+}
+
+void test_long_message_is_truncated() {
+    LogRing ring;
+    char message[LogEntry::MESSAGE_MAX * 2];
+    memset(message, 'x', sizeof(message) - 1);
+    message[sizeof(message) - 1] = '\0';
+
+    TEST_ASSERT_TRUE(ring.push(message, 0, 0));
+
+    LogEntry entry;
+    TEST_ASSERT_TRUE(ring.peek(&entry));
+    TEST_ASSERT_EQUAL(LogEntry::MESSAGE_MAX - 1, strlen(entry.text));
+}
+
+void test_max_depth_tracks_high_water_mark() {
+    LogRing ring;
+    LogEntry entry;
+    for (int i = 0; i < 5; i++) {
+        ring.push("burst", i, 0);
+    }
+    while (ring.peek(&entry)) {
+        ring.pop();
+    }
+    ring.push("single", 10, 0);
+
+    TEST_ASSERT_EQUAL(1, ring.getDepth());
+    TEST_ASSERT_EQUAL(5, ring.getMaxDepth());
+}
+
+void test_slots_are_reused_across_many_laps() {
+    LogRing ring;
+    LogEntry entry;
+    char message[16];
+    for (unsigned i = 0; i < LogRing::CAPACITY * 10; i++) {
+        snprintf(message, sizeof(message), "%u", i);
+        TEST_ASSERT_TRUE(ring.push(message, i, 0));
+        TEST_ASSERT_TRUE(ring.peek(&entry));
+        TEST_ASSERT_EQUAL_STRING(message, entry.text);
+        ring.pop();
+    }
+    TEST_ASSERT_EQUAL(0, ring.getDroppedCount());
+    TEST_ASSERT_EQUAL(1, ring.getMaxDepth());
+}
+
+void test_concurrent_producers_keep_per_task_order() {
+    const int PRODUCERS = 4;
+    const int PER_PRODUCER = 2000;
+    LogRing ring;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.push_back(std::thread([&ring, p]() {
+            char message[32];
+            for (int i = 0; i < PER_PRODUCER; i++) {
+                snprintf(message, sizeof(message), "%d %d", p, i);
+                ring.push(message, i, p);
+            }
+        }));
+    }
+
+    // Consumer runs alongside the producers, like loop() draining the UART
+    int lastSeen[PRODUCERS];
+    for (int p = 0; p < PRODUCERS; p++) {
+        lastSeen[p] = -1;
+    }
+    unsigned long received = 0;
+    bool ordered = true;
+    bool consistent = true;
+    bool producersDone = false;
+    while (true) {
+        LogEntry entry;
+        if (ring.peek(&entry)) {
+            int p, i;
+            if (sscanf(entry.text, "%d %d", &p, &i) != 2 || p < 0 || p >= PRODUCERS) {
+                consistent = false;
+                break;
+            }
+            // Text and timestamps of one entry must come from the same push
+            if ((int)entry.millis != i || (int)entry.epoch != p) {
+                consistent = false;
+            }
+            if (i <= lastSeen[p]) {
+                ordered = false;
+            }
+            lastSeen[p] = i;
+            received++;
+            ring.pop();
+        } else if (producersDone) {
+            break;
+        } else {
+            producersDone = true;
+            for (size_t t = 0; t < producers.size(); t++) {
+                producers[t].join();
+            }
+        }
+    }
+
+    TEST_ASSERT_TRUE(consistent);
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL(ring.getPushedCount(), received);
+    TEST_ASSERT_EQUAL((unsigned long)PRODUCERS * PER_PRODUCER,
+                      (unsigned long)(ring.getPushedCount() + ring.getDroppedCount()));
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_entries_come_out_in_order_with_timestamps);
+    RUN_TEST(test_full_ring_drops_without_blocking);
+    RUN_TEST(test_long_message_is_truncated);
+    RUN_TEST(test_max_depth_tracks_high_water_mark);
+    RUN_TEST(test_slots_are_reused_across_many_laps);
+    RUN_TEST(test_concurrent_producers_keep_per_task_order);
+    return UNITY_END();
+}
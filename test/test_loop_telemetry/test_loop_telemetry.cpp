@@ -0,0 +1,176 @@
+// test/test_loop_telemetry/test_loop_telemetry.cpp
+// Tests for loop period / update() histograms and watchdog-margin telemetry
+
+#include <unity.h>
+#include <string.h>
+#include "LoopTelemetry.h"
+#include "native/mocks/MockCommandOutput.h"
+
+// One loop() pass: feed, then each subsystem (the wait last) taking the given microseconds
+static uint32_t runIteration(LoopTelemetry& telemetry, uint32_t nowUs, const uint32_t stepUs[LOOP_SUBSYSTEM_COUNT]) {
+    telemetry.watchdogFed(nowUs);
+    telemetry.beginIteration(nowUs);
+    for (int s = 0; s < LOOP_SUBSYSTEM_COUNT; s++) {
+        nowUs += stepUs[s];
+        telemetry.mark((LoopSubsystem)s, nowUs);
+    }
+    return nowUs;
+}
+
+void test_histogram_buckets_are_powers_of_two() {
+    TEST_ASSERT_EQUAL(0, LogHistogram::bucketFor(0));
+    TEST_ASSERT_EQUAL(1, LogHistogram::bucketFor(1));
+    TEST_ASSERT_EQUAL(2, LogHistogram::bucketFor(2));
+    TEST_ASSERT_EQUAL(2, LogHistogram::bucketFor(3));
+    TEST_ASSERT_EQUAL(11, LogHistogram::bucketFor(1024));
+    TEST_ASSERT_EQUAL(24, LogHistogram::bucketFor(10000000));  // 10 s
+    TEST_ASSERT_EQUAL(LogHistogram::BUCKETS - 1, LogHistogram::bucketFor(0xFFFFFFFF));
+
+    TEST_ASSERT_EQUAL(0, LogHistogram::bucketLowUs(0));
+    TEST_ASSERT_EQUAL(1024, LogHistogram::bucketLowUs(11));
+    TEST_ASSERT_EQUAL(16777216, LogHistogram::bucketLowUs(LogHistogram::BUCKETS - 1));
+}
+
+void test_histogram_percentile_bounds() {
+    LogHistogram histogram;
+    TEST_ASSERT_EQUAL(0, histogram.getPercentileBoundUs(50));
+
+    // 99 passes around 100 ms, one 3 s stall
+    for (int i = 0; i < 99; i++) {
+        histogram.record(100000 + i);
+    }
+    histogram.record(3000000);
+
+    TEST_ASSERT_EQUAL(100, histogram.getCount());
+    TEST_ASSERT_EQUAL(3000000, histogram.getMaxUs());
+    TEST_ASSERT_EQUAL(131071, histogram.getPercentileBoundUs(50));  // Top of [65536, 131072)
+    TEST_ASSERT_EQUAL(131071, histogram.getPercentileBoundUs(99));
+    TEST_ASSERT_EQUAL(3000000, histogram.getPercentileBoundUs(100));  // Capped at the maximum
+
+    char buckets[64];
+    histogram.format(buckets, sizeof(buckets));
+    TEST_ASSERT_EQUAL_STRING("65536:99 2097152:1", buckets);
+
+    // Pairs that do not fit are left out whole
+    histogram.format(buckets, 12);
+    TEST_ASSERT_EQUAL_STRING("65536:99", buckets);
+
+    histogram.reset();
+    TEST_ASSERT_EQUAL(0, histogram.getCount());
+    histogram.format(buckets, sizeof(buckets));
+    TEST_ASSERT_EQUAL_STRING("", buckets);
+}
+
+void test_loop_period_and_update_duration() {
+    LoopTelemetry telemetry;
+    const uint32_t steps[LOOP_SUBSYSTEM_COUNT] = { 20, 0, 5, 12, 40, 99923 };  // Sleep until the next pass
+
+    uint32_t now = 1000;
+    for (int i = 0; i < 10; i++) {
+        now = runIteration(telemetry, now, steps);
+    }
+
+    // Ten starts, nine periods; work excludes the sleep
+    TEST_ASSERT_EQUAL(9, telemetry.getPeriod().getCount());
+    TEST_ASSERT_EQUAL(100000, telemetry.getPeriod().getMaxUs());
+    TEST_ASSERT_EQUAL(10, telemetry.getWork().getCount());
+    TEST_ASSERT_EQUAL(77, telemetry.getWork().getMaxUs());
+    TEST_ASSERT_EQUAL(10, telemetry.getUpdateDuration().getCount());
+    TEST_ASSERT_EQUAL(12, telemetry.getUpdateDuration().getMaxUs());
+    TEST_ASSERT_EQUAL(40, telemetry.getSubsystemMaxUs(LOOP_LOG));
+    TEST_ASSERT_EQUAL(99923, telemetry.getSubsystemMaxUs(LOOP_IDLE));
+    TEST_ASSERT_EQUAL(LOOP_LOG, telemetry.getWorstSubsystem());  // The wait is not a working step
+}
+
+void test_watchdog_gap_names_the_slow_step() {
+    LoopTelemetry telemetry;
+    const uint32_t normal[LOOP_SUBSYSTEM_COUNT] = { 20, 0, 5, 12, 40, 100000 };
+    const uint32_t slowWiFi[LOOP_SUBSYSTEM_COUNT] = { 7500000, 0, 5, 12, 40, 10 };
+    const uint32_t longSleep[LOOP_SUBSYSTEM_COUNT] = { 20, 0, 5, 12, 40, 5000000 };
+
+    uint32_t now = 0xFFFF0000;  // micros() wraps during the run
+    now = runIteration(telemetry, now, normal);
+    now = runIteration(telemetry, now, slowWiFi);
+    now = runIteration(telemetry, now, longSleep);
+    runIteration(telemetry, now, normal);
+
+    // The 7.5 s reconnect is the longest gap, longer than the 5 s sleep
+    TEST_ASSERT_EQUAL(7500067, telemetry.getMaxWatchdogGapUs());
+    TEST_ASSERT_EQUAL(LOOP_WIFI, telemetry.getWorstGapSubsystem());
+    TEST_ASSERT_EQUAL(LOOP_WIFI, telemetry.getWorstSubsystem());
+    TEST_ASSERT_EQUAL(7500000, telemetry.getSubsystemMaxUs(LOOP_WIFI));
+
+    // Reset clears the statistics; the next gap is measured from the last feed
+    telemetry.reset();
+    TEST_ASSERT_EQUAL(0, telemetry.getMaxWatchdogGapUs());
+    TEST_ASSERT_EQUAL(0, telemetry.getPeriod().getCount());
+    telemetry.watchdogFed(now + 2000);
+    TEST_ASSERT_EQUAL(2000, telemetry.getMaxWatchdogGapUs());
+}
+
+void test_sleep_dominated_gap_is_charged_to_idle() {
+    LoopTelemetry telemetry;
+    const uint32_t tickless[LOOP_SUBSYSTEM_COUNT] = { 20, 0, 5, 12, 40, 4999923 };
+
+    uint32_t now = 0;
+    for (int i = 0; i < 3; i++) {
+        now = runIteration(telemetry, now, tickless);
+    }
+    telemetry.watchdogFed(now);
+
+    // The gap is the sleep until the next event, not a slow step
+    TEST_ASSERT_EQUAL(5000000, telemetry.getMaxWatchdogGapUs());
+    TEST_ASSERT_EQUAL(LOOP_IDLE, telemetry.getWorstGapSubsystem());
+    TEST_ASSERT_EQUAL(77, telemetry.getWork().getMaxUs());
+    TEST_ASSERT_EQUAL(LOOP_LOG, telemetry.getWorstSubsystem());
+}
+
+void test_feed_inside_a_long_command_blames_the_command() {
+    LoopTelemetry telemetry;
+
+    telemetry.watchdogFed(0);
+    telemetry.beginIteration(0);
+    telemetry.mark(LOOP_WIFI, 30);
+    telemetry.mark(LOOP_BOOT, 30);
+    telemetry.watchdogFed(900000);  // BENCH feeding between its operations
+
+    TEST_ASSERT_EQUAL(900000, telemetry.getMaxWatchdogGapUs());
+    TEST_ASSERT_EQUAL(LOOP_COMMANDS, telemetry.getWorstGapSubsystem());
+}
+
+void test_print_report() {
+    LoopTelemetry telemetry;
+    MockCommandOutput out;
+    const uint32_t steps[LOOP_SUBSYSTEM_COUNT] = { 20, 0, 3000, 12, 40, 100000 };
+
+    uint32_t now = 0;
+    for (int i = 0; i < 3; i++) {
+        now = runIteration(telemetry, now, steps);
+    }
+    telemetry.print(&out, 10000);
+
+    TEST_ASSERT_EQUAL(8, out.getLineCount());
+    TEST_ASSERT_EQUAL_STRING("STATS: loop n=2 p50<=103072us p99<=103072us max=103072us", out.getLine(0));
+    TEST_ASSERT_EQUAL_STRING("STATS: loop_hist 65536:2", out.getLine(1));
+    TEST_ASSERT_EQUAL_STRING("STATS: work n=3 p50<=3072us p99<=3072us max=3072us", out.getLine(2));
+    TEST_ASSERT_EQUAL_STRING("STATS: work_hist 2048:3", out.getLine(3));
+    TEST_ASSERT_EQUAL_STRING("STATS: update n=3 p50<=12us p99<=12us max=12us", out.getLine(4));
+    TEST_ASSERT_EQUAL_STRING("STATS: update_hist 8:3", out.getLine(5));
+    TEST_ASSERT_EQUAL_STRING("STATS: watchdog maxGap=103ms timeout=10000ms margin=9897ms slowestStep=idle",
+                             out.getLine(6));
+    TEST_ASSERT_EQUAL_STRING(
+        "STATS: worst=commands maxUs=3000 wifi=20 boot=0 commands=3000 scheduler=12 log=40 idle=100000",
+        out.getLine(7));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_histogram_buckets_are_powers_of_two);
+    RUN_TEST(test_histogram_percentile_bounds);
+    RUN_TEST(test_loop_period_and_update_duration);
+    RUN_TEST(test_watchdog_gap_names_the_slow_step);
+    RUN_TEST(test_sleep_dominated_gap_is_charged_to_idle);
+    RUN_TEST(test_feed_inside_a_long_command_blames_the_command);
+    RUN_TEST(test_print_report);
+    return UNITY_END();
+}
@@ -0,0 +1,195 @@
+// test/test_mist_journal/test_mist_journal.cpp
+// Tests for the wear-leveled mist event journal on a RAM flash image
+
+#include <unity.h>
+#include "MistJournal.h"
+#include "MistingScheduler.h"
+#include "native/mocks/MockFlashRegion.h"
+#include "native/mocks/MockTimeProvider.h"
+#include "native/mocks/MockRelayController.h"
+#include "native/mocks/MockCutoffTimer.h"
+
+// 4 sectors x 5 slots keeps wrap-around cheap to exercise
+static const size_t SECTORS = 4;
+static const size_t SECTOR_SIZE = 5 * sizeof(MistRecord);
+
+void test_append_and_read_newest_first() {
+    MockFlashRegion flash(SECTORS, SECTOR_SIZE);
+    MistJournal journal(&flash);
+    TEST_ASSERT_TRUE(journal.begin());
+    TEST_ASSERT_EQUAL(20, journal.getCapacity());
+
+    TEST_ASSERT_TRUE(journal.recordMist(1706000000, 25000, MIST_TRIGGER_SCHEDULE, MIST_OUTCOME_COMPLETED));
+    TEST_ASSERT_TRUE(journal.recordMist(1706007200, 24990, MIST_TRIGGER_FORCE, MIST_OUTCOME_FAILSAFE));
+
+    MistRecord records[4];
+    TEST_ASSERT_EQUAL(2, journal.readRecent(records, 4));
+    TEST_ASSERT_EQUAL(2, records[0].sequence);
+    TEST_ASSERT_EQUAL(1706007200, records[0].startEpoch);
+    TEST_ASSERT_EQUAL(24990, records[0].durationMs);
+    TEST_ASSERT_EQUAL(MIST_TRIGGER_FORCE, records[0].trigger);
+    TEST_ASSERT_EQUAL(MIST_OUTCOME_FAILSAFE, records[0].outcome);
+    TEST_ASSERT_EQUAL(1, records[1].sequence);
+    TEST_ASSERT_EQUAL(MIST_TRIGGER_SCHEDULE, records[1].trigger);
+}
+
+void test_wraps_round_robin_with_even_wear() {
+    MockFlashRegion flash(SECTORS, SECTOR_SIZE);
+    MistJournal journal(&flash);
+    journal.begin();
+
+    for (uint32_t i = 1; i <= 100; i++) {
+        TEST_ASSERT_TRUE(journal.recordMist(i, 25000, MIST_TRIGGER_SCHEDULE, MIST_OUTCOME_COMPLETED));
+    }
+
+    // 100 records / 5 per sector = 20 sector fills spread over 4 sectors
+    for (size_t s = 0; s < SECTORS; s++) {
+        TEST_ASSERT_EQUAL(5, flash.getEraseCount(s));
+    }
+
+    // Oldest history is overwritten; the newest full sector set survives
+    MistRecord records[32];
+    size_t count = journal.readRecent(records, 32);
+    TEST_ASSERT_EQUAL(20, count);
+    TEST_ASSERT_EQUAL(100, records[0].startEpoch);
+    TEST_ASSERT_EQUAL(81, records[19].startEpoch);
+}
+
+void test_recovery_finds_head_at_every_fill_level() {
+    MockFlashRegion flash(SECTORS, SECTOR_SIZE);
+    MistJournal writer(&flash);
+    writer.begin();
+
+    for (uint32_t i = 1; i <= 60; i++) {
+        writer.recordMist(i, 25000, MIST_TRIGGER_SCHEDULE, MIST_OUTCOME_COMPLETED);
+
+        // Reboot: a fresh instance must continue exactly where the writer is
+        MistJournal rebooted(&flash);
+        TEST_ASSERT_TRUE(rebooted.begin());
+        TEST_ASSERT_EQUAL(i + 1, rebooted.getNextSequence());
+
+        MistRecord newest;
+        TEST_ASSERT_EQUAL(1, rebooted.readRecent(&newest, 1));
+        TEST_ASSERT_EQUAL(i, newest.startEpoch);
+    }
+}
+
+void test_recovery_is_logarithmic() {
+    // Production geometry: 64KB partition, 4KB sectors, 204 slots each
+    MockFlashRegion flash(16, 4096);
+    MistJournal writer(&flash);
+    writer.begin();
+    for (uint32_t i = 1; i <= 5000; i++) {  // Wrapped once
+        writer.recordMist(i, 25000, MIST_TRIGGER_SCHEDULE, MIST_OUTCOME_COMPLETED);
+    }
+
+    MistJournal rebooted(&flash);
+    flash.resetReadCount();
+    TEST_ASSERT_TRUE(rebooted.begin());
+    TEST_ASSERT_EQUAL(5001, rebooted.getNextSequence());
+
+    // log2(16) + log2(204) + a few key reads, vs. 3264 slots for a full scan
+    TEST_ASSERT_TRUE(flash.getReadCount() <= 20);
+    TEST_ASSERT_EQUAL(flash.getReadCount(), (int)rebooted.getLastRecoveryReads());
+}
+
+void test_power_cut_mid_record_is_skipped() {
+    MockFlashRegion flash(SECTORS, SECTOR_SIZE);
+    MistJournal journal(&flash);
+    journal.begin();
+    for (uint32_t i = 1; i <= 7; i++) {
+        journal.recordMist(i, 25000, MIST_TRIGGER_SCHEDULE, MIST_OUTCOME_COMPLETED);
+    }
+
+    // Power dies after half of record 8 has been programmed
+    flash.cutPowerAfterBytes(sizeof(MistRecord) / 2);
+    TEST_ASSERT_FALSE(journal.recordMist(8, 25000, MIST_TRIGGER_SCHEDULE, MIST_OUTCOME_COMPLETED));
+    flash.restorePower();
+
+    MistJournal rebooted(&flash);
+    TEST_ASSERT_TRUE(rebooted.begin());
+    TEST_ASSERT_EQUAL(9, rebooted.getNextSequence());  // Torn slot consumed
+    TEST_ASSERT_TRUE(rebooted.recordMist(9, 25000, MIST_TRIGGER_SCHEDULE, MIST_OUTCOME_COMPLETED));
+
+    MistRecord records[4];
+    TEST_ASSERT_EQUAL(3, rebooted.readRecent(records, 3));
+    TEST_ASSERT_EQUAL(9, records[0].startEpoch);
+    TEST_ASSERT_EQUAL(7, records[1].startEpoch);  // Torn record 8 skipped
+    TEST_ASSERT_EQUAL(6, records[2].startEpoch);
+}
+
+void test_power_cut_after_wrap_erase_recovers() {
+    MockFlashRegion flash(SECTORS, SECTOR_SIZE);
+    MistJournal journal(&flash);
+    journal.begin();
+    for (uint32_t i = 1; i <= 20; i++) {
+        journal.recordMist(i, 25000, MIST_TRIGGER_SCHEDULE, MIST_OUTCOME_COMPLETED);
+    }
+
+    // Wrapping into sector 0: power dies right after the erase, before the
+    // first record is programmed
+    flash.eraseSector(0);
+
+    MistJournal rebooted(&flash);
+    TEST_ASSERT_TRUE(rebooted.begin());
+    TEST_ASSERT_EQUAL(21, rebooted.getNextSequence());
+
+    MistRecord newest;
+    TEST_ASSERT_EQUAL(1, rebooted.readRecent(&newest, 1));
+    TEST_ASSERT_EQUAL(20, newest.startEpoch);
+
+    TEST_ASSERT_TRUE(rebooted.recordMist(21, 25000, MIST_TRIGGER_SCHEDULE, MIST_OUTCOME_COMPLETED));
+    TEST_ASSERT_EQUAL(1, rebooted.readRecent(&newest, 1));
+    TEST_ASSERT_EQUAL(21, newest.sequence);
+}
+
+void test_scheduler_records_each_cycle() {
+    MockFlashRegion flash(SECTORS, SECTOR_SIZE);
+    MistJournal journal(&flash);
+    journal.begin();
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockCutoffTimer timer(&relay);
+    MistingScheduler scheduler(&timeProvider, &relay, nullptr, nullptr, &timer);
+    scheduler.setJournal(&journal);
+
+    // Scheduled cycle stopped by the cut-off timer
+    timeProvider.setHour(10);
+    scheduler.update();
+    timer.fire();
+    timeProvider.advanceMillis(MistingScheduler::MIST_DURATION + 400);
+    scheduler.update();
+
+    // Forced cycle where the timer never fires: failsafe stop
+    timeProvider.advanceEpochTime(600);
+    scheduler.forceMist();
+    timeProvider.advanceMillis(MistingScheduler::MIST_DURATION * 3);
+    scheduler.update();
+
+    MistRecord records[4];
+    TEST_ASSERT_EQUAL(2, journal.readRecent(records, 4));
+    TEST_ASSERT_EQUAL(1706000600, records[0].startEpoch);
+    TEST_ASSERT_EQUAL(MIST_TRIGGER_FORCE, records[0].trigger);
+    TEST_ASSERT_EQUAL(MIST_OUTCOME_FAILSAFE, records[0].outcome);
+    TEST_ASSERT_EQUAL(MistingScheduler::MIST_DURATION * 3, records[0].durationMs);
+    TEST_ASSERT_EQUAL(1706000000, records[1].startEpoch);
+    TEST_ASSERT_EQUAL(MIST_TRIGGER_SCHEDULE, records[1].trigger);
+    TEST_ASSERT_EQUAL(MIST_OUTCOME_COMPLETED, records[1].outcome);
+    TEST_ASSERT_EQUAL(MistingScheduler::MIST_DURATION, records[1].durationMs);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_append_and_read_newest_first);
+    RUN_TEST(test_wraps_round_robin_with_even_wear);
+    RUN_TEST(test_recovery_finds_head_at_every_fill_level);
+    RUN_TEST(test_recovery_is_logarithmic);
+    RUN_TEST(test_power_cut_mid_record_is_skipped);
+    RUN_TEST(test_power_cut_after_wrap_erase_recovers);
+    RUN_TEST(test_scheduler_records_each_cycle);
+    return UNITY_END();
+}
@@ -0,0 +1,163 @@
+// test/test_mmap_storage/test_mmap_storage.cpp
+// Tests for the mmap-backed two-slot state file (POSIX hosts)
+
+#include <unity.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "MmapStateStorage.h"
+#include "MultiZoneScheduler.h"
+
+static char statePath[64];
+
+void test_state_persists_across_reopen() {
+    {
+        MmapStateStorage storage(statePath);
+        TEST_ASSERT_TRUE(storage.open());
+        TEST_ASSERT_EQUAL(0, storage.getLastMistTime());
+        TEST_ASSERT_TRUE(storage.getEnabled());
+        TEST_ASSERT_TRUE(storage.save(1706000000, true, false));
+    }
+
+    MmapStateStorage reopened(statePath);
+    TEST_ASSERT_TRUE(reopened.open());
+    unsigned long lastMistTime;
+    bool hasEverMisted, enabled;
+    TEST_ASSERT_TRUE(reopened.load(&lastMistTime, &hasEverMisted, &enabled));
+    TEST_ASSERT_EQUAL(1706000000, lastMistTime);
+    TEST_ASSERT_TRUE(hasEverMisted);
+    TEST_ASSERT_FALSE(enabled);
+}
+
+void test_commits_alternate_slots() {
+    MmapStateStorage storage(statePath);
+    storage.open();
+
+    storage.save(1, true, true);
+    int first = storage.getActiveSlot();
+    uint32_t sequence = storage.getSequence();
+    storage.save(2, true, true);
+
+    TEST_ASSERT_EQUAL(1 - first, storage.getActiveSlot());
+    TEST_ASSERT_EQUAL(sequence + 1, storage.getSequence());
+}
+
+void test_torn_slot_falls_back_to_previous_commit() {
+    size_t slotSize;
+    int torn;
+    {
+        MmapStateStorage storage(statePath);
+        storage.open();
+        storage.save(1706000000, true, true);
+        storage.save(1706007200, true, true);
+        slotSize = storage.getSlotSize();
+        torn = storage.getActiveSlot();
+    }
+
+    // Corrupt the newest slot as a crash mid-copy would
+    FILE* file = fopen(statePath, "r+b");
+    fseek(file, (long)(torn * slotSize + 12), SEEK_SET);
+    fputc(0x5A, file);
+    fclose(file);
+
+    MmapStateStorage reopened(statePath);
+    reopened.open();
+    TEST_ASSERT_EQUAL(1 - torn, reopened.getActiveSlot());
+    TEST_ASSERT_EQUAL(1706000000, reopened.getLastMistTime());
+}
+
+void test_network_cache_and_zone_state_persist() {
+    NetworkCache cache;
+    cache.valid = 1;
+    cache.channel = 11;
+    cache.bssid[5] = 0x42;
+    ZoneStateRecord zones;
+    zones.zoneCount = 4;
+    zones.lastMistEpoch[3] = 1706000000;
+    zones.seal();
+    ScheduleConfigRecord config;
+    config.encode(ScheduleConfig(10000, 3600, 7, 20));
+    {
+        MmapStateStorage storage(statePath);
+        storage.open();
+        ScheduleConfigRecord none;
+        TEST_ASSERT_FALSE(storage.loadScheduleConfig(&none, sizeof(none)));
+        storage.save(1706000000, true, true);
+        TEST_ASSERT_TRUE(storage.saveNetworkCache(cache));
+        TEST_ASSERT_TRUE(storage.saveZoneState(&zones, sizeof(zones)));
+        TEST_ASSERT_TRUE(storage.saveScheduleConfig(&config, sizeof(config)));
+    }
+
+    MmapStateStorage reopened(statePath);
+    reopened.open();
+    NetworkCache loadedCache;
+    ZoneStateRecord loadedZones;
+    TEST_ASSERT_TRUE(reopened.loadNetworkCache(&loadedCache));
+    TEST_ASSERT_TRUE(loadedCache == cache);
+    TEST_ASSERT_TRUE(reopened.loadZoneState(&loadedZones, sizeof(loadedZones)));
+    TEST_ASSERT_EQUAL(1706000000, loadedZones.lastMistEpoch[3]);
+    TEST_ASSERT_TRUE(loadedZones.isValid());
+    ScheduleConfigRecord loadedConfig;
+    ScheduleConfig decoded;
+    TEST_ASSERT_TRUE(reopened.loadScheduleConfig(&loadedConfig, sizeof(loadedConfig)));
+    TEST_ASSERT_TRUE(loadedConfig.decode(&decoded));
+    TEST_ASSERT_EQUAL(3600, decoded.intervalSeconds);
+    TEST_ASSERT_EQUAL(1706000000, reopened.getLastMistTime());  // Other state kept
+}
+
+void test_kill_mid_write_leaves_consistent_state() {
+    for (int round = 0; round < 5; round++) {
+        unlink(statePath);
+
+        pid_t child = fork();
+        if (child == 0) {
+            // Writer: enabled is always derived from lastMistTime, so any
+            // mix of two commits would break the invariant
+            MmapStateStorage storage(statePath);
+            storage.open();
+            for (unsigned long i = 1; ; i++) {
+                storage.save(i, true, (i % 2) == 0);
+            }
+        }
+
+        usleep(20000 + round * 7000);
+        kill(child, SIGKILL);
+        int status;
+        waitpid(child, &status, 0);
+        TEST_ASSERT_TRUE(WIFSIGNALED(status));
+
+        MmapStateStorage storage(statePath);
+        TEST_ASSERT_TRUE(storage.open());
+        unsigned long lastMistTime;
+        bool hasEverMisted, enabled;
+        TEST_ASSERT_TRUE(storage.load(&lastMistTime, &hasEverMisted, &enabled));
+        TEST_ASSERT_TRUE(lastMistTime > 0);
+        TEST_ASSERT_TRUE(hasEverMisted);
+        TEST_ASSERT_EQUAL((lastMistTime % 2) == 0, enabled);
+
+        // And the survivor keeps working
+        TEST_ASSERT_TRUE(storage.save(lastMistTime + 1, true, ((lastMistTime + 1) % 2) == 0));
+    }
+}
+
+void setUp(void) {
+    snprintf(statePath, sizeof(statePath), "/tmp/mist_state_%d.bin", (int)getpid());
+    unlink(statePath);
+}
+
+void tearDown(void) {
+    unlink(statePath);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_state_persists_across_reopen);
+    RUN_TEST(test_commits_alternate_slots);
+    RUN_TEST(test_torn_slot_falls_back_to_previous_commit);
+    RUN_TEST(test_network_cache_and_zone_state_persist);
+    RUN_TEST(test_kill_mid_write_leaves_consistent_state);
+    return UNITY_END();
+}
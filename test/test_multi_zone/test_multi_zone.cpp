@@ -0,0 +1,383 @@
+// test/test_multi_zone/test_multi_zone.cpp
+// Tests for the multi-zone scheduler and its single persisted state record
+
+#include <unity.h>
+#include <string.h>
+#include <vector>
+#include "MultiZoneScheduler.h"
+#include "native/mocks/MockTimeProvider.h"
+#include "native/mocks/MockRelayController.h"
+#include "native/mocks/MockStateStorage.h"
+#include "native/mocks/MockCutoffTimer.h"
+
+static ZoneConfig makeZone(unsigned long durationMs, unsigned long intervalSeconds, int startHour, int endHour) {
+    ZoneConfig config;
+    config.durationMs = durationMs;
+    config.intervalSeconds = intervalSeconds;
+    config.windowStartHour = (uint8_t)startHour;
+    config.windowEndHour = (uint8_t)endHour;
+    return config;
+}
+
+void test_zone_table_capacity_and_validation() {
+    MockTimeProvider timeProvider;
+    MockRelayController relays[MultiZoneScheduler::MAX_ZONES + 1];
+    MultiZoneScheduler scheduler(&timeProvider);
+
+    for (int i = 0; i < MultiZoneScheduler::MAX_ZONES; i++) {
+        TEST_ASSERT_EQUAL(i, scheduler.addZone(&relays[i], makeZone(25000, 7200, 9, 18)));
+    }
+    TEST_ASSERT_EQUAL(-1, scheduler.addZone(&relays[MultiZoneScheduler::MAX_ZONES], makeZone(25000, 7200, 9, 18)));
+    TEST_ASSERT_EQUAL(MultiZoneScheduler::MAX_ZONES, scheduler.getZoneCount());
+
+    MultiZoneScheduler other(&timeProvider);
+    TEST_ASSERT_EQUAL(-1, other.addZone(&relays[0], makeZone(0, 7200, 9, 18)));      // no duration
+    TEST_ASSERT_EQUAL(-1, other.addZone(&relays[0], makeZone(25000, 0, 9, 18)));     // no interval
+    TEST_ASSERT_EQUAL(-1, other.addZone(&relays[0], makeZone(60000, 60, 9, 18)));    // mist as long as the interval
+    TEST_ASSERT_EQUAL(-1, other.addZone(&relays[0], makeZone(25000, 7200, 18, 9)));  // inverted window
+    TEST_ASSERT_EQUAL(-1, other.addZone(nullptr, makeZone(25000, 7200, 9, 18)));
+    TEST_ASSERT_EQUAL(0, other.getZoneCount());
+}
+
+void test_unknown_zone_reads_as_defaults() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MultiZoneScheduler scheduler(&timeProvider);
+    scheduler.addZone(&relay, makeZone(25000, 7200, 9, 18));
+    timeProvider.setHour(10);
+    scheduler.update();
+
+    TEST_ASSERT_EQUAL(MISTING, scheduler.getZoneState(0));
+    TEST_ASSERT_EQUAL(WAITING_SYNC, scheduler.getZoneState(1));
+    TEST_ASSERT_EQUAL(0, scheduler.getZoneLastMistEpoch(1));
+    TEST_ASSERT_FALSE(scheduler.isZoneEnabled(1));
+    TEST_ASSERT_FALSE(scheduler.hasZoneEverMisted(MultiZoneScheduler::MAX_ZONES));
+}
+
+void test_each_zone_uses_its_own_window() {
+    MockTimeProvider timeProvider;
+    MockRelayController dayZone, noonZone;
+    MultiZoneScheduler scheduler(&timeProvider);
+    scheduler.addZone(&dayZone, makeZone(25000, 7200, 9, 18));
+    scheduler.addZone(&noonZone, makeZone(25000, 7200, 12, 14));
+
+    timeProvider.setHour(10);
+    scheduler.update();
+
+    TEST_ASSERT_EQUAL(MISTING, scheduler.getZoneState(0));
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getZoneState(1));
+    TEST_ASSERT_TRUE(dayZone.getIsOn());
+    TEST_ASSERT_FALSE(noonZone.getIsOn());
+
+    timeProvider.setHour(12);
+    scheduler.update();
+    TEST_ASSERT_TRUE(noonZone.getIsOn());
+}
+
+void test_each_zone_uses_its_own_duration() {
+    MockTimeProvider timeProvider;
+    MockRelayController shortZone, longZone;
+    MultiZoneScheduler scheduler(&timeProvider);
+    scheduler.addZone(&shortZone, makeZone(10000, 7200, 9, 18));
+    scheduler.addZone(&longZone, makeZone(30000, 7200, 9, 18));
+
+    timeProvider.setHour(10);
+    scheduler.update();
+    TEST_ASSERT_TRUE(shortZone.getIsOn());
+    TEST_ASSERT_TRUE(longZone.getIsOn());
+
+    timeProvider.advanceMillis(10000);
+    scheduler.update();
+    TEST_ASSERT_FALSE(shortZone.getIsOn());
+    TEST_ASSERT_TRUE(longZone.getIsOn());
+
+    timeProvider.advanceMillis(20000);
+    scheduler.update();
+    TEST_ASSERT_FALSE(longZone.getIsOn());
+}
+
+void test_each_zone_uses_its_own_interval() {
+    MockTimeProvider timeProvider;
+    MockRelayController hourly, twoHourly;
+    MultiZoneScheduler scheduler(&timeProvider);
+    scheduler.addZone(&hourly, makeZone(10000, 3600, 9, 18));
+    scheduler.addZone(&twoHourly, makeZone(10000, 7200, 9, 18));
+
+    timeProvider.setHour(10);
+    scheduler.update();
+    timeProvider.advanceMillis(10000);
+    scheduler.update();
+
+    timeProvider.advanceEpochTime(3600);
+    timeProvider.setHour(11);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(2, hourly.getTurnOnCount());
+    TEST_ASSERT_EQUAL(1, twoHourly.getTurnOnCount());
+
+    timeProvider.advanceMillis(10000);
+    scheduler.update();
+    timeProvider.advanceEpochTime(3600);
+    timeProvider.setHour(12);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(3, hourly.getTurnOnCount());
+    TEST_ASSERT_EQUAL(2, twoHourly.getTurnOnCount());
+}
+
+void test_cutoff_timer_stops_its_zone() {
+    MockTimeProvider timeProvider;
+    MockRelayController timedRelay, plainRelay;
+    MockCutoffTimer cutoffTimer(&timedRelay);
+    MockStateStorage storage;
+    MultiZoneScheduler scheduler(&timeProvider, &storage);
+    scheduler.addZone(&timedRelay, makeZone(25000, 7200, 9, 18), &cutoffTimer);
+    scheduler.addZone(&plainRelay, makeZone(25000, 7200, 9, 18));
+
+    timeProvider.setHour(10);
+    scheduler.update();
+    TEST_ASSERT_TRUE(cutoffTimer.isArmed());
+    TEST_ASSERT_EQUAL(25000, cutoffTimer.getArmedDurationMs());
+
+    // The timer turns the relay off at the deadline; update() does the bookkeeping
+    timeProvider.advanceMillis(25000);
+    cutoffTimer.fire();
+    TEST_ASSERT_FALSE(timedRelay.getIsOn());
+    scheduler.update();
+
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getZoneState(0));
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getZoneState(1));
+    TEST_ASSERT_EQUAL(1, storage.getZoneStateSaveCount());
+}
+
+void test_failsafe_stops_a_stalled_mist() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage storage;
+    MultiZoneScheduler scheduler(&timeProvider, &storage);
+    scheduler.addZone(&relay, makeZone(25000, 7200, 9, 18));
+
+    timeProvider.setHour(10);
+    scheduler.update();
+
+    // Loop stalled for 3x the duration with no cut-off timer
+    timeProvider.advanceMillis(75000);
+    scheduler.update();
+
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getZoneState(0));
+    TEST_ASSERT_FALSE(relay.getIsOn());
+    TEST_ASSERT_EQUAL(0, storage.getZoneStateSaveCount());  // Not a completed mist
+}
+
+void test_clock_corrected_backwards_does_not_hold_zone_off() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MultiZoneScheduler scheduler(&timeProvider);
+    scheduler.addZone(&relay, makeZone(10000, 3600, 9, 18));
+
+    // First mist stamped by a clock running a year ahead
+    time_t realEpoch = timeProvider.getEpochTime();
+    timeProvider.setEpochTime(realEpoch + 365L * 86400);
+    timeProvider.setHour(10);
+    scheduler.update();
+    timeProvider.advanceMillis(10000);
+    scheduler.update();
+
+    // NTP corrects the clock; the zone mists again one interval later
+    timeProvider.setEpochTime(realEpoch);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(realEpoch, scheduler.getZoneLastMistEpoch(0));
+    TEST_ASSERT_EQUAL(1, relay.getTurnOnCount());
+
+    timeProvider.advanceEpochTime(3600);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(2, relay.getTurnOnCount());
+}
+
+void test_zones_stopping_together_share_one_write() {
+    MockTimeProvider timeProvider;
+    MockRelayController relays[4];
+    MockStateStorage storage;
+    MultiZoneScheduler scheduler(&timeProvider, &storage);
+    for (int i = 0; i < 4; i++) {
+        scheduler.addZone(&relays[i], makeZone(25000, 7200, 9, 18));
+    }
+
+    timeProvider.setHour(10);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(0, storage.getZoneStateSaveCount());
+
+    timeProvider.advanceMillis(25000);
+    scheduler.update();
+
+    TEST_ASSERT_EQUAL(1, storage.getZoneStateSaveCount());
+    TEST_ASSERT_EQUAL(sizeof(ZoneStateRecord), storage.getZoneStateLength());
+    TEST_ASSERT_EQUAL(0, storage.getSaveCallCount());  // Single-zone keys untouched
+}
+
+void test_state_record_round_trip() {
+    MockTimeProvider timeProvider;
+    MockRelayController relays[3];
+    MockStateStorage storage;
+
+    {
+        MultiZoneScheduler scheduler(&timeProvider, &storage);
+        for (int i = 0; i < 3; i++) {
+            scheduler.addZone(&relays[i], makeZone(25000, 7200, 9, 18));
+        }
+        timeProvider.setHour(20);  // Outside the window: only the forced zone runs
+        scheduler.forceMist(1);
+        timeProvider.advanceMillis(25000);
+        scheduler.update();
+        scheduler.setZoneEnabled(2, false);
+    }
+
+    // Power cycle
+    MultiZoneScheduler restored(&timeProvider, &storage);
+    for (int i = 0; i < 3; i++) {
+        restored.addZone(&relays[i], makeZone(25000, 7200, 9, 18));
+    }
+    restored.loadState();
+
+    TEST_ASSERT_TRUE(restored.hasZoneEverMisted(1));
+    TEST_ASSERT_EQUAL(timeProvider.getEpochTime(), restored.getZoneLastMistEpoch(1));
+    TEST_ASSERT_FALSE(restored.isZoneEnabled(2));
+
+    // Zone 1 misted recently and zone 2 is disabled: only zone 0 starts
+    relays[0].reset(); relays[1].reset(); relays[2].reset();
+    timeProvider.setHour(10);
+    restored.update();
+    TEST_ASSERT_TRUE(relays[0].getIsOn());
+    TEST_ASSERT_FALSE(relays[1].getIsOn());
+    TEST_ASSERT_FALSE(relays[2].getIsOn());
+}
+
+void test_incompatible_record_is_ignored() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage storage;
+
+    ZoneStateRecord record;
+    record.zoneCount = 1;
+    record.lastMistEpoch[0] = 1706000000;
+    record.flags[0] = MultiZoneScheduler::FLAG_HAS_EVER_MISTED;
+    record.seal();
+    record.version = ZoneStateRecord::VERSION + 1;
+    record.crc = record.computeCrc();
+    storage.saveZoneState(&record, sizeof(record));
+
+    MultiZoneScheduler scheduler(&timeProvider, &storage);
+    scheduler.addZone(&relay, makeZone(25000, 7200, 9, 18));
+    scheduler.loadState();
+
+    TEST_ASSERT_FALSE(scheduler.hasZoneEverMisted(0));
+    TEST_ASSERT_TRUE(scheduler.isZoneEnabled(0));
+}
+
+void test_torn_record_is_ignored() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage storage;
+
+    ZoneStateRecord record;
+    record.zoneCount = 1;
+    record.lastMistEpoch[0] = 1706000000;
+    record.flags[0] = MultiZoneScheduler::FLAG_HAS_EVER_MISTED;
+    record.seal();
+    TEST_ASSERT_TRUE(record.isValid());
+    record.flags[0] = 0;  // Power lost mid-write: contents no longer match the CRC
+    storage.saveZoneState(&record, sizeof(record));
+
+    MultiZoneScheduler scheduler(&timeProvider, &storage);
+    scheduler.addZone(&relay, makeZone(25000, 7200, 9, 18));
+    scheduler.loadState();
+
+    TEST_ASSERT_FALSE(scheduler.hasZoneEverMisted(0));
+    TEST_ASSERT_EQUAL(0, scheduler.getZoneLastMistEpoch(0));
+    TEST_ASSERT_TRUE(scheduler.isZoneEnabled(0));
+}
+
+void test_next_event_is_earliest_zone_deadline() {
+    MockTimeProvider timeProvider;
+    MockRelayController shortZone, longZone, laterZone;
+    MultiZoneScheduler scheduler(&timeProvider);
+    scheduler.addZone(&shortZone, makeZone(10000, 7200, 9, 18));
+    scheduler.addZone(&longZone, makeZone(30000, 7200, 9, 18));
+    scheduler.addZone(&laterZone, makeZone(10000, 7200, 12, 14));
+
+    timeProvider.setTime(11, 59, 30);
+    timeProvider.setMillis(1000);
+    scheduler.update();
+
+    // Short zone stops first
+    TEST_ASSERT_EQUAL(11000UL, scheduler.getNextEventMillis());
+
+    timeProvider.advanceMillis(10000);
+    scheduler.update();
+
+    // Window of the third zone opens in 20s, before the long zone stops
+    timeProvider.setTime(11, 59, 40);
+    TEST_ASSERT_EQUAL(11000UL + 20000UL, scheduler.getNextEventMillis());
+}
+
+static std::vector<LogEvent> capturedEvents;
+static char lastText[128];
+
+static void captureEvent(const LogEvent& event) {
+    capturedEvents.push_back(event);
+}
+
+static void captureText(const char* message) {
+    strncpy(lastText, message, sizeof(lastText) - 1);
+    lastText[sizeof(lastText) - 1] = '\0';
+}
+
+void test_zone_messages_are_catalog_events() {
+    MockTimeProvider timeProvider;
+    MockRelayController relays[2];
+    MultiZoneScheduler scheduler(&timeProvider, nullptr, captureText);
+    scheduler.addZone(&relays[0], makeZone(25000, 7200, 9, 18));
+    scheduler.addZone(&relays[1], makeZone(25000, 7200, 9, 18));
+
+    // Text logger only: formatted from the catalog
+    scheduler.forceMist(1);
+    TEST_ASSERT_EQUAL_STRING("ZONE 1: MIST START", lastText);
+
+    // Event logger installed: ID and raw arguments, no text
+    capturedEvents.clear();
+    lastText[0] = '\0';
+    scheduler.setEventLogger(captureEvent);
+    timeProvider.setHour(20);
+    scheduler.update();  // Baseline epoch for jump detection
+    timeProvider.advanceEpochTime(3600);
+    timeProvider.advanceMillis(25000);
+    scheduler.update();
+
+    TEST_ASSERT_EQUAL_STRING("", lastText);
+    TEST_ASSERT_EQUAL(2, capturedEvents.size());
+    TEST_ASSERT_EQUAL(LOG_MSG_TIME_JUMP, capturedEvents[0].id);
+    TEST_ASSERT_EQUAL(3600, capturedEvents[0].args[0]);
+    TEST_ASSERT_EQUAL(LOG_MSG_ZONE_MIST_STOP, capturedEvents[1].id);
+    TEST_ASSERT_EQUAL(1, capturedEvents[1].args[0]);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_zone_table_capacity_and_validation);
+    RUN_TEST(test_unknown_zone_reads_as_defaults);
+    RUN_TEST(test_each_zone_uses_its_own_window);
+    RUN_TEST(test_each_zone_uses_its_own_duration);
+    RUN_TEST(test_each_zone_uses_its_own_interval);
+    RUN_TEST(test_cutoff_timer_stops_its_zone);
+    RUN_TEST(test_failsafe_stops_a_stalled_mist);
+    RUN_TEST(test_clock_corrected_backwards_does_not_hold_zone_off);
+    RUN_TEST(test_zones_stopping_together_share_one_write);
+    RUN_TEST(test_state_record_round_trip);
+    RUN_TEST(test_incompatible_record_is_ignored);
+    RUN_TEST(test_torn_record_is_ignored);
+    RUN_TEST(test_next_event_is_earliest_zone_deadline);
+    RUN_TEST(test_zone_messages_are_catalog_events);
+    return UNITY_END();
+}
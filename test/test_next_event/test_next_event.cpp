@@ -0,0 +1,116 @@
+// test/test_next_event/test_next_event.cpp
+// Tests for getNextEventMillis() - the deadline the tickless main loop sleeps until
+
+#include <unity.h>
+#include "MistingScheduler.h"
+#include "native/mocks/MockTimeProvider.h"
+#include "native/mocks/MockRelayController.h"
+
+void test_next_event_is_mist_stop_while_misting() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MistingScheduler scheduler(&timeProvider, &relay);
+
+    timeProvider.setMillis(5000);
+    timeProvider.setHour(10);
+    scheduler.update();  // Start misting
+    TEST_ASSERT_EQUAL(MISTING, scheduler.getState());
+
+    // Deadline is exactly MIST_DURATION after the start, regardless of polling
+    timeProvider.advanceMillis(1234);
+    TEST_ASSERT_EQUAL(5000 + MistingScheduler::MIST_DURATION, scheduler.getNextEventMillis());
+}
+
+void test_next_event_polls_while_waiting_sync() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    timeProvider.setTimeAvailable(false);
+    MistingScheduler scheduler(&timeProvider, &relay);
+
+    timeProvider.setMillis(1000);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(WAITING_SYNC, scheduler.getState());
+    TEST_ASSERT_EQUAL(1000 + MistingScheduler::SYNC_POLL_MS, scheduler.getNextEventMillis());
+}
+
+void test_next_event_is_window_open_before_window() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MistingScheduler scheduler(&timeProvider, &relay);
+
+    // 8:59:30 - window opens in 30 seconds
+    timeProvider.setTime(8, 59, 30);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getState());
+    TEST_ASSERT_EQUAL(30000, scheduler.getNextEventMillis());
+
+    // 6am - capped so clock jumps are still noticed
+    timeProvider.setTime(6, 0, 0);
+    TEST_ASSERT_EQUAL(MistingScheduler::MAX_EVENT_WAIT_MS, scheduler.getNextEventMillis());
+}
+
+void test_next_event_is_interval_expiry_in_window() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MistingScheduler scheduler(&timeProvider, &relay);
+
+    timeProvider.setHour(10);
+    timeProvider.setEpochTime(1706000000);
+    scheduler.update();  // First mist
+    timeProvider.advanceMillis(25000);
+    scheduler.update();  // Stop
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getState());
+
+    // 20 seconds before the 2-hour mark
+    timeProvider.setEpochTime(1706000000 + MistingScheduler::MIST_INTERVAL_SECONDS - 20);
+    unsigned long now = timeProvider.getMillis();
+    TEST_ASSERT_EQUAL(now + 20000, scheduler.getNextEventMillis());
+
+    // Waking at the deadline starts the next mist
+    timeProvider.advanceMillis(20000);
+    timeProvider.advanceEpochTime(20);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(MISTING, scheduler.getState());
+}
+
+void test_next_event_is_window_close_when_sooner() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MistingScheduler scheduler(&timeProvider, &relay);
+
+    timeProvider.setHour(17);
+    timeProvider.setEpochTime(1706000000);
+    scheduler.update();  // First mist
+    timeProvider.advanceMillis(25000);
+    scheduler.update();
+
+    // 17:59:50 - window closes in 10 seconds, interval is far away
+    timeProvider.setTime(17, 59, 50);
+    timeProvider.advanceEpochTime(600);
+    unsigned long now = timeProvider.getMillis();
+    TEST_ASSERT_EQUAL(now + 10000, scheduler.getNextEventMillis());
+}
+
+void test_next_event_bounded_when_disabled() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MistingScheduler scheduler(&timeProvider, &relay);
+
+    scheduler.setEnabled(false);
+    timeProvider.setMillis(42);
+    TEST_ASSERT_EQUAL(42 + MistingScheduler::MAX_EVENT_WAIT_MS, scheduler.getNextEventMillis());
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_next_event_is_mist_stop_while_misting);
+    RUN_TEST(test_next_event_polls_while_waiting_sync);
+    RUN_TEST(test_next_event_is_window_open_before_window);
+    RUN_TEST(test_next_event_is_interval_expiry_in_window);
+    RUN_TEST(test_next_event_is_window_close_when_sooner);
+    RUN_TEST(test_next_event_bounded_when_disabled);
+    return UNITY_END();
+}
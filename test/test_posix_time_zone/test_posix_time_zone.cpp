@@ -0,0 +1,158 @@
+// test/test_posix_time_zone/test_posix_time_zone.cpp
+// Tests PosixTimeZone against libc localtime_r for every hour of several years
+
+#include <unity.h>
+#include <stdlib.h>
+#include "PosixTimeZone.h"
+#include "LocalTimeCache.h"
+
+static const char* ZONES[] = {
+    "PST8PDT,M3.2.0,M11.1.0",
+    "EST5EDT,M3.2.0,M11.1.0",
+    "GMT0BST,M3.5.0/1,M10.5.0",
+    "CET-1CEST,M3.5.0,M10.5.0/3",
+    "AEST-10AEDT,M10.1.0,M4.1.0/3",    // Southern hemisphere
+    "<+0545>-5:45",                      // No DST, non-hour offset
+    "NST3:30NDT,M3.2.0/0:01,M11.1.0/0:01",
+};
+
+static void useLibcZone(const char* tz) {
+    setenv("TZ", tz, 1);
+    tzset();
+}
+
+static bool sameLocalTime(const struct tm& a, const struct tm& b) {
+    return a.tm_year == b.tm_year && a.tm_mon == b.tm_mon && a.tm_mday == b.tm_mday &&
+           a.tm_hour == b.tm_hour && a.tm_min == b.tm_min && a.tm_sec == b.tm_sec &&
+           a.tm_isdst == b.tm_isdst && a.tm_wday == b.tm_wday && a.tm_yday == b.tm_yday;
+}
+
+static time_t utc(int year, int month, int day, int hour, int minute) {
+    return (time_t)(PosixTimeZone::daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60);
+}
+
+void test_matches_libc_every_hour_2024_to_2030() {
+    for (size_t z = 0; z < sizeof(ZONES) / sizeof(ZONES[0]); z++) {
+        PosixTimeZone zone;
+        TEST_ASSERT_TRUE(zone.parse(ZONES[z]));
+        useLibcZone(ZONES[z]);
+
+        // Odd minute/second offset so conversions are not all on the hour
+        for (time_t epoch = utc(2024, 1, 1, 0, 0) + 1337; epoch < utc(2031, 1, 1, 0, 0); epoch += 3600) {
+            struct tm expected;
+            struct tm actual;
+            localtime_r(&epoch, &expected);
+            zone.toLocal(epoch, &actual);
+            if (!sameLocalTime(expected, actual)) {
+                TEST_FAIL_MESSAGE(ZONES[z]);
+            }
+        }
+    }
+}
+
+void test_matches_libc_at_transition_seconds() {
+    PosixTimeZone zone;
+    TEST_ASSERT_TRUE(zone.parse("PST8PDT,M3.2.0,M11.1.0"));
+    useLibcZone("PST8PDT,M3.2.0,M11.1.0");
+
+    // 2026-03-08 10:00 UTC (spring forward) and 2026-11-01 09:00 UTC (fall back)
+    time_t transitions[] = {utc(2026, 3, 8, 10, 0), utc(2026, 11, 1, 9, 0)};
+    for (int i = 0; i < 2; i++) {
+        for (time_t epoch = transitions[i] - 2; epoch <= transitions[i] + 2; epoch++) {
+            struct tm expected;
+            struct tm actual;
+            localtime_r(&epoch, &expected);
+            zone.toLocal(epoch, &actual);
+            TEST_ASSERT_TRUE(sameLocalTime(expected, actual));
+        }
+    }
+}
+
+// Active window (9am-6pm local) on the 23h and 25h days
+static long windowSecondsOnLocalDay(PosixTimeZone& zone, time_t dayStartUtc) {
+    long inWindow = 0;
+    for (time_t epoch = dayStartUtc; epoch < dayStartUtc + 30 * 3600; epoch += 60) {
+        struct tm local;
+        zone.toLocal(epoch, &local);
+        if (local.tm_mday == 8 || local.tm_mday == 1) {
+            if (local.tm_hour >= 9 && local.tm_hour < 18) inWindow += 60;
+        }
+    }
+    return inWindow;
+}
+
+void test_active_window_on_dst_days() {
+    PosixTimeZone zone;
+    TEST_ASSERT_TRUE(zone.parse("PST8PDT,M3.2.0,M11.1.0"));
+
+    // Spring forward (23h day): window opens at 9:00 PDT = 16:00 UTC
+    struct tm local;
+    zone.toLocal(utc(2026, 3, 8, 16, 0), &local);
+    TEST_ASSERT_EQUAL(9, local.tm_hour);
+    TEST_ASSERT_EQUAL(1, local.tm_isdst);
+    TEST_ASSERT_EQUAL(9 * 3600, windowSecondsOnLocalDay(zone, utc(2026, 3, 8, 0, 0)));
+
+    // Fall back (25h day): window opens at 9:00 PST = 17:00 UTC
+    zone.toLocal(utc(2026, 11, 1, 17, 0), &local);
+    TEST_ASSERT_EQUAL(9, local.tm_hour);
+    TEST_ASSERT_EQUAL(0, local.tm_isdst);
+    TEST_ASSERT_EQUAL(9 * 3600, windowSecondsOnLocalDay(zone, utc(2026, 11, 1, 0, 0)));
+}
+
+void test_utc_offset_and_defaults() {
+    PosixTimeZone zone;
+    TEST_ASSERT_TRUE(zone.parse("EST5EDT"));  // No rules: US default
+    TEST_ASSERT_TRUE(zone.hasDst());
+    TEST_ASSERT_EQUAL(-5 * 3600, zone.utcOffsetAt(utc(2026, 1, 15, 12, 0)));
+    TEST_ASSERT_EQUAL(-4 * 3600, zone.utcOffsetAt(utc(2026, 7, 15, 12, 0)));
+
+    TEST_ASSERT_TRUE(zone.parse("UTC0"));
+    TEST_ASSERT_FALSE(zone.hasDst());
+    TEST_ASSERT_EQUAL(0, zone.utcOffsetAt(utc(2026, 7, 15, 12, 0)));
+}
+
+void test_rejects_malformed_strings() {
+    PosixTimeZone zone;
+    TEST_ASSERT_FALSE(zone.parse(""));
+    TEST_ASSERT_FALSE(zone.parse("PS8"));
+    TEST_ASSERT_FALSE(zone.parse("PST"));
+    TEST_ASSERT_FALSE(zone.parse("PST8PDT,M13.2.0,M11.1.0"));
+    TEST_ASSERT_FALSE(zone.parse("PST8PDT,M3.2.0"));
+    TEST_ASSERT_FALSE(zone.isValid());
+}
+
+void test_local_time_cache_uses_time_zone() {
+    PosixTimeZone zone;
+    TEST_ASSERT_TRUE(zone.parse("CET-1CEST,M3.5.0,M10.5.0/3"));
+    useLibcZone("CET-1CEST,M3.5.0,M10.5.0/3");
+
+    LocalTimeCache cache;
+    cache.setTimeZone(&zone);
+
+    // 2026-10-25 fall-back night, once per 13 seconds
+    for (time_t epoch = utc(2026, 10, 24, 22, 0); epoch < utc(2026, 10, 25, 4, 0); epoch += 13) {
+        struct tm expected;
+        struct tm actual;
+        localtime_r(&epoch, &expected);
+        cache.toLocal(epoch, &actual);
+        TEST_ASSERT_TRUE(sameLocalTime(expected, actual));
+    }
+}
+
+void setUp(void) {}
+
+void tearDown(void) {
+    unsetenv("TZ");
+    tzset();
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_matches_libc_every_hour_2024_to_2030);
+    RUN_TEST(test_matches_libc_at_transition_seconds);
+    RUN_TEST(test_active_window_on_dst_days);
+    RUN_TEST(test_utc_offset_and_defaults);
+    RUN_TEST(test_rejects_malformed_strings);
+    RUN_TEST(test_local_time_cache_uses_time_zone);
+    return UNITY_END();
+}
@@ -0,0 +1,344 @@
+// test/test_rtc_state_mirror/test_rtc_state_mirror.cpp
+// Tests for the RTC slow-memory state tier in front of flash storage
+
+#include <unity.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "RtcStateMirror.h"
+#include "MistJournal.h"
+#include "MistingScheduler.h"
+#include "ThreadWorkerTask.h"
+#include "native/mocks/MockStateStorage.h"
+#include "native/mocks/MockFlashRegion.h"
+#include "native/mocks/MockTimeProvider.h"
+#include "native/mocks/MockRelayController.h"
+
+// Stands in for the RTC_NOINIT_ATTR global: survives "reboots" within a test
+static RtcStateBlock rtcBlock;
+
+// Journal whose appends can fail or take as long as a sector erase
+class TestJournal : public IEventJournal {
+public:
+    TestJournal(unsigned long delayMs = 0) : delayMs(delayMs), fails(false) {}
+
+    bool recordMist(uint32_t startEpoch, uint32_t durationMs, MistTrigger trigger, MistOutcome outcome) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+        if (fails) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        appended.push_back(startEpoch);
+        return true;
+    }
+
+    std::vector<uint32_t> getAppended() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return appended;
+    }
+
+    unsigned long delayMs;
+    std::atomic<bool> fails;
+
+private:
+    std::mutex mutex;
+    std::vector<uint32_t> appended;
+};
+
+void test_cold_boot_falls_back_to_flash() {
+    memset(&rtcBlock, 0xA5, sizeof(rtcBlock));  // Power-on garbage
+    MockStateStorage flash;
+    flash.setLastMistTime(1706000000);
+    flash.setHasEverMisted(true);
+    flash.setEnabled(false);
+
+    RtcStateMirror mirror(&rtcBlock, &flash);
+    unsigned long lastMistTime;
+    bool hasEverMisted, enabled;
+    TEST_ASSERT_TRUE(mirror.load(&lastMistTime, &hasEverMisted, &enabled));
+
+    TEST_ASSERT_FALSE(mirror.wasRestoredFromRtc());
+    TEST_ASSERT_EQUAL(1, flash.getLoadCallCount());
+    TEST_ASSERT_EQUAL(1706000000, lastMistTime);
+    TEST_ASSERT_TRUE(hasEverMisted);
+    TEST_ASSERT_FALSE(enabled);
+}
+
+void test_warm_boot_prefers_rtc_over_stale_flash() {
+    memset(&rtcBlock, 0, sizeof(rtcBlock));
+    MockStateStorage flash;
+    {
+        RtcStateMirror mirror(&rtcBlock, &flash);
+        mirror.save(1706000000, true, true);   // Flags changed: written through
+        mirror.save(1706007200, true, true);   // Timestamp only: RTC only
+        TEST_ASSERT_EQUAL(1, flash.getSaveCallCount());
+    }
+
+    // Watchdog reset: RTC memory kept, flash holds the older timestamp
+    int flashLoads = flash.getLoadCallCount();
+    RtcStateMirror rebooted(&rtcBlock, &flash);
+    TEST_ASSERT_EQUAL(1706007200, rebooted.getLastMistTime());
+    TEST_ASSERT_TRUE(rebooted.wasRestoredFromRtc());
+    TEST_ASSERT_EQUAL(flashLoads, flash.getLoadCallCount());
+    TEST_ASSERT_EQUAL(1706000000, flash.getLastMistTime());
+}
+
+void test_corrupt_block_is_rejected() {
+    memset(&rtcBlock, 0, sizeof(rtcBlock));
+    MockStateStorage flash;
+    {
+        RtcStateMirror mirror(&rtcBlock, &flash);
+        mirror.save(1706000000, true, true);
+        mirror.save(1706007200, true, true);
+    }
+
+    rtcBlock.lastMistTime ^= 0x10;  // Bit flip without a matching CRC
+
+    RtcStateMirror rebooted(&rtcBlock, &flash);
+    TEST_ASSERT_EQUAL(1706000000, rebooted.getLastMistTime());
+    TEST_ASSERT_FALSE(rebooted.wasRestoredFromRtc());
+}
+
+void test_flash_written_on_flag_change_or_interval() {
+    memset(&rtcBlock, 0, sizeof(rtcBlock));
+    MockStateStorage flash;
+    RtcStateMirror mirror(&rtcBlock, &flash);
+    mirror.setFlashIntervalSeconds(21600);
+    mirror.save(1706000000, true, true);
+    flash.resetSaveCallCount();
+
+    // Two-hourly mists: flash only every 6 hours
+    for (unsigned long i = 1; i <= 6; i++) {
+        mirror.save(1706000000 + i * 7200, true, true);
+    }
+    TEST_ASSERT_EQUAL(2, flash.getSaveCallCount());
+    TEST_ASSERT_EQUAL(1706000000 + 6 * 7200, flash.getLastMistTime());
+
+    // Disabling is written through immediately
+    mirror.save(1706000000 + 6 * 7200, true, false);
+    TEST_ASSERT_EQUAL(3, flash.getSaveCallCount());
+    TEST_ASSERT_FALSE(flash.getEnabled());
+}
+
+void test_event_ring_survives_warm_boot() {
+    memset(&rtcBlock, 0, sizeof(rtcBlock));
+    MockStateStorage flash;
+    {
+        RtcStateMirror mirror(&rtcBlock, &flash);
+        mirror.save(0, false, true);
+        for (uint32_t i = 1; i <= 10; i++) {
+            mirror.recordMist(1706000000 + i, 25000, MIST_TRIGGER_SCHEDULE, MIST_OUTCOME_COMPLETED);
+        }
+    }
+
+    RtcStateMirror rebooted(&rtcBlock, &flash);
+    rebooted.getEnabled();
+    TEST_ASSERT_TRUE(rebooted.wasRestoredFromRtc());
+
+    RtcEvent events[RtcStateBlock::EVENT_RING_SIZE + 2];
+    TEST_ASSERT_EQUAL(RtcStateBlock::EVENT_RING_SIZE, rebooted.readRecentEvents(events, RtcStateBlock::EVENT_RING_SIZE + 2));
+    TEST_ASSERT_EQUAL(1706000010, events[0].startEpoch);
+    TEST_ASSERT_EQUAL(1706000003, events[RtcStateBlock::EVENT_RING_SIZE - 1].startEpoch);
+}
+
+void test_events_drain_to_journal_in_order_without_loss() {
+    memset(&rtcBlock, 0, sizeof(rtcBlock));
+    MockStateStorage flash;
+    MockFlashRegion journalFlash(4, 4096);
+    MistJournal journal(&journalFlash);
+    journal.begin();
+
+    RtcStateMirror mirror(&rtcBlock, &flash);
+    mirror.setJournal(&journal);
+    mirror.save(0, false, true);
+
+    // More events than the ring holds, no state flush in between
+    for (uint32_t i = 1; i <= 20; i++) {
+        mirror.recordMist(i, 25000, MIST_TRIGGER_SCHEDULE, MIST_OUTCOME_COMPLETED);
+    }
+    TEST_ASSERT_TRUE(mirror.flushToFlash());
+
+    MistRecord records[32];
+    TEST_ASSERT_EQUAL(20, journal.readRecent(records, 32));
+    for (uint32_t i = 0; i < 20; i++) {
+        TEST_ASSERT_EQUAL(20 - i, records[i].startEpoch);
+    }
+}
+
+void test_failed_append_keeps_events_pending() {
+    memset(&rtcBlock, 0, sizeof(rtcBlock));
+    MockStateStorage flash;
+    TestJournal journal;
+    journal.fails = true;
+    {
+        RtcStateMirror mirror(&rtcBlock, &flash);
+        mirror.setJournal(&journal);
+        mirror.save(0, false, true);
+        for (uint32_t i = 1; i <= 3; i++) {
+            mirror.recordMist(i, 25000, MIST_TRIGGER_SCHEDULE, MIST_OUTCOME_COMPLETED);
+        }
+        TEST_ASSERT_TRUE(mirror.flushToFlash());  // State written, events not
+        TEST_ASSERT_FALSE(mirror.waitForJournal());
+        TEST_ASSERT_EQUAL(3, mirror.getPendingEventCount());
+    }
+
+    // Still pending after a warm boot; appended in order once the journal works
+    journal.fails = false;
+    RtcStateMirror rebooted(&rtcBlock, &flash);
+    rebooted.setJournal(&journal);
+    rebooted.getEnabled();
+    TEST_ASSERT_EQUAL(3, rebooted.getPendingEventCount());
+    rebooted.recordMist(4, 25000, MIST_TRIGGER_FORCE, MIST_OUTCOME_COMPLETED);
+    TEST_ASSERT_TRUE(rebooted.waitForJournal());
+
+    std::vector<uint32_t> appended = journal.getAppended();
+    TEST_ASSERT_EQUAL(4, appended.size());
+    for (uint32_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(i + 1, appended[i]);
+    }
+    TEST_ASSERT_EQUAL(0, rtcBlock.pendingEvents);
+}
+
+void test_journal_worker_keeps_appends_off_the_caller() {
+    memset(&rtcBlock, 0, sizeof(rtcBlock));
+    MockStateStorage flash;
+    TestJournal journal(30);
+    ThreadWorkerTask worker;
+    RtcStateMirror mirror(&rtcBlock, &flash);
+    mirror.setJournal(&journal, &worker);
+    mirror.save(0, false, true);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t i = 1; i <= 5; i++) {
+        mirror.recordMist(i, 25000, MIST_TRIGGER_SCHEDULE, MIST_OUTCOME_COMPLETED);
+    }
+    mirror.flushToFlash();
+    long elapsedMs = (long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_TRUE(elapsedMs < 10);
+
+    TEST_ASSERT_TRUE(mirror.waitForJournal());
+    TEST_ASSERT_EQUAL(5, journal.getAppended().size());
+    TEST_ASSERT_EQUAL(5, journal.getAppended().back());
+}
+
+void test_stalled_journal_drops_new_events_not_pending_ones() {
+    memset(&rtcBlock, 0, sizeof(rtcBlock));
+    MockStateStorage flash;
+    TestJournal journal;
+    journal.fails = true;
+    ThreadWorkerTask worker;
+    RtcStateMirror mirror(&rtcBlock, &flash);
+    mirror.setJournal(&journal, &worker);
+    mirror.save(0, false, true);
+
+    for (uint32_t i = 1; i <= RtcStateBlock::EVENT_RING_SIZE; i++) {
+        TEST_ASSERT_TRUE(mirror.recordMist(i, 25000, MIST_TRIGGER_SCHEDULE, MIST_OUTCOME_COMPLETED));
+    }
+    TEST_ASSERT_FALSE(mirror.recordMist(100, 25000, MIST_TRIGGER_SCHEDULE, MIST_OUTCOME_COMPLETED));
+    TEST_ASSERT_EQUAL(1, mirror.getDroppedEventCount());
+
+    journal.fails = false;
+    TEST_ASSERT_TRUE(mirror.waitForJournal());
+    std::vector<uint32_t> appended = journal.getAppended();
+    TEST_ASSERT_EQUAL(RtcStateBlock::EVENT_RING_SIZE, appended.size());
+    TEST_ASSERT_EQUAL(1, appended.front());
+    TEST_ASSERT_EQUAL(RtcStateBlock::EVENT_RING_SIZE, appended.back());
+}
+
+void test_scheduler_cycles_cost_no_flash_writes() {
+    memset(&rtcBlock, 0, sizeof(rtcBlock));
+    MockStateStorage flash;
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    RtcStateMirror mirror(&rtcBlock, &flash);
+    MistingScheduler scheduler(&timeProvider, &relay, &mirror);
+    scheduler.setJournal(&mirror);
+    scheduler.loadState();
+
+    // First mist sets hasEverMisted (written through), later ones stay in RTC
+    for (int cycle = 0; cycle < 3; cycle++) {
+        timeProvider.setHour(10 + cycle * 2);
+        scheduler.update();
+        timeProvider.advanceMillis(MistingScheduler::MIST_DURATION);
+        scheduler.update();
+        timeProvider.advanceEpochTime(MistingScheduler::MIST_INTERVAL_SECONDS);
+    }
+
+    TEST_ASSERT_EQUAL(3, relay.getTurnOnCount());
+    TEST_ASSERT_EQUAL(1, flash.getSaveCallCount());
+    TEST_ASSERT_EQUAL(1706000000 + 2 * MistingScheduler::MIST_INTERVAL_SECONDS, mirror.getLastMistTime());
+}
+
+void test_power_cut_does_not_repeat_a_recent_mist() {
+    memset(&rtcBlock, 0, sizeof(rtcBlock));
+    MockStateStorage flash;
+    MockFlashRegion journalFlash(4, 4096);
+    MockTimeProvider timeProvider;
+    time_t firstMist = timeProvider.getEpochTime();
+    {
+        MockRelayController relay;
+        MistJournal journal(&journalFlash);
+        journal.begin();
+        ThreadWorkerTask worker;
+        RtcStateMirror mirror(&rtcBlock, &flash);
+        mirror.setJournal(&journal, &worker);
+        MistingScheduler scheduler(&timeProvider, &relay, &mirror);
+        scheduler.setJournal(&mirror);
+        scheduler.loadState();
+
+        // Two cycles: the second stays in RTC memory, not in flash state
+        for (int cycle = 0; cycle < 2; cycle++) {
+            timeProvider.setHour(10 + cycle * 2);
+            scheduler.update();
+            timeProvider.advanceMillis(MistingScheduler::MIST_DURATION);
+            scheduler.update();
+            if (cycle == 0) {
+                timeProvider.advanceEpochTime(MistingScheduler::MIST_INTERVAL_SECONDS);
+            }
+        }
+        TEST_ASSERT_TRUE(mirror.waitForJournal());
+        TEST_ASSERT_EQUAL(firstMist, (time_t)flash.getLastMistTime());
+    }
+
+    // Power cut minutes after the second mist: RTC memory is lost
+    memset(&rtcBlock, 0xA5, sizeof(rtcBlock));
+    timeProvider.advanceEpochTime(600);
+
+    MockRelayController relay;
+    MistJournal journal(&journalFlash);
+    journal.begin();
+    RtcStateMirror mirror(&rtcBlock, &flash);
+    mirror.setJournal(&journal);
+    MistingScheduler scheduler(&timeProvider, &relay, &mirror);
+    scheduler.loadState();
+    TEST_ASSERT_EQUAL(firstMist + MistingScheduler::MIST_INTERVAL_SECONDS, mirror.getLastMistTime());
+
+    // Time syncs inside the window: the mist 10 minutes ago is not repeated
+    scheduler.update();
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getState());
+    TEST_ASSERT_EQUAL(0, relay.getTurnOnCount());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_cold_boot_falls_back_to_flash);
+    RUN_TEST(test_warm_boot_prefers_rtc_over_stale_flash);
+    RUN_TEST(test_corrupt_block_is_rejected);
+    RUN_TEST(test_flash_written_on_flag_change_or_interval);
+    RUN_TEST(test_event_ring_survives_warm_boot);
+    RUN_TEST(test_events_drain_to_journal_in_order_without_loss);
+    RUN_TEST(test_failed_append_keeps_events_pending);
+    RUN_TEST(test_journal_worker_keeps_appends_off_the_caller);
+    RUN_TEST(test_stalled_journal_drops_new_events_not_pending_ones);
+    RUN_TEST(test_scheduler_cycles_cost_no_flash_writes);
+    RUN_TEST(test_power_cut_does_not_repeat_a_recent_mist);
+    return UNITY_END();
+}
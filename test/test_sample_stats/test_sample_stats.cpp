@@ -0,0 +1,66 @@
+// test/test_sample_stats/test_sample_stats.cpp
+// Tests for the min/median/p99 summary used by the on-device BENCH command
+
+#include <unity.h>
+#include "SampleStats.h"
+
+void test_empty_batch_is_all_zero() {
+    SampleSummary summary = summarizeSamples(nullptr, 0);
+
+    TEST_ASSERT_EQUAL(0, summary.count);
+    TEST_ASSERT_EQUAL(0, summary.min);
+    TEST_ASSERT_EQUAL(0, summary.median);
+    TEST_ASSERT_EQUAL(0, summary.p99);
+    TEST_ASSERT_EQUAL(0, summary.max);
+}
+
+void test_unsorted_samples_are_summarized() {
+    uint32_t samples[] = { 50, 10, 40, 20, 30 };
+    SampleSummary summary = summarizeSamples(samples, 5);
+
+    TEST_ASSERT_EQUAL(5, summary.count);
+    TEST_ASSERT_EQUAL(10, summary.min);
+    TEST_ASSERT_EQUAL(30, summary.median);
+    TEST_ASSERT_EQUAL(50, summary.p99);
+    TEST_ASSERT_EQUAL(50, summary.max);
+    TEST_ASSERT_EQUAL(10, samples[0]);  // Sorted in place
+    TEST_ASSERT_EQUAL(50, samples[4]);
+
+    // Even count: the lower of the two middle samples
+    uint32_t pair[] = { 7, 3 };
+    TEST_ASSERT_EQUAL(3, summarizeSamples(pair, 2).median);
+}
+
+void test_p99_ignores_the_worst_percent() {
+    // 200 samples of 1000..1199 cycles plus two interrupt-inflated outliers
+    uint32_t samples[200];
+    for (uint32_t i = 0; i < 198; i++) {
+        samples[i] = 1000 + (i * 7) % 198;
+    }
+    samples[198] = 90000;
+    samples[199] = 250000;
+
+    SampleSummary summary = summarizeSamples(samples, 200);
+
+    TEST_ASSERT_EQUAL(1000, summary.min);
+    TEST_ASSERT_EQUAL(1099, summary.median);
+    TEST_ASSERT_EQUAL(1197, summary.p99);
+    TEST_ASSERT_EQUAL(250000, summary.max);
+
+    // 101 samples: the 100th smallest is p99, one outlier is excluded
+    uint32_t few[101];
+    for (uint32_t i = 0; i < 101; i++) {
+        few[i] = (i == 50) ? 5000 : i;
+    }
+    summary = summarizeSamples(few, 101);
+    TEST_ASSERT_EQUAL(100, summary.p99);
+    TEST_ASSERT_EQUAL(5000, summary.max);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_batch_is_all_zero);
+    RUN_TEST(test_unsorted_samples_are_summarized);
+    RUN_TEST(test_p99_ignores_the_worst_percent);
+    return UNITY_END();
+}
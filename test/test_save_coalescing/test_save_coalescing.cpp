@@ -0,0 +1,204 @@
+// test/test_save_coalescing/test_save_coalescing.cpp
+// Tests for skipping identical state writes and coalescing rapid changes
+
+#include <unity.h>
+#include <string.h>
+#include "MistingScheduler.h"
+#include "RtcStateMirror.h"
+#include "AsyncStateStorage.h"
+#include "ThreadWorkerTask.h"
+#include "native/mocks/MockTimeProvider.h"
+#include "native/mocks/MockRelayController.h"
+#include "native/mocks/MockStateStorage.h"
+
+// Helper class to capture log messages
+class LogCapture {
+public:
+    static void reset() {
+        found = false;
+    }
+
+    static void captureLog(const char* message) {
+        if (strcmp(message, "STATUS: saves requested=3 written=1") == 0) {
+            found = true;
+        }
+    }
+
+    static bool found;
+};
+
+bool LogCapture::found = false;
+
+void test_identical_save_is_skipped() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage storage;
+    MistingScheduler scheduler(&timeProvider, &relay, &storage);
+
+    scheduler.setEnabled(false);
+    scheduler.setEnabled(false);
+    scheduler.setEnabled(false);
+
+    TEST_ASSERT_EQUAL(1, storage.getSaveCallCount());
+    TEST_ASSERT_EQUAL(3, scheduler.getSaveRequestCount());
+    TEST_ASSERT_EQUAL(1, scheduler.getSaveWriteCount());
+}
+
+void test_loaded_state_counts_as_committed() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage storage;
+    storage.setLastMistTime(1706000000);
+    storage.setHasEverMisted(true);
+    storage.setEnabled(true);
+
+    MistingScheduler scheduler(&timeProvider, &relay, &storage);
+    scheduler.loadState();
+    timeProvider.setHour(20);
+    scheduler.update();  // Synced and idle
+    scheduler.setEnabled(true);
+
+    TEST_ASSERT_EQUAL(0, storage.getSaveCallCount());
+
+    scheduler.setEnabled(false);
+    TEST_ASSERT_EQUAL(1, storage.getSaveCallCount());
+    TEST_ASSERT_FALSE(storage.getEnabled());
+}
+
+void test_rapid_changes_coalesce_into_one_write() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage storage;
+    MistingScheduler scheduler(&timeProvider, &relay, &storage);
+    scheduler.setSaveCoalesceMs(2000);
+    timeProvider.setHour(20);  // Outside the window, nothing mists
+
+    for (int i = 0; i < 5; i++) {
+        scheduler.setEnabled(false);
+        timeProvider.advanceMillis(500);
+        scheduler.update();
+        scheduler.setEnabled(true);
+        timeProvider.advanceMillis(500);
+        scheduler.update();
+    }
+    scheduler.setEnabled(false);
+    TEST_ASSERT_EQUAL(0, storage.getSaveCallCount());
+    TEST_ASSERT_TRUE(scheduler.hasPendingSave());
+
+    // Quiet period not yet over
+    timeProvider.advanceMillis(1999);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(0, storage.getSaveCallCount());
+
+    timeProvider.advanceMillis(1);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(1, storage.getSaveCallCount());
+    TEST_ASSERT_FALSE(storage.getEnabled());
+    TEST_ASSERT_FALSE(scheduler.hasPendingSave());
+    TEST_ASSERT_EQUAL(11, scheduler.getSaveRequestCount());
+}
+
+void test_coalesced_change_back_to_committed_value_is_not_written() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage storage;
+    MistingScheduler scheduler(&timeProvider, &relay, &storage);
+    scheduler.loadState();
+    scheduler.saveState();  // Commit the defaults
+    storage.resetSaveCallCount();
+    scheduler.setSaveCoalesceMs(2000);
+
+    scheduler.setEnabled(false);
+    scheduler.setEnabled(true);
+    timeProvider.advanceMillis(5000);
+    scheduler.update();
+
+    TEST_ASSERT_EQUAL(0, storage.getSaveCallCount());
+    TEST_ASSERT_FALSE(scheduler.hasPendingSave());
+}
+
+void test_pending_save_bounds_next_event() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage storage;
+    MistingScheduler scheduler(&timeProvider, &relay, &storage);
+    scheduler.setSaveCoalesceMs(2000);
+    timeProvider.setMillis(1000);
+
+    scheduler.setEnabled(false);
+
+    // Disabled would otherwise sleep MAX_EVENT_WAIT_MS
+    TEST_ASSERT_EQUAL(3000UL, scheduler.getNextEventMillis());
+
+    scheduler.flushPendingSave();
+    TEST_ASSERT_EQUAL(1, storage.getSaveCallCount());
+    TEST_ASSERT_EQUAL(1000UL + MistingScheduler::MAX_EVENT_WAIT_MS, scheduler.getNextEventMillis());
+}
+
+// Same order as flushStateOnShutdown() in main.cpp
+static void flushForShutdown(MistingScheduler& scheduler, RtcStateMirror& mirror, AsyncStateStorage& async) {
+    scheduler.flushPendingSave();
+    mirror.flushToFlash();
+    async.flush();
+}
+
+void test_pending_save_is_committed_by_shutdown_flush() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage flash;
+    ThreadWorkerTask worker;
+    AsyncStateStorage async(&flash, &worker);
+    RtcStateBlock block;
+    memset(&block, 0, sizeof(block));
+    RtcStateMirror mirror(&block, &async);
+    MistingScheduler scheduler(&timeProvider, &relay, &mirror);
+    async.begin();
+    scheduler.loadState();
+    scheduler.setSaveCoalesceMs(2000);
+    timeProvider.setHour(20);
+    scheduler.update();
+
+    // DISABLE, then a restart (OTA) inside the quiet period
+    scheduler.setEnabled(false);
+    TEST_ASSERT_TRUE(scheduler.hasPendingSave());
+    mirror.flushToFlash();
+    async.flush();
+    TEST_ASSERT_TRUE(flash.getEnabled());  // Flushing the lower tiers alone misses it
+
+    flushForShutdown(scheduler, mirror, async);
+
+    TEST_ASSERT_FALSE(scheduler.hasPendingSave());
+    TEST_ASSERT_FALSE(flash.getEnabled());
+}
+
+void test_status_reports_save_counters() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage storage;
+    MistingScheduler scheduler(&timeProvider, &relay, &storage, LogCapture::captureLog);
+
+    scheduler.setEnabled(false);
+    scheduler.setEnabled(false);
+    scheduler.setEnabled(false);
+    scheduler.printStatus();
+
+    TEST_ASSERT_TRUE(LogCapture::found);
+}
+
+void setUp(void) {
+    LogCapture::reset();
+}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_identical_save_is_skipped);
+    RUN_TEST(test_loaded_state_counts_as_committed);
+    RUN_TEST(test_rapid_changes_coalesce_into_one_write);
+    RUN_TEST(test_coalesced_change_back_to_committed_value_is_not_written);
+    RUN_TEST(test_pending_save_bounds_next_event);
+    RUN_TEST(test_pending_save_is_committed_by_shutdown_flush);
+    RUN_TEST(test_status_reports_save_counters);
+    return UNITY_END();
+}
@@ -0,0 +1,176 @@
+// test/test_schedule_config/test_schedule_config.cpp
+// Tests for the runtime schedule config: validation, persistence and the
+// double-buffered swap seen by the scheduler
+
+#include <unity.h>
+#include <string.h>
+#include "MistingScheduler.h"
+#include "native/mocks/MockTimeProvider.h"
+#include "native/mocks/MockRelayController.h"
+#include "native/mocks/MockStateStorage.h"
+
+static ScheduleConfig defaults() {
+    return ScheduleConfig(MistingScheduler::MIST_DURATION, MistingScheduler::MIST_INTERVAL_SECONDS,
+                          MistingScheduler::ACTIVE_WINDOW_START, MistingScheduler::ACTIVE_WINDOW_END);
+}
+
+void test_validation_rejects_out_of_range_and_inconsistent_configs() {
+    TEST_ASSERT_TRUE(defaults().isValid());
+    TEST_ASSERT_TRUE(ScheduleConfig(1000, 60, 0, 24).isValid());
+    TEST_ASSERT_TRUE(ScheduleConfig(120000, 86400, 23, 24).isValid());
+
+    TEST_ASSERT_FALSE(ScheduleConfig().isValid());
+    TEST_ASSERT_FALSE(ScheduleConfig(999, 7200, 9, 18).isValid());     // Mist too short
+    TEST_ASSERT_FALSE(ScheduleConfig(120001, 7200, 9, 18).isValid());  // Mist too long
+    TEST_ASSERT_FALSE(ScheduleConfig(25000, 59, 9, 18).isValid());     // Interval too short
+    TEST_ASSERT_FALSE(ScheduleConfig(25000, 86401, 9, 18).isValid());  // Interval too long
+    TEST_ASSERT_FALSE(ScheduleConfig(90000, 90, 9, 18).isValid());     // Mist not shorter than interval
+    TEST_ASSERT_FALSE(ScheduleConfig(25000, 7200, 9, 9).isValid());    // Window empty
+    TEST_ASSERT_TRUE(ScheduleConfig(25000, 7200, 22, 6).isValid());    // Wraps past midnight
+}
+
+void test_record_round_trip_and_corruption() {
+    ScheduleExpression window;
+    TEST_ASSERT_TRUE(window.compile("30-59 6 * * MON-FRI; * 7-19 * * *"));
+    ScheduleConfig config(10000, 3600, window);
+    ScheduleConfigRecord record;
+    record.encode(config);
+    TEST_ASSERT_EQUAL(120, sizeof(record));
+
+    ScheduleConfig decoded;
+    TEST_ASSERT_TRUE(record.decode(&decoded));
+    TEST_ASSERT_TRUE(decoded == config);
+
+    // Flipped bit: rejected, output untouched
+    ScheduleConfigRecord corrupt = record;
+    corrupt.intervalSeconds ^= 0x10;
+    ScheduleConfig untouched = defaults();
+    TEST_ASSERT_FALSE(corrupt.decode(&untouched));
+    TEST_ASSERT_TRUE(untouched == defaults());
+
+    // Other version
+    corrupt = record;
+    corrupt.version = ScheduleConfigRecord::VERSION + 1;
+    corrupt.crc = corrupt.computeCrc();
+    TEST_ASSERT_FALSE(corrupt.decode(&untouched));
+
+    // Intact but invalid values (e.g. written by a build with wider limits)
+    corrupt.encode(ScheduleConfig(25000, 30, 9, 18));
+    TEST_ASSERT_FALSE(corrupt.decode(&untouched));
+}
+
+void test_buffer_swap_leaves_readers_old_config_intact() {
+    ScheduleConfigBuffer buffer(defaults());
+    const ScheduleConfig& before = buffer.current();
+
+    // Reader holding the live config while a new window is published
+    TEST_ASSERT_TRUE(buffer.publish(ScheduleConfig(25000, 7200, 6, 10)));
+    TEST_ASSERT_TRUE(before == defaults());
+    TEST_ASSERT_TRUE(buffer.current() == ScheduleConfig(25000, 7200, 6, 10));
+    TEST_ASSERT_TRUE(&buffer.current() != &before);
+
+    // Invalid config never becomes visible
+    TEST_ASSERT_FALSE(buffer.publish(ScheduleConfig(25000, 7200, 10, 10)));
+    TEST_ASSERT_TRUE(buffer.current() == ScheduleConfig(25000, 7200, 6, 10));
+}
+
+void test_config_drives_schedule_and_persists() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage storage;
+    MistingScheduler scheduler(&timeProvider, &relay, &storage);
+
+    // Shorter interval and mist
+    TEST_ASSERT_TRUE(scheduler.setConfig(ScheduleConfig(5000, 600, 9, 18)));
+    TEST_ASSERT_EQUAL(1, storage.getScheduleConfigSaveCount());
+
+    timeProvider.setHour(10);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(MISTING, scheduler.getState());
+    TEST_ASSERT_EQUAL(5000, scheduler.getMistDurationMs());
+    timeProvider.advanceMillis(5000);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getState());
+
+    // Next mist after 10 minutes, not 2 hours
+    timeProvider.advanceEpochTime(599);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getState());
+    timeProvider.advanceEpochTime(1);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(MISTING, scheduler.getState());
+
+    // Rejected and unchanged configs are not written
+    TEST_ASSERT_FALSE(scheduler.setConfig(ScheduleConfig(5000, 600, 9, 9)));
+    TEST_ASSERT_TRUE(scheduler.setConfig(ScheduleConfig(5000, 600, 9, 18)));
+    TEST_ASSERT_EQUAL(1, storage.getScheduleConfigSaveCount());
+
+    // A fresh scheduler (reboot) loads it
+    MistingScheduler rebooted(&timeProvider, &relay, &storage);
+    TEST_ASSERT_TRUE(rebooted.getConfig() == defaults());
+    rebooted.loadState();
+    TEST_ASSERT_TRUE(rebooted.getConfig() == ScheduleConfig(5000, 600, 9, 18));
+
+    // Corrupt record: defaults kept
+    storage.getScheduleConfigBytes()[4] ^= 0xFF;
+    MistingScheduler corrupted(&timeProvider, &relay, &storage);
+    corrupted.loadState();
+    TEST_ASSERT_TRUE(corrupted.getConfig() == defaults());
+}
+
+void test_change_during_mist_does_not_extend_it() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MistingScheduler scheduler(&timeProvider, &relay);
+
+    timeProvider.setHour(10);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(MISTING, scheduler.getState());
+
+    // Longer mist configured while this one runs
+    TEST_ASSERT_TRUE(scheduler.setConfig(ScheduleConfig(60000, 7200, 9, 18)));
+    timeProvider.advanceMillis(MistingScheduler::MIST_DURATION);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getState());
+    TEST_ASSERT_FALSE(relay.getIsOn());
+
+    // The next mist uses it, and so does a forced one
+    timeProvider.advanceEpochTime(7200);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(60000, scheduler.getMistDurationMs());
+    timeProvider.advanceMillis(60000);
+    scheduler.update();
+    scheduler.forceMist();
+    TEST_ASSERT_EQUAL(60000, scheduler.getMistDurationMs());
+}
+
+void test_window_change_applies_on_next_update() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MistingScheduler scheduler(&timeProvider, &relay);
+
+    timeProvider.setHour(7);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getState());
+
+    // Earlier window opens at 6: already inside it
+    TEST_ASSERT_TRUE(scheduler.setConfig(ScheduleConfig(25000, 7200, 6, 12)));
+    TEST_ASSERT_EQUAL(timeProvider.getMillis(), scheduler.getNextEventMillis());
+    scheduler.update();
+    TEST_ASSERT_EQUAL(MISTING, scheduler.getState());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_validation_rejects_out_of_range_and_inconsistent_configs);
+    RUN_TEST(test_record_round_trip_and_corruption);
+    RUN_TEST(test_buffer_swap_leaves_readers_old_config_intact);
+    RUN_TEST(test_config_drives_schedule_and_persists);
+    RUN_TEST(test_change_during_mist_does_not_extend_it);
+    RUN_TEST(test_window_change_applies_on_next_update);
+    return UNITY_END();
+}
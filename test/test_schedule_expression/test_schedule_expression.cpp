@@ -0,0 +1,183 @@
+// test/test_schedule_expression/test_schedule_expression.cpp
+// Tests for cron-style active windows compiled to bitsets
+
+#include <unity.h>
+#include <string.h>
+#include "ScheduleExpression.h"
+#include "MistingScheduler.h"
+#include "native/mocks/MockTimeProvider.h"
+#include "native/mocks/MockRelayController.h"
+
+// Local time; wday must match the date (2026-01-22 is a Thursday)
+static struct tm at(int year, int month, int day, int weekday, int hour, int minute) {
+    struct tm local;
+    memset(&local, 0, sizeof(local));
+    local.tm_year = year - 1900;
+    local.tm_mon = month - 1;
+    local.tm_mday = day;
+    local.tm_wday = weekday;
+    local.tm_hour = hour;
+    local.tm_min = minute;
+    return local;
+}
+
+static const char* formatted(const ScheduleExpression& expression) {
+    static char text[128];
+    expression.format(text, sizeof(text));
+    return text;
+}
+
+void test_compile_and_canonical_format() {
+    ScheduleExpression expression;
+
+    TEST_ASSERT_TRUE(expression.compile("* 9-17 * * *"));
+    TEST_ASSERT_EQUAL_STRING("* 9-17 * * *", formatted(expression));
+    TEST_ASSERT_TRUE(expression == ScheduleExpression::hours(9, 18));
+
+    // Lists, steps, names (any case), 7 = Sunday, wrapping ranges
+    TEST_ASSERT_TRUE(expression.compile("*/15 0/6 1,15 jan-Mar,DEC fri-mon"));
+    TEST_ASSERT_EQUAL_STRING("0,15,30,45 0,6,12,18 1,15 1-3,12 0-1,5-6", formatted(expression));
+    TEST_ASSERT_TRUE(expression.compile("0 12 * * 7"));
+    TEST_ASSERT_EQUAL_STRING("0 12 * * 0", formatted(expression));
+    TEST_ASSERT_TRUE(expression.compile("  * 20-5 * * *  ;30-59 6 * * 1-5"));
+    TEST_ASSERT_EQUAL(2, expression.getRuleCount());
+    TEST_ASSERT_EQUAL_STRING("* 0-5,20-23 * * *; 30-59 6 * * 1-5", formatted(expression));
+
+    // Hour windows wrap the same way
+    TEST_ASSERT_EQUAL_STRING("* 0-5,22-23 * * *", formatted(ScheduleExpression::hours(22, 6)));
+    TEST_ASSERT_TRUE(ScheduleExpression::hours(9, 9).isEmpty());
+    TEST_ASSERT_EQUAL_STRING("* * * * *", formatted(ScheduleExpression::hours(0, 24)));
+
+    // Truncation reports the full length
+    char small[8];
+    size_t length = expression.format(small, sizeof(small));
+    TEST_ASSERT_EQUAL(strlen("* 0-5,20-23 * * *; 30-59 6 * * 1-5"), length);
+    TEST_ASSERT_EQUAL_STRING("* 0-5,2", small);
+}
+
+void test_invalid_expressions_are_rejected() {
+    ScheduleExpression expression = ScheduleExpression::hours(9, 18);
+    const char* invalid[] = {
+        "",                 // Nothing
+        "* * * *",          // Four fields
+        "* * * * * *",      // Six fields
+        "60 * * * *",       // Minute out of range
+        "* 24 * * *",       // Hour out of range
+        "* * 0 * *",        // Day of month starts at 1
+        "* * * 13 *",       // Month out of range
+        "* * * * 8",        // Day of week out of range
+        "5- * * * *",       // Open range
+        "*/0 * * * *",      // Zero step
+        "1,,2 * * * *",     // Empty list item
+        "1, * * * *",       // Trailing comma
+        "* * * FOO *",      // Unknown name
+        "* 9 * * *;",       // Empty rule
+        "* 1 * * *;* 2 * * *;* 3 * * *;* 4 * * *;* 5 * * *",  // Too many rules
+    };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        TEST_ASSERT_TRUE_MESSAGE(!expression.compile(invalid[i]), invalid[i]);
+    }
+    TEST_ASSERT_TRUE(expression == ScheduleExpression::hours(9, 18));  // Unchanged
+}
+
+void test_matches_windows_weekdays_and_midnight_wrap() {
+    ScheduleExpression expression;
+    TEST_ASSERT_TRUE(expression.compile("30-59 6 * * MON-FRI; * 8-11,15-17 * * MON-FRI; * 22-1 * * SAT"));
+
+    // Thursday 2026-01-22
+    TEST_ASSERT_FALSE(expression.matches(at(2026, 1, 22, 4, 6, 29)));
+    TEST_ASSERT_TRUE(expression.matches(at(2026, 1, 22, 4, 6, 30)));
+    TEST_ASSERT_FALSE(expression.matches(at(2026, 1, 22, 4, 7, 0)));
+    TEST_ASSERT_TRUE(expression.matches(at(2026, 1, 22, 4, 11, 59)));
+    TEST_ASSERT_FALSE(expression.matches(at(2026, 1, 22, 4, 12, 0)));
+    TEST_ASSERT_TRUE(expression.matches(at(2026, 1, 22, 4, 15, 0)));
+    TEST_ASSERT_FALSE(expression.matches(at(2026, 1, 22, 4, 23, 0)));
+
+    // Saturday: only the late window, whose hours wrap within the same day
+    TEST_ASSERT_FALSE(expression.matches(at(2026, 1, 24, 6, 8, 0)));
+    TEST_ASSERT_TRUE(expression.matches(at(2026, 1, 24, 6, 23, 30)));
+    TEST_ASSERT_TRUE(expression.matches(at(2026, 1, 24, 6, 0, 30)));
+    TEST_ASSERT_FALSE(expression.matches(at(2026, 1, 25, 0, 0, 30)));  // Sunday
+
+    // Both day fields restricted: either matches (cron semantics)
+    TEST_ASSERT_TRUE(expression.compile("* 12 13 * FRI"));
+    TEST_ASSERT_TRUE(expression.matches(at(2026, 1, 13, 2, 12, 0)));   // The 13th, a Tuesday
+    TEST_ASSERT_TRUE(expression.matches(at(2026, 1, 23, 5, 12, 0)));   // A Friday
+    TEST_ASSERT_FALSE(expression.matches(at(2026, 1, 22, 4, 12, 0)));
+}
+
+void test_minutes_until_open_and_close() {
+    ScheduleExpression window = ScheduleExpression::hours(9, 18);
+    const long DAY = 1440;
+
+    TEST_ASSERT_EQUAL(90, window.minutesUntil(at(2026, 1, 22, 4, 7, 30), true, DAY));
+    TEST_ASSERT_EQUAL(0, window.minutesUntil(at(2026, 1, 22, 4, 7, 30), false, DAY));
+    TEST_ASSERT_EQUAL(0, window.minutesUntil(at(2026, 1, 22, 4, 10, 0), true, DAY));
+    TEST_ASSERT_EQUAL(480, window.minutesUntil(at(2026, 1, 22, 4, 10, 0), false, DAY));
+    TEST_ASSERT_EQUAL(14 * 60 + 30, window.minutesUntil(at(2026, 1, 22, 4, 18, 30), true, DAY));
+
+    // Beyond the limit
+    TEST_ASSERT_EQUAL(-1, window.minutesUntil(at(2026, 1, 22, 4, 7, 30), true, 89));
+    TEST_ASSERT_EQUAL(-1, ScheduleExpression().minutesUntil(at(2026, 1, 22, 4, 7, 30), true, 3 * DAY));
+    TEST_ASSERT_EQUAL(-1, ScheduleExpression::hours(0, 24).minutesUntil(at(2026, 1, 22, 4, 7, 30), false, DAY));
+
+    // Across weekdays, month and year ends, leap day
+    ScheduleExpression monday;
+    monday.compile("0 9 * * MON");
+    TEST_ASSERT_EQUAL(4 * DAY + 90, monday.minutesUntil(at(2026, 1, 22, 4, 7, 30), true, 7 * DAY));
+    ScheduleExpression newYear;
+    newYear.compile("0 0 1 1 *");
+    TEST_ASSERT_EQUAL(60, newYear.minutesUntil(at(2026, 12, 31, 4, 23, 0), true, DAY));
+    ScheduleExpression leapDay;
+    leapDay.compile("0 0 29 2 *");
+    TEST_ASSERT_EQUAL(DAY, leapDay.minutesUntil(at(2028, 2, 28, 1, 0, 0), true, 2 * DAY));
+    TEST_ASSERT_EQUAL(-1, leapDay.minutesUntil(at(2027, 2, 28, 0, 0, 0), true, 2 * DAY));
+}
+
+void test_hour_window_matches_previous_hour_check() {
+    // Every hour window against the [start, end) check it replaced
+    for (int start = 0; start < 24; start++) {
+        for (int end = start + 1; end <= 24; end++) {
+            ScheduleExpression window = ScheduleExpression::hours(start, end);
+            for (int hour = 0; hour < 24; hour++) {
+                bool expected = hour >= start && hour < end;
+                TEST_ASSERT_EQUAL(expected, window.matches(at(2026, 1, 22, 4, hour, 59)));
+            }
+        }
+    }
+}
+
+void test_scheduler_uses_expression_window() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MistingScheduler scheduler(&timeProvider, &relay);
+
+    // Overnight window with minute precision: 22:30-05:59
+    ScheduleExpression window;
+    TEST_ASSERT_TRUE(window.compile("30-59 22 * * *; * 23,0-5 * * *"));
+    TEST_ASSERT_TRUE(scheduler.setConfig(ScheduleConfig(25000, 7200, window)));
+
+    timeProvider.setTime(22, 29, 40);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getState());
+    TEST_ASSERT_EQUAL(timeProvider.getMillis() + 20000, scheduler.getNextEventMillis());
+
+    timeProvider.setTime(22, 30, 0);
+    scheduler.update();
+    TEST_ASSERT_EQUAL(MISTING, scheduler.getState());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_compile_and_canonical_format);
+    RUN_TEST(test_invalid_expressions_are_rejected);
+    RUN_TEST(test_matches_windows_weekdays_and_midnight_wrap);
+    RUN_TEST(test_minutes_until_open_and_close);
+    RUN_TEST(test_hour_window_matches_previous_hour_check);
+    RUN_TEST(test_scheduler_uses_expression_window);
+    return UNITY_END();
+}
@@ -0,0 +1,268 @@
+// test/test_serial_input/test_serial_input.cpp
+// Tests for serial command ingestion: RX ring, line assembly and latency stats
+
+#include <unity.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "RxRing.h"
+#include "LineAssembler.h"
+#include "LatencyStats.h"
+#include "CommandRegistry.h"
+#include "MistingScheduler.h"
+#include "RtcStateMirror.h"
+#include "AsyncStateStorage.h"
+#include "ThreadWorkerTask.h"
+#include "native/mocks/MockCommandOutput.h"
+#include "native/mocks/MockTimeProvider.h"
+#include "native/mocks/MockRelayController.h"
+#include "native/mocks/MockStateStorage.h"
+
+// Feed a string, collecting completed lines (and "<too long>" markers)
+static void feed(LineAssembler& assembler, const char* text, std::vector<std::string>& lines) {
+    for (const char* p = text; *p; p++) {
+        LineStatus status = assembler.push(*p);
+        if (status == LINE_READY) {
+            lines.push_back(assembler.getLine());
+        } else if (status == LINE_TOO_LONG) {
+            lines.push_back("<too long>");
+        }
+    }
+}
+
+void test_command_split_across_reads_is_dispatched_once() {
+    LineAssembler assembler;
+    std::vector<std::string> lines;
+
+    // Bytes arriving over three loop passes
+    feed(assembler, "STA", lines);
+    TEST_ASSERT_EQUAL(0, lines.size());
+    feed(assembler, "T", lines);
+    TEST_ASSERT_EQUAL(0, lines.size());
+    feed(assembler, "US\n", lines);
+
+    TEST_ASSERT_EQUAL(1, lines.size());
+    TEST_ASSERT_EQUAL_STRING("STATUS", lines[0].c_str());
+}
+
+void test_line_endings_and_batched_commands() {
+    LineAssembler assembler;
+    std::vector<std::string> lines;
+
+    // CRLF, bare CR, bare LF and blank lines, all in one read
+    feed(assembler, "ENABLE\r\nFORCE_MIST\r\n\nSTATUS\rHISTORY\n", lines);
+
+    TEST_ASSERT_EQUAL(4, lines.size());
+    TEST_ASSERT_EQUAL_STRING("ENABLE", lines[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("FORCE_MIST", lines[1].c_str());
+    TEST_ASSERT_EQUAL_STRING("STATUS", lines[2].c_str());
+    TEST_ASSERT_EQUAL_STRING("HISTORY", lines[3].c_str());
+}
+
+void test_overlong_line_is_rejected_then_input_recovers() {
+    LineAssembler assembler;
+    std::vector<std::string> lines;
+
+    std::string longLine(LineAssembler::MAX_LINE + 10, 'X');
+    feed(assembler, longLine.c_str(), lines);
+    TEST_ASSERT_EQUAL(0, lines.size());  // Reported only at the terminator
+    feed(assembler, "\nSTATUS\n", lines);
+
+    TEST_ASSERT_EQUAL(2, lines.size());
+    TEST_ASSERT_EQUAL_STRING("<too long>", lines[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("STATUS", lines[1].c_str());
+
+    // Longest accepted command
+    lines.clear();
+    std::string maxLine(LineAssembler::MAX_LINE - 1, 'Y');
+    feed(assembler, (maxLine + "\n").c_str(), lines);
+    TEST_ASSERT_EQUAL(1, lines.size());
+    TEST_ASSERT_EQUAL_STRING(maxLine.c_str(), lines[0].c_str());
+}
+
+void test_rx_ring_keeps_arrival_timestamps() {
+    RxRing ring;
+    ring.write((const uint8_t*)"STA", 3, 1000);
+    ring.write((const uint8_t*)"TUS\n", 4, 2500);
+
+    uint8_t byte;
+    uint32_t timestampUs = 0;
+    std::string received;
+    while (ring.read(&byte, &timestampUs)) {
+        received += (char)byte;
+        if (received.size() == 3) {
+            TEST_ASSERT_EQUAL(1000, timestampUs);
+        }
+    }
+    TEST_ASSERT_EQUAL_STRING("STATUS\n", received.c_str());
+    TEST_ASSERT_EQUAL(2500, timestampUs);  // Terminator: when the command completed
+    TEST_ASSERT_TRUE(ring.isEmpty());
+}
+
+void test_rx_ring_overflow_drops_and_counts() {
+    RxRing ring;
+    uint8_t data[RxRing::CAPACITY + 20];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)i;
+    }
+
+    TEST_ASSERT_EQUAL(RxRing::CAPACITY, ring.write(data, sizeof(data), 0));
+    TEST_ASSERT_EQUAL(20, ring.getOverflowCount());
+
+    // Oldest bytes are kept; space frees as the loop consumes
+    uint8_t byte;
+    uint32_t timestampUs;
+    TEST_ASSERT_TRUE(ring.read(&byte, &timestampUs));
+    TEST_ASSERT_EQUAL(0, byte);
+    TEST_ASSERT_EQUAL(1, ring.write(data, 1, 0));
+}
+
+void test_rx_ring_concurrent_producer_consumer() {
+    const size_t TOTAL = 100000;
+    RxRing ring;
+
+    std::thread producer([&ring]() {
+        size_t sent = 0;
+        uint8_t chunk[7];
+        while (sent < TOTAL) {
+            size_t count = (TOTAL - sent < sizeof(chunk)) ? TOTAL - sent : sizeof(chunk);
+            for (size_t i = 0; i < count; i++) {
+                chunk[i] = (uint8_t)(sent + i);
+            }
+            // Retry what did not fit, so every byte arrives exactly once
+            size_t written = 0;
+            while (written < count) {
+                written += ring.write(chunk + written, count - written, (uint32_t)(sent + written));
+            }
+            sent += count;
+        }
+    });
+
+    size_t received = 0;
+    bool inOrder = true;
+    while (received < TOTAL) {
+        uint8_t byte;
+        uint32_t timestampUs;
+        if (ring.read(&byte, &timestampUs)) {
+            if (byte != (uint8_t)received) {
+                inOrder = false;
+            }
+            received++;
+        }
+    }
+    producer.join();
+
+    TEST_ASSERT_TRUE(inOrder);
+    TEST_ASSERT_TRUE(ring.isEmpty());
+}
+
+void test_latency_stats() {
+    LatencyStats stats;
+    TEST_ASSERT_EQUAL(0, stats.getMeanUs());
+
+    stats.record(300);
+    stats.record(1200);
+    stats.record(600);
+
+    TEST_ASSERT_EQUAL(3, stats.count);
+    TEST_ASSERT_EQUAL(600, stats.lastUs);
+    TEST_ASSERT_EQUAL(1200, stats.maxUs);
+    TEST_ASSERT_EQUAL(700, stats.getMeanUs());
+}
+
+// Flash that takes as long as an NVS page erase for every write
+class SlowFlash : public MockStateStorage {
+public:
+    bool save(unsigned long lastMistTime, bool hasEverMisted, bool enabled) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return MockStateStorage::save(lastMistTime, hasEverMisted, enabled);
+    }
+
+    bool saveScheduleConfig(const void* record, size_t length) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return MockStateStorage::saveScheduleConfig(record, length);
+    }
+};
+
+static MistingScheduler* commandScheduler;
+
+static void cmdSetInterval(const CommandArgs& args, ICommandOutput* out, void* context) {
+    ScheduleConfig config = commandScheduler->getConfig();
+    config.intervalSeconds = (unsigned long)args.values[0];
+    out->println(commandScheduler->setConfig(config) ? "OK" : "ERROR");
+}
+
+static constexpr CommandSpec LATENCY_COMMANDS[] = {
+    { "SET_INTERVAL", "u", 60, 86400, "seconds", "", cmdSetInterval },
+};
+
+static uint32_t nowUs() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void test_command_during_inflight_save_is_not_delayed() {
+    // The firmware's storage stack: scheduler -> RTC mirror -> write-behind -> flash
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    SlowFlash flash;
+    ThreadWorkerTask worker;
+    AsyncStateStorage async(&flash, &worker);
+    RtcStateBlock block;
+    memset(&block, 0, sizeof(block));
+    RtcStateMirror mirror(&block, &async);
+    MistingScheduler scheduler(&timeProvider, &relay, &mirror);
+    async.begin();
+    scheduler.loadState();
+    commandScheduler = &scheduler;
+
+    CommandRegistry registry(LATENCY_COMMANDS, 1);
+    MockCommandOutput out;
+    RxRing ring;
+    LineAssembler assembler;
+    LatencyStats latency;
+
+    // DISABLE is being written to flash when the next command arrives
+    scheduler.setEnabled(false);
+    const char* input = "SET_INTERVAL 3600\n";
+    ring.write((const uint8_t*)input, strlen(input), nowUs());
+
+    // Same dispatch as processSerialCommands()
+    uint8_t c;
+    uint32_t receivedUs;
+    while (ring.read(&c, &receivedUs)) {
+        if (assembler.push((char)c) == LINE_READY) {
+            char line[LineAssembler::MAX_LINE];
+            strcpy(line, assembler.getLine());
+            registry.execute(line, &out);
+            latency.record(nowUs() - receivedUs);
+        }
+    }
+
+    TEST_ASSERT_EQUAL_STRING("OK", out.getLastLine());
+    TEST_ASSERT_EQUAL(1, latency.count);
+    TEST_ASSERT_TRUE(latency.maxUs < 10000);  // Each flash write takes 100 ms
+
+    TEST_ASSERT_TRUE(async.flush());
+    TEST_ASSERT_FALSE(flash.getEnabled());
+    TEST_ASSERT_EQUAL(1, flash.getScheduleConfigSaveCount());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_command_split_across_reads_is_dispatched_once);
+    RUN_TEST(test_line_endings_and_batched_commands);
+    RUN_TEST(test_overlong_line_is_rejected_then_input_recovers);
+    RUN_TEST(test_rx_ring_keeps_arrival_timestamps);
+    RUN_TEST(test_rx_ring_overflow_drops_and_counts);
+    RUN_TEST(test_rx_ring_concurrent_producer_consumer);
+    RUN_TEST(test_latency_stats);
+    RUN_TEST(test_command_during_inflight_save_is_not_delayed);
+    return UNITY_END();
+}
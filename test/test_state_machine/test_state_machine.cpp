@@ -3,6 +3,7 @@
 #include "MistingScheduler.h"
 #include "native/mocks/MockTimeProvider.h"
 #include "native/mocks/MockRelayController.h"
+#include "native/mocks/MockStateStorage.h"
 
 void test_initial_state_is_waiting_sync() {
     MockTimeProvider timeProvider;
@@ -84,6 +85,56 @@ void test_stays_idle_when_outside_window() {
 void setUp(void) {}
 void tearDown(void) {}
 
+void test_copy_drives_only_its_own_relay() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MistingScheduler scheduler(&timeProvider, &relay);
+    scheduler.setConfig(ScheduleConfig(20000, 3600, 8, 20));
+    timeProvider.setHour(20);  // Outside the window: nothing due
+    scheduler.update();
+
+    MockRelayController detached;
+    MistingScheduler copy(&timeProvider, &detached);
+    scheduler.copyStateTo(&copy);
+    TEST_ASSERT_EQUAL(IDLE, copy.getState());
+    TEST_ASSERT_EQUAL(3600, copy.getConfig().intervalSeconds);
+
+    // A mist falls due: the copy starts it on its own relay only
+    timeProvider.setHour(10);
+    copy.update();
+    TEST_ASSERT_EQUAL(MISTING, copy.getState());
+    TEST_ASSERT_EQUAL(20000, copy.getMistDurationMs());
+    TEST_ASSERT_EQUAL(1, detached.getTurnOnCount());
+    TEST_ASSERT_EQUAL(0, relay.getTurnOnCount());
+    TEST_ASSERT_EQUAL(IDLE, scheduler.getState());
+
+    // Re-copying restores the live state
+    scheduler.copyStateTo(&copy);
+    TEST_ASSERT_EQUAL(IDLE, copy.getState());
+}
+
+void test_copy_made_while_a_save_is_due_does_not_save() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage storage;
+    MistingScheduler scheduler(&timeProvider, &relay, &storage);
+    scheduler.setSaveCoalesceMs(2000);
+    scheduler.setEnabled(false);  // DISABLE: the save waits out the quiet period
+    timeProvider.advanceMillis(2500);
+
+    // BENCH runs before the live scheduler's update() commits the save
+    MockRelayController detached;
+    MistingScheduler copy(&timeProvider, &detached);
+    scheduler.copyStateTo(&copy);
+    copy.update();
+    copy.flushPendingSave();
+    TEST_ASSERT_EQUAL(0, storage.getSaveCallCount());
+
+    // The live scheduler still commits it
+    scheduler.update();
+    TEST_ASSERT_EQUAL(1, storage.getSaveCallCount());
+}
+
 int main(int argc, char **argv) {
     UNITY_BEGIN();
     RUN_TEST(test_initial_state_is_waiting_sync);
@@ -91,5 +142,7 @@ int main(int argc, char **argv) {
     RUN_TEST(test_transitions_to_misting_when_conditions_met);
     RUN_TEST(test_transitions_to_idle_after_25_seconds);
     RUN_TEST(test_stays_idle_when_outside_window);
+    RUN_TEST(test_copy_drives_only_its_own_relay);
+    RUN_TEST(test_copy_made_while_a_save_is_due_does_not_save);
     return UNITY_END();
 }
@@ -0,0 +1,101 @@
+// test/test_state_record/test_state_record.cpp
+// Tests for the packed, CRC-protected state record stored by NVSStateStorage
+
+#include <unity.h>
+#include "StateRecord.h"
+#include "MistingScheduler.h"
+#include "native/mocks/MockTimeProvider.h"
+#include "native/mocks/MockRelayController.h"
+#include "native/mocks/MockStateStorage.h"
+
+void test_crc32_matches_reference_vector() {
+    const char* check = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32(check, 9));
+
+    // Incremental use gives the same result
+    uint32_t crc = crc32(check, 4);
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32(check + 4, 5, crc));
+}
+
+void test_record_round_trip() {
+    StateRecord record;
+    record.encode(1706000000, true, false);
+
+    unsigned long lastMistTime = 0;
+    bool hasEverMisted = false;
+    bool enabled = true;
+    TEST_ASSERT_TRUE(record.decode(&lastMistTime, &hasEverMisted, &enabled));
+    TEST_ASSERT_EQUAL(1706000000, lastMistTime);
+    TEST_ASSERT_TRUE(hasEverMisted);
+    TEST_ASSERT_FALSE(enabled);
+    TEST_ASSERT_EQUAL(12, sizeof(StateRecord));
+}
+
+void test_any_single_bit_flip_is_detected() {
+    StateRecord record;
+    record.encode(1706000000, true, true);
+
+    for (size_t bit = 0; bit < sizeof(record) * 8; bit++) {
+        StateRecord corrupt = record;
+        ((uint8_t*)&corrupt)[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+        TEST_ASSERT_FALSE(corrupt.isValid());
+    }
+    TEST_ASSERT_TRUE(record.isValid());
+}
+
+void test_torn_write_is_rejected() {
+    StateRecord previous;
+    previous.encode(1706000000, true, true);
+    StateRecord next;
+    next.encode(1706007200, true, true);
+
+    // Power lost halfway through the commit: new head, old tail
+    StateRecord torn = previous;
+    memcpy((uint8_t*)&torn, (const uint8_t*)&next, sizeof(torn) / 2);
+
+    unsigned long lastMistTime = 42;
+    bool hasEverMisted = false;
+    bool enabled = false;
+    TEST_ASSERT_FALSE(torn.decode(&lastMistTime, &hasEverMisted, &enabled));
+    TEST_ASSERT_EQUAL(42, lastMistTime);  // Outputs untouched
+}
+
+void test_other_version_is_rejected() {
+    StateRecord record;
+    record.encode(1706000000, true, true);
+    record.version = StateRecord::VERSION + 1;
+    record.crc = record.computeCrc();
+
+    TEST_ASSERT_FALSE(record.isValid());
+}
+
+void test_load_state_uses_one_batch_load() {
+    MockTimeProvider timeProvider;
+    MockRelayController relay;
+    MockStateStorage storage;
+    storage.setLastMistTime(1706000000);
+    storage.setHasEverMisted(true);
+    storage.setEnabled(false);
+
+    MistingScheduler scheduler(&timeProvider, &relay, &storage);
+    scheduler.loadState();
+
+    TEST_ASSERT_EQUAL(1, storage.getLoadCallCount());
+    TEST_ASSERT_EQUAL(1706000000, scheduler.getLastMistEpoch());
+    TEST_ASSERT_FALSE(scheduler.isEnabled());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc32_matches_reference_vector);
+    RUN_TEST(test_record_round_trip);
+    RUN_TEST(test_any_single_bit_flip_is_detected);
+    RUN_TEST(test_torn_write_is_rejected);
+    RUN_TEST(test_other_version_is_rejected);
+    RUN_TEST(test_load_state_uses_one_batch_load);
+    return UNITY_END();
+}
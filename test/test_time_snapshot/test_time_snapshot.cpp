@@ -0,0 +1,118 @@
+// test/test_time_snapshot/test_time_snapshot.cpp
+// Tests for the per-tick TimeSnapshot and the cached local-time conversion
+
+#include <unity.h>
+#include <stdlib.h>
+#include "MistingScheduler.h"
+#include "LocalTimeCache.h"
+#include "native/mocks/MockTimeProvider.h"
+#include "native/mocks/MockRelayController.h"
+
+// Counts every clock read the scheduler makes
+class CountingTimeProvider : public MockTimeProvider {
+public:
+    CountingTimeProvider() : timeCalls(0), epochCalls(0), millisCalls(0), snapshotCalls(0) {}
+
+    bool getTime(struct tm* timeinfo) override { timeCalls++; return MockTimeProvider::getTime(timeinfo); }
+    time_t getEpochTime() override { epochCalls++; return MockTimeProvider::getEpochTime(); }
+    unsigned long getMillis() override { millisCalls++; return MockTimeProvider::getMillis(); }
+    bool getSnapshot(TimeSnapshot* snapshot) override {
+        snapshotCalls++;
+        return MockTimeProvider::getSnapshot(snapshot);
+    }
+
+    void resetCounts() { timeCalls = epochCalls = millisCalls = snapshotCalls = 0; }
+
+    int timeCalls;
+    int epochCalls;
+    int millisCalls;
+    int snapshotCalls;
+};
+
+static bool sameLocalTime(const struct tm& a, const struct tm& b) {
+    return a.tm_year == b.tm_year && a.tm_mon == b.tm_mon && a.tm_mday == b.tm_mday &&
+           a.tm_hour == b.tm_hour && a.tm_min == b.tm_min && a.tm_sec == b.tm_sec &&
+           a.tm_isdst == b.tm_isdst && a.tm_wday == b.tm_wday && a.tm_yday == b.tm_yday;
+}
+
+void test_update_reads_clocks_once_per_tick() {
+    CountingTimeProvider timeProvider;
+    MockRelayController relay;
+    MistingScheduler scheduler(&timeProvider, &relay);
+
+    timeProvider.setHour(8);  // Outside window, stays IDLE
+    scheduler.update();
+    timeProvider.resetCounts();
+
+    scheduler.update();
+
+    TEST_ASSERT_EQUAL(1, timeProvider.snapshotCalls);
+    TEST_ASSERT_EQUAL(1, timeProvider.timeCalls);
+    TEST_ASSERT_EQUAL(1, timeProvider.epochCalls);
+    TEST_ASSERT_EQUAL(1, timeProvider.millisCalls);
+}
+
+void test_snapshot_fields_are_consistent() {
+    MockTimeProvider timeProvider;
+    timeProvider.setMillis(1234);
+    timeProvider.setEpochTime(1706000000);
+    timeProvider.setHour(11);
+
+    TimeSnapshot snapshot;
+    TEST_ASSERT_TRUE(timeProvider.getSnapshot(&snapshot));
+    TEST_ASSERT_EQUAL(1234, snapshot.millis);
+    TEST_ASSERT_EQUAL(1706000000, snapshot.epoch);
+    TEST_ASSERT_EQUAL(11, snapshot.local.tm_hour);
+
+    timeProvider.setTimeAvailable(false);
+    TEST_ASSERT_FALSE(timeProvider.getSnapshot(&snapshot));
+    TEST_ASSERT_FALSE(snapshot.localValid);
+}
+
+void test_local_time_cache_matches_libc_across_dst() {
+    setenv("TZ", "PST8PDT,M3.2.0,M11.1.0", 1);
+    tzset();
+    LocalTimeCache cache;
+
+    // 2026-03-07 00:00 UTC through 2026-03-10, spanning spring-forward on 03-08
+    for (time_t epoch = 1772841600; epoch < 1772841600 + 3 * 86400; epoch += 7) {
+        struct tm expected;
+        struct tm actual;
+        localtime_r(&epoch, &expected);
+        cache.toLocal(epoch, &actual);
+        TEST_ASSERT_TRUE(sameLocalTime(expected, actual));
+    }
+}
+
+void test_local_time_cache_converts_once_per_minute() {
+    setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+    tzset();
+    LocalTimeCache cache;
+    struct tm local;
+
+    // One hour of once-per-second ticks, starting on a minute boundary
+    for (time_t epoch = 1706000040; epoch < 1706000040 + 3600; epoch++) {
+        cache.toLocal(epoch, &local);
+    }
+    TEST_ASSERT_EQUAL(60, cache.getConversionCount());
+
+    // A clock jump forces a fresh conversion
+    cache.toLocal(1706000040 + 86400, &local);
+    TEST_ASSERT_EQUAL(61, cache.getConversionCount());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {
+    unsetenv("TZ");
+    tzset();
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_update_reads_clocks_once_per_tick);
+    RUN_TEST(test_snapshot_fields_are_consistent);
+    RUN_TEST(test_local_time_cache_matches_libc_across_dst);
+    RUN_TEST(test_local_time_cache_converts_once_per_minute);
+    return UNITY_END();
+}
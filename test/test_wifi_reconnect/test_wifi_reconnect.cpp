@@ -0,0 +1,249 @@
+// test/test_wifi_reconnect/test_wifi_reconnect.cpp
+// Tests for the non-blocking WiFi reconnect state machine
+
+#include <unity.h>
+#include "WiFiConnectionManager.h"
+#include "native/mocks/MockNetworkDriver.h"
+#include "native/mocks/MockStateStorage.h"
+
+static NetworkCache makeCache(uint8_t channel) {
+    NetworkCache cache;
+    const uint8_t bssid[6] = {0x10, 0x20, 0x30, 0x40, 0x50, 0x60};
+    memcpy(cache.bssid, bssid, sizeof(bssid));
+    cache.channel = channel;
+    cache.ip = 0x6401A8C0;       // 192.168.1.100
+    cache.gateway = 0x0101A8C0;  // 192.168.1.1
+    cache.subnet = 0x00FFFFFF;   // 255.255.255.0
+    cache.dns = 0x0101A8C0;
+    cache.valid = 1;
+    return cache;
+}
+
+void test_stays_connected_while_link_up() {
+    MockNetworkDriver driver;
+    WiFiConnectionManager manager(&driver);
+
+    manager.step(0);
+    manager.step(100);
+
+    TEST_ASSERT_EQUAL(WIFI_CONNECTED, manager.getState());
+    TEST_ASSERT_EQUAL(0, driver.getBeginCount());
+}
+
+void test_start_begins_initial_connection() {
+    MockNetworkDriver driver;
+    WiFiConnectionManager manager(&driver);
+
+    driver.setConnected(false);
+    manager.start(0);
+    TEST_ASSERT_EQUAL(WIFI_BEGIN, manager.getState());
+
+    manager.step(0);
+    TEST_ASSERT_EQUAL(1, driver.getBeginCount());
+    TEST_ASSERT_EQUAL(WIFI_WAITING, manager.getState());
+}
+
+void test_disconnect_starts_one_attempt_per_step() {
+    MockNetworkDriver driver;
+    WiFiConnectionManager manager(&driver);
+
+    driver.setConnected(false);
+    manager.step(1000);
+    TEST_ASSERT_EQUAL(WIFI_BEGIN, manager.getState());
+    TEST_ASSERT_EQUAL(0, driver.getBeginCount());
+
+    manager.step(1100);
+    TEST_ASSERT_EQUAL(WIFI_WAITING, manager.getState());
+    TEST_ASSERT_EQUAL(1, driver.getBeginCount());
+
+    // Still waiting - no new attempt, no blocking
+    manager.step(5000);
+    TEST_ASSERT_EQUAL(WIFI_WAITING, manager.getState());
+    TEST_ASSERT_EQUAL(1, driver.getBeginCount());
+}
+
+void test_reconnect_triggers_ntp_resync() {
+    MockNetworkDriver driver;
+    WiFiConnectionManager manager(&driver);
+
+    driver.setConnected(false);
+    manager.step(0);     // -> BEGIN
+    manager.step(10);    // -> WAITING
+    driver.setConnected(true);
+    manager.step(2000);  // -> NTP_RESYNC
+    TEST_ASSERT_EQUAL(WIFI_NTP_RESYNC, manager.getState());
+
+    manager.step(2010);  // -> CONNECTED
+    TEST_ASSERT_EQUAL(WIFI_CONNECTED, manager.getState());
+    TEST_ASSERT_EQUAL(1, driver.getTimeSyncCount());
+}
+
+void test_failed_attempts_back_off_exponentially() {
+    MockNetworkDriver driver;
+    WiFiConnectionManager manager(&driver);
+    unsigned long now = 0;
+
+    driver.setConnected(false);
+    manager.step(now);   // -> BEGIN
+    manager.step(now);   // -> WAITING
+
+    // First attempt times out
+    now += WiFiConnectionManager::CONNECT_TIMEOUT_MS;
+    manager.step(now);
+    TEST_ASSERT_EQUAL(WIFI_BACKOFF, manager.getState());
+    TEST_ASSERT_EQUAL(WiFiConnectionManager::INITIAL_BACKOFF_MS, manager.getBackoffMs());
+    TEST_ASSERT_EQUAL(now + WiFiConnectionManager::INITIAL_BACKOFF_MS, manager.getNextStepMillis(now));
+
+    // Not yet time to retry
+    manager.step(now + WiFiConnectionManager::INITIAL_BACKOFF_MS - 1);
+    TEST_ASSERT_EQUAL(WIFI_BACKOFF, manager.getState());
+
+    // Retry, fail again - backoff doubles
+    now += WiFiConnectionManager::INITIAL_BACKOFF_MS;
+    manager.step(now);   // -> BEGIN
+    manager.step(now);   // -> WAITING
+    TEST_ASSERT_EQUAL(2, driver.getBeginCount());
+    now += WiFiConnectionManager::CONNECT_TIMEOUT_MS;
+    manager.step(now);
+    TEST_ASSERT_EQUAL(WIFI_BACKOFF, manager.getState());
+    TEST_ASSERT_EQUAL(WiFiConnectionManager::INITIAL_BACKOFF_MS * 2, manager.getBackoffMs());
+    TEST_ASSERT_EQUAL(2, manager.getFailedAttempts());
+}
+
+void test_backoff_capped_and_reset_after_reconnect() {
+    MockNetworkDriver driver;
+    WiFiConnectionManager manager(&driver);
+    unsigned long now = 0;
+
+    // AP down for hours
+    driver.setConnected(false);
+    while (now < 6UL * 3600UL * 1000UL) {
+        manager.step(now);
+        now += 1000;
+    }
+    TEST_ASSERT_EQUAL(WiFiConnectionManager::MAX_BACKOFF_MS, manager.getBackoffMs());
+
+    // AP returns
+    driver.setConnected(true);
+    manager.step(now);
+    manager.step(now);
+    TEST_ASSERT_EQUAL(WIFI_CONNECTED, manager.getState());
+    TEST_ASSERT_EQUAL(WiFiConnectionManager::INITIAL_BACKOFF_MS, manager.getBackoffMs());
+    TEST_ASSERT_EQUAL(0, manager.getFailedAttempts());
+}
+
+void test_no_cache_uses_full_scan() {
+    MockNetworkDriver driver;
+    MockStateStorage storage;
+    WiFiConnectionManager manager(&driver, &storage);
+
+    driver.setConnected(false);
+    manager.start(0);
+    manager.step(0);
+
+    TEST_ASSERT_EQUAL(1, driver.getBeginCount());
+    TEST_ASSERT_EQUAL(0, driver.getFastBeginCount());
+}
+
+void test_cached_bssid_used_for_fast_connect() {
+    MockNetworkDriver driver;
+    MockStateStorage storage;
+    storage.setNetworkCache(makeCache(6));
+    WiFiConnectionManager manager(&driver, &storage);
+
+    driver.setConnected(false);
+    manager.start(0);
+    manager.step(0);
+
+    TEST_ASSERT_EQUAL(0, driver.getBeginCount());
+    TEST_ASSERT_EQUAL(1, driver.getFastBeginCount());
+    TEST_ASSERT_EQUAL(6, driver.getLastFastCache().channel);
+    TEST_ASSERT_EQUAL(0x60, driver.getLastFastCache().bssid[5]);
+    // Lease not reused unless enabled
+    TEST_ASSERT_FALSE(driver.getLastFastCache().hasIpLease());
+
+    driver.setConnected(true);
+    driver.setConnectionInfo(makeCache(6));
+    manager.step(450);
+    TEST_ASSERT_TRUE(manager.lastConnectUsedCache());
+    TEST_ASSERT_EQUAL(450, manager.getLastConnectMs());
+}
+
+void test_fast_connect_failure_falls_back_to_full_scan() {
+    MockNetworkDriver driver;
+    MockStateStorage storage;
+    storage.setNetworkCache(makeCache(6));
+    WiFiConnectionManager manager(&driver, &storage);
+
+    driver.setConnected(false);
+    manager.start(0);
+    manager.step(0);  // Fast attempt
+    manager.step(WiFiConnectionManager::FAST_CONNECT_TIMEOUT_MS);
+
+    // Immediate fallback, no backoff and not counted as a failure
+    TEST_ASSERT_EQUAL(WIFI_BEGIN, manager.getState());
+    TEST_ASSERT_EQUAL(0, manager.getFailedAttempts());
+    manager.step(WiFiConnectionManager::FAST_CONNECT_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(1, driver.getBeginCount());
+
+    // AP moved to channel 11; full scan finds it and refreshes the cache
+    driver.setConnected(true);
+    driver.setConnectionInfo(makeCache(11));
+    manager.step(5000);
+    TEST_ASSERT_FALSE(manager.lastConnectUsedCache());
+    TEST_ASSERT_EQUAL(5000, manager.getLastConnectMs());
+    TEST_ASSERT_EQUAL(11, storage.getNetworkCache().channel);
+    TEST_ASSERT_EQUAL(1, storage.getNetworkCacheSaveCount());
+}
+
+void test_unchanged_cache_is_not_rewritten() {
+    MockNetworkDriver driver;
+    MockStateStorage storage;
+    NetworkCache cached = makeCache(6);
+    cached.ip = cached.gateway = cached.subnet = cached.dns = 0;  // As saved without lease reuse
+    storage.setNetworkCache(cached);
+    WiFiConnectionManager manager(&driver, &storage);
+
+    driver.setConnected(false);
+    manager.start(0);
+    manager.step(0);
+    driver.setConnected(true);
+    driver.setConnectionInfo(makeCache(6));
+    manager.step(300);
+
+    TEST_ASSERT_EQUAL(0, storage.getNetworkCacheSaveCount());
+}
+
+void test_reuse_ip_lease_passes_static_config() {
+    MockNetworkDriver driver;
+    MockStateStorage storage;
+    storage.setNetworkCache(makeCache(6));
+    WiFiConnectionManager manager(&driver, &storage);
+    manager.setReuseIpLease(true);
+
+    driver.setConnected(false);
+    manager.start(0);
+    manager.step(0);
+
+    TEST_ASSERT_TRUE(driver.getLastFastCache().hasIpLease());
+    TEST_ASSERT_EQUAL(0x6401A8C0, driver.getLastFastCache().ip);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_stays_connected_while_link_up);
+    RUN_TEST(test_start_begins_initial_connection);
+    RUN_TEST(test_disconnect_starts_one_attempt_per_step);
+    RUN_TEST(test_reconnect_triggers_ntp_resync);
+    RUN_TEST(test_failed_attempts_back_off_exponentially);
+    RUN_TEST(test_backoff_capped_and_reset_after_reconnect);
+    RUN_TEST(test_no_cache_uses_full_scan);
+    RUN_TEST(test_cached_bssid_used_for_fast_connect);
+    RUN_TEST(test_fast_connect_failure_falls_back_to_full_scan);
+    RUN_TEST(test_unchanged_cache_is_not_rewritten);
+    RUN_TEST(test_reuse_ip_lease_passes_static_config);
+    return UNITY_END();
+}
@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+"""Compare two host benchmark runs (bench program --json FILE).
+
+Prints the median time per operation of both runs and the change, and
+exits non-zero if any benchmark got slower than the threshold.
+
+Usage:
+    .pio/build/bench/program --json before.json
+    ...change something...
+    .pio/build/bench/program --json after.json
+    tools/compare_bench.py before.json after.json --threshold 10
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return {b["name"]: b for b in data["benchmarks"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two bench JSON files")
+    parser.add_argument("baseline", help="JSON from the reference run")
+    parser.add_argument("candidate", help="JSON from the run to check")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="percent slowdown of the median that counts as a regression (default 10)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    candidate = load(args.candidate)
+
+    regressions = 0
+    print("%-40s %12s %12s %9s" % ("benchmark", "before ns", "after ns", "change"))
+    for name in sorted(set(baseline) | set(candidate)):
+        if name not in baseline or name not in candidate:
+            print("%-40s %s" % (name, "only in " + (args.baseline if name in baseline else args.candidate)))
+            continue
+        before = baseline[name]["median"]
+        after = candidate[name]["median"]
+        change = (after - before) / before * 100 if before > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print("%-40s %12.2f %12.2f %+8.1f%%%s" % (name, before, after, change, flag))
+
+    if regressions:
+        print("%d benchmark(s) slower by more than %.0f%%" % (regressions, args.threshold))
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
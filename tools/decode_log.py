@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+"""Decode the firmware's binary log stream (BINARY_LOG builds) into text.
+
+Message formats and argument types are read from src/LogCatalog.h, so the
+decoder always matches the firmware built from the same tree. Plain text
+between records (command replies) is passed through unchanged.
+
+Usage:
+    tools/decode_log.py capture.bin
+    tools/decode_log.py --port /dev/ttyUSB0 --tz "CET-1CEST,M3.5.0,M10.5.0/3"
+    pio device monitor --raw | tools/decode_log.py -
+"""
+
+import argparse
+import os
+import re
+import sys
+import time
+import zlib
+
+SYNC = 0xA5
+LOG_MSG_TEXT = 0
+LOG_MSG_TIME_BASE = 1
+MIN_VALID_EPOCH = 1483228800  # Same as LogEntry::MIN_VALID_EPOCH
+
+CATALOG = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src", "LogCatalog.h")
+
+
+def load_catalog(path):
+    """Return ([(name, types, format)], [string]) from the X-macro lists."""
+    with open(path) as f:
+        source = f.read()
+
+    def entries(macro):
+        block = re.search(r"#define %s\(X\)(.*?)\n\n" % macro, source, re.S)
+        if not block:
+            sys.exit("decode_log: %s not found in %s" % (macro, path))
+        return re.findall(r'X\((\w+),\s*((?:"(?:[^"\\]|\\.)*"\s*,?\s*)+)\)', block.group(1))
+
+    def literals(text):
+        return [bytes(s, "utf-8").decode("unicode_escape") for s in re.findall(r'"((?:[^"\\]|\\.)*)"', text)]
+
+    messages = []
+    for name, body in entries("LOG_MESSAGES"):
+        types, fmt = literals(body)
+        messages.append((name, types, fmt))
+    strings = [literals(body)[0] for _, body in entries("LOG_STRINGS")]
+    return messages, strings
+
+
+class Decoder:
+    def __init__(self, messages, strings, out):
+        self.messages = messages
+        self.strings = strings
+        self.out = out
+        self.millis = 0
+        self.base_epoch = None
+        self.base_millis = 0
+        self.records = 0
+        self.errors = 0
+
+    def feed(self, data):
+        """Decode a complete buffer; returns the undecoded tail (partial record)."""
+        pos = 0
+        while pos < len(data):
+            sync = data.find(bytes([SYNC]), pos)
+            if sync < 0:
+                self.out.write(data[pos:].decode("ascii", "replace"))
+                return b""
+            self.out.write(data[pos:sync].decode("ascii", "replace"))
+            try:
+                end = self.record(data, sync)
+            except IndexError:
+                return data[sync:]  # Wait for more bytes
+            except ValueError:
+                end = None
+            if end is None:
+                self.errors += 1
+                pos = sync + 1  # Not a record: resynchronise on the next SYNC
+            else:
+                pos = end
+        return b""
+
+    def record(self, data, start):
+        pos = start + 1
+        msg_id = data[pos]
+        pos += 1
+        if msg_id >= len(self.messages):
+            return None
+        delta, pos = varint(data, pos)
+        _, types, fmt = self.messages[msg_id]
+
+        args = []
+        for kind in types:
+            if kind == "i":
+                value, pos = varint(data, pos)
+                args.append((value >> 1) ^ -(value & 1))
+            elif kind == "u":
+                value, pos = varint(data, pos)
+                args.append(value)
+            elif kind == "s":
+                index = data[pos]
+                pos += 1
+                args.append(self.strings[index] if index < len(self.strings) else "?")
+            elif kind == "t":
+                length, pos = varint(data, pos)
+                if pos + length > len(data):
+                    raise IndexError
+                args.append(data[pos:pos + length].decode("utf-8", "replace"))
+                pos += length
+
+        check = data[pos]
+        if check != zlib.crc32(data[start + 1:pos]) & 0xFF:
+            return None
+        pos += 1
+
+        self.records += 1
+        self.millis = (self.millis + delta) & 0xFFFFFFFF
+        if msg_id == LOG_MSG_TIME_BASE:
+            self.base_epoch = args[0]
+            self.base_millis = self.millis
+            return pos
+
+        self.out.write("%s | %s\n" % (self.stamp(), printf(fmt, args)))
+        return pos
+
+    def stamp(self):
+        if self.base_epoch is None or self.base_epoch < MIN_VALID_EPOCH:
+            return "----/--/-- --:--:--"
+        epoch = self.base_epoch + ((self.millis - self.base_millis) & 0xFFFFFFFF) // 1000
+        return time.strftime("%Y-%m-%d %H:%M:%S", time.localtime(epoch))
+
+
+def varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if byte < 0x80:
+            return value, pos
+        shift += 7
+        if shift > 28:
+            raise ValueError("varint too long")
+
+
+def printf(fmt, args):
+    # Python's % has no length modifiers
+    return re.sub(r"%(-?\d*)l([du])", r"%\1\2", fmt) % tuple(args)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode BINARY_LOG serial output")
+    parser.add_argument("input", nargs="?", default="-", help="capture file, or - for stdin")
+    parser.add_argument("--port", help="read from a serial port instead (needs pyserial)")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--tz", help="POSIX TZ of the device (TIMEZONE_STRING), default host local time")
+    parser.add_argument("--catalog", default=CATALOG, help="path to LogCatalog.h")
+    options = parser.parse_args()
+
+    if options.tz:
+        os.environ["TZ"] = options.tz
+        time.tzset()
+
+    messages, strings = load_catalog(options.catalog)
+    decoder = Decoder(messages, strings, sys.stdout)
+
+    if options.port:
+        import serial
+        stream = serial.Serial(options.port, options.baud, timeout=0.1)
+        read = lambda: stream.read(4096)
+    elif options.input == "-":
+        read = lambda: sys.stdin.buffer.read1(4096)
+    else:
+        stream = open(options.input, "rb")
+        read = lambda: stream.read(4096)
+
+    pending = b""
+    try:
+        while True:
+            chunk = read()
+            if not chunk and not options.port:
+                break
+            pending = decoder.feed(pending + chunk)
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+    if pending:
+        decoder.errors += 1
+    sys.stderr.write("decode_log: %d records, %d errors\n" % (decoder.records, decoder.errors))
+
+
+if __name__ == "__main__":
+    main()